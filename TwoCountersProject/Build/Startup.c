@@ -0,0 +1,118 @@
+/**
+ * @file Startup.c
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief This is the start up code of the boot loader and the application, the vector
+ * table and the reset handler that sets up the RAM and calls main
+ * *Every interrupt the drivers do not handle goes to Default_Handler
+ * @version 0.1
+ * @date 2020-04-20
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include "Std_Types.h"
+#include "NVIC.h"
+
+/* The core exceptions come before the interrupts of the part */
+#define STARTUP_EXCEPTIONS          16
+#define STARTUP_IRQS                60
+#define STARTUP_VECTORS             (STARTUP_EXCEPTIONS + STARTUP_IRQS)
+
+#define STARTUP_NMI                 2
+#define STARTUP_HARD_FAULT          3
+#define STARTUP_MEM_MANAGE          4
+#define STARTUP_BUS_FAULT           5
+#define STARTUP_USAGE_FAULT         6
+#define STARTUP_SVC                 11
+#define STARTUP_DEBUG_MON           12
+#define STARTUP_PEND_SV             14
+#define STARTUP_SYSTICK             15
+
+#define STARTUP_IRQ(num)            (STARTUP_EXCEPTIONS + (num))
+
+typedef void (*startupHandler_t)(void);
+
+/* Given by the linker script */
+extern uint32_t _estack;
+extern uint32_t _sidata;
+extern uint32_t _sdata;
+extern uint32_t _edata;
+extern uint32_t _sbss;
+extern uint32_t _ebss;
+
+extern void main(void);
+
+void Reset_Handler(void);
+void Default_Handler(void);
+
+void NMI_Handler(void) __attribute__((weak, alias("Default_Handler")));
+void HardFault_Handler(void) __attribute__((weak, alias("Default_Handler")));
+void MemManage_Handler(void) __attribute__((weak, alias("Default_Handler")));
+void BusFault_Handler(void) __attribute__((weak, alias("Default_Handler")));
+void UsageFault_Handler(void) __attribute__((weak, alias("Default_Handler")));
+void SVC_Handler(void) __attribute__((weak, alias("Default_Handler")));
+void DebugMon_Handler(void) __attribute__((weak, alias("Default_Handler")));
+void PendSV_Handler(void) __attribute__((weak, alias("Default_Handler")));
+void SysTick_Handler(void) __attribute__((weak, alias("Default_Handler")));
+void SPI1_IRQHandler(void) __attribute__((weak, alias("Default_Handler")));
+void SPI2_IRQHandler(void) __attribute__((weak, alias("Default_Handler")));
+void USART1_IRQHandler(void) __attribute__((weak, alias("Default_Handler")));
+void USART2_IRQHandler(void) __attribute__((weak, alias("Default_Handler")));
+void USART3_IRQHandler(void) __attribute__((weak, alias("Default_Handler")));
+void UART4_IRQHandler(void) __attribute__((weak, alias("Default_Handler")));
+void UART5_IRQHandler(void) __attribute__((weak, alias("Default_Handler")));
+
+/* The first word is the stack the core starts with and the second one the reset handler,
+ * the reserved entries are left 0 */
+__attribute__((section(".isr_vector"), used))
+const startupHandler_t Startup_vectors[STARTUP_VECTORS] = {
+    [0] = (startupHandler_t)&_estack,
+    [1] = Reset_Handler,
+    [STARTUP_NMI] = NMI_Handler,
+    [STARTUP_HARD_FAULT] = HardFault_Handler,
+    [STARTUP_MEM_MANAGE] = MemManage_Handler,
+    [STARTUP_BUS_FAULT] = BusFault_Handler,
+    [STARTUP_USAGE_FAULT] = UsageFault_Handler,
+    [STARTUP_SVC] = SVC_Handler,
+    [STARTUP_DEBUG_MON] = DebugMon_Handler,
+    [STARTUP_PEND_SV] = PendSV_Handler,
+    [STARTUP_SYSTICK] = SysTick_Handler,
+    [STARTUP_IRQ(0) ... STARTUP_VECTORS - 1] = Default_Handler,
+    [STARTUP_IRQ(NVIC_IRQNUM_SPI1)] = SPI1_IRQHandler,
+    [STARTUP_IRQ(NVIC_IRQNUM_SPI2)] = SPI2_IRQHandler,
+    [STARTUP_IRQ(NVIC_IRQNUM_USART1)] = USART1_IRQHandler,
+    [STARTUP_IRQ(NVIC_IRQNUM_USART2)] = USART2_IRQHandler,
+    [STARTUP_IRQ(NVIC_IRQNUM_USART3)] = USART3_IRQHandler,
+    [STARTUP_IRQ(NVIC_IRQNUM_UART4)] = UART4_IRQHandler,
+    [STARTUP_IRQ(NVIC_IRQNUM_UART5)] = UART5_IRQHandler
+};
+
+/**
+ * @brief Copies the initialized data to the RAM, clears the rest and calls main
+ *
+ */
+void Reset_Handler(void)
+{
+    uint32_t* source = &_sidata;
+    uint32_t* destination = &_sdata;
+    while(destination < &_edata)
+    {
+        *destination++ = *source++;
+    }
+    for(destination = &_sbss; destination < &_ebss; destination++)
+    {
+        *destination = 0;
+    }
+    main();
+    while(1);
+}
+
+/**
+ * @brief Catches the faults and the interrupts nothing handles, a debugger finds the
+ * part stopped here
+ *
+ */
+void Default_Handler(void)
+{
+    while(1);
+}
@@ -19,7 +19,7 @@
  */
 extern Std_ReturnType APP_init(void);
 /**
- * @brief The free running task that comes every 1 milli second
+ * @brief The free running task that comes every APP_TASK_PERIOD_MS milli seconds
  * 
  */
 extern void APP_sendTask(void);
@@ -28,5 +28,13 @@ extern void APP_sendTask(void);
  *
  */
 extern void APP_receiveFcn(void);
+/**
+ * @brief Gets the latency of the last press received from the other board, from
+ * the press to its arrival here, measured on the synchronized clocks
+ *  @returns: A status
+ *                 E_OK : if the function is executed correctly
+ *                 E_NOT_OK : if no press came yet or the clocks are not synchronized
+ */
+extern Std_ReturnType APP_getPressLatency(u32* latencyUs, u32* errorUs);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,27 @@
+/**
+ * @file App_Cfg.h
+ * @author Mariam Mohammed
+ * @brief These are the user's configurations for the two counters application
+ * @version 0.1
+ * @date 2020-03-29
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#ifndef APP_CFG_H_
+#define APP_CFG_H_
+
+/* The period of APP_sendTask in milli seconds */
+#define APP_TASK_PERIOD_MS    4
+
+/* The time between two anti-entropy messages in milli seconds */
+#define APP_SYNC_PERIOD_MS    1000
+
+/* STD_ON to gather the presses into one update while the link is busy */
+#define APP_BATCHING          STD_ON
+/* The limits of the batch window in milli seconds, the window is timed on the SysTick
+ * so it does not depend on APP_TASK_PERIOD_MS */
+#define APP_BATCH_MIN_MS      4
+#define APP_BATCH_MAX_MS      256
+
+#endif
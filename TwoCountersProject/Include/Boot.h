@@ -0,0 +1,25 @@
+/**
+ * @file Boot.h
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief This is the user interface for the boot loader, it sits at the start of the
+ * flash, installs a downloaded image that was checked by the firmware update and
+ * starts the application
+ * @version 0.1
+ * @date 2020-04-20
+ * 
+ * @copyright Copyright (c) 2020
+ * 
+ */
+#ifndef BOOT_H
+#define BOOT_H
+
+/**
+ * @brief Installs the downloaded image if there is a checked one and jumps to the
+ * application, it is the only thing the main of the boot loader calls
+ * 
+ * @return Std_ReturnType A Status
+ *                  E_NOT_OK: If there is no valid application to jump to
+ */
+extern Std_ReturnType Boot_Run(void);
+
+#endif
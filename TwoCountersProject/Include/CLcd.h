@@ -36,6 +36,14 @@ typedef struct
     uint32_t dPort[CLCD_NUMBER_OF_DATA_PINS];
 } clcd_t;
 
+typedef struct
+{
+    /* An operation is running, new requests are turned away until it ends */
+    uint8_t busy;
+    uint32_t accepted;
+    uint32_t rejected;
+} clcdStatus_t;
+
 /**
  * @brief The Character LCD initialization
  * 
@@ -114,6 +122,23 @@ extern Std_ReturnType CLcd_ConfigDisplay(uint8_t disp);
  * @return Std_ReturnType 
  */
 extern Std_ReturnType CLcd_SetDoneNotification(lcdCb_t cb);
+/**
+ * @brief Gets the status of the LCD
+ * 
+ * @param status where to copy the status
+ * @return Std_ReturnType 
+ * 				E_OK : If executed successfully
+ * 				E_NOT_OK : If it failed to execute
+ */
+extern Std_ReturnType CLcd_GetStatus(clcdStatus_t* status);
+/**
+ * @brief Clears the request counters of the LCD
+ * 
+ * @return Std_ReturnType 
+ * 				E_OK : If executed successfully
+ * 				E_NOT_OK : If it failed to execute
+ */
+extern Std_ReturnType CLcd_ResetStatus(void);
 /**
  * @brief The running task that have to come every 1 milli second
  * 
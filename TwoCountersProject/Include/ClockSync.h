@@ -0,0 +1,66 @@
+/**
+ * @file ClockSync.h
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief This is the user interface for the clock synchronization, it estimates the
+ * offset and the drift of the peer clock from the heartbeat exchanges (NTP style)
+ * so a time from the peer can be turned into local time with a known error
+ * @version 0.1
+ * @date 2020-04-18
+ * 
+ * @copyright Copyright (c) 2020
+ * 
+ */
+#ifndef CLOCKSYNC_H
+#define CLOCKSYNC_H
+
+typedef struct
+{
+    uint8_t synced;
+    uint8_t driftValid;
+    /* The peer time minus the local time at the reference */
+    sint32_t offsetUs;
+    /* The round trip delay of the reference sample */
+    uint32_t delayUs;
+    /* How much faster the peer clock runs, in parts per billion */
+    sint32_t driftPpb;
+    uint32_t samples;
+}clockSyncState_t;
+
+/**
+ * @brief Initializes the clock synchronization, the heartbeat has to be initialized first
+ * 
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+extern Std_ReturnType ClockSync_Init(void);
+/**
+ * @brief Adds an exchange with the peer, the peer has to answer right away
+ * 
+ * @param sentAt the local time the request was sent
+ * @param peerTime the peer time it was answered at
+ * @param receivedAt the local time the answer came
+ */
+extern void ClockSync_AddSample(uint32_t sentAt, uint32_t peerTime, uint32_t receivedAt);
+/**
+ * @brief Turns a peer time into local time
+ * 
+ * @param peerTime the peer time in micro seconds
+ * @param localTime where to put the local time
+ * @param errorUs where to put the largest error of the result, can be NULL
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If there is no sample yet
+ */
+extern Std_ReturnType ClockSync_PeerToLocal(uint32_t peerTime, uint32_t* localTime, uint32_t* errorUs);
+/**
+ * @brief Gets the state of the estimator
+ * 
+ * @param state where to copy the state
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+extern Std_ReturnType ClockSync_GetState(clockSyncState_t* state);
+
+#endif
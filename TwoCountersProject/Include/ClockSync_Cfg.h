@@ -0,0 +1,24 @@
+/**
+ * @file ClockSync_Cfg.h
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief These are the user's configurations for the clock synchronization
+ * @version 0.1
+ * @date 2020-04-18
+ * 
+ * @copyright Copyright (c) 2020
+ * 
+ */
+#ifndef CLOCKSYNC_CFG_H
+#define CLOCKSYNC_CFG_H
+
+/* The number of recent samples the one with the smallest delay is taken from */
+#define CLOCKSYNC_FILTER_SIZE        8
+
+/* The drift is measured between references at least this far apart */
+#define CLOCKSYNC_MIN_DRIFT_SPAN_US  60000000
+
+/* The drift assumed for the error before it is measured and the error left after */
+#define CLOCKSYNC_MAX_DRIFT_PPM      100
+#define CLOCKSYNC_DRIFT_ERROR_PPM    10
+
+#endif
@@ -0,0 +1,138 @@
+/**
+ * @file CounterCodec.h
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief This is the user interface for the counter codec, a counter update is sent as
+ * a zig-zag varint delta from the value the receiver has with a full snapshot from time
+ * to time, the varints are little endian base 128 so the format does not depend on the CPU
+ * @version 0.1
+ * @date 2020-04-15
+ * 
+ * @copyright Copyright (c) 2020
+ * 
+ */
+#ifndef COUNTER_CODEC_H
+#define COUNTER_CODEC_H
+
+/* The longest varint of a 32 bit value */
+#define COUNTER_CODEC_VARINT_MAX     5
+/* A snapshot record is a tag and a 32 bit varint */
+#define COUNTER_CODEC_MAX_RECORD     (1 + COUNTER_CODEC_VARINT_MAX)
+
+typedef struct
+{
+    /* The value the receiver has, deltas are taken from it */
+    uint32_t reference;
+    uint16_t sinceSnapshot;
+    uint8_t started;
+}counterEncoder_t;
+
+typedef struct
+{
+    uint32_t value;
+    /* Deltas are dropped until the first snapshot */
+    uint8_t synced;
+    uint32_t snapshots;
+    uint32_t deltas;
+    uint32_t errors;
+}counterDecoder_t;
+
+/**
+ * @brief Initializes an encoder, the first update it encodes is a snapshot
+ * 
+ * @param encoder the encoder
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+extern Std_ReturnType CounterCodec_InitEncoder(counterEncoder_t* encoder);
+/**
+ * @brief Encodes a counter value as one record, the encoder is not changed until
+ * the record is committed so a record the link refused can be encoded again
+ * 
+ * @param encoder the encoder
+ * @param value the counter value
+ * @param buffer where to put the record
+ * @param bufferSize the size of the buffer, COUNTER_CODEC_MAX_RECORD is always enough
+ * @param length where to put the length of the record
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the buffer is too small
+ */
+extern Std_ReturnType CounterCodec_Encode(const counterEncoder_t* encoder, uint32_t value, uint8_t* buffer, uint16_t bufferSize, uint16_t* length);
+/**
+ * @brief Commits a value after its record was accepted by the link, the following
+ * deltas are taken from it
+ * 
+ * @param encoder the encoder
+ * @param value the counter value that was encoded
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+extern Std_ReturnType CounterCodec_Commit(counterEncoder_t* encoder, uint32_t value);
+/**
+ * @brief Takes the deltas from a value the receiver got in full some other way,
+ * it counts as a snapshot
+ * 
+ * @param encoder the encoder
+ * @param value the value the receiver has now
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+extern Std_ReturnType CounterCodec_Rebase(counterEncoder_t* encoder, uint32_t value);
+/**
+ * @brief Initializes a decoder
+ * 
+ * @param decoder the decoder
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+extern Std_ReturnType CounterCodec_InitDecoder(counterDecoder_t* decoder);
+/**
+ * @brief Decodes one record, the result is in decoder->value while decoder->synced is set
+ * 
+ * @param decoder the decoder
+ * @param data the message
+ * @param length the length of the message
+ * @param index the index of the record, it is moved past it
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the record is read, a delta before the first snapshot is dropped
+ *                  E_NOT_OK: If the record is cut or corrupted
+ */
+extern Std_ReturnType CounterCodec_Decode(counterDecoder_t* decoder, const uint8_t* data, uint16_t length, uint16_t* index);
+/**
+ * @brief Takes a value the sender sent in full some other way, the next deltas
+ * are added to it
+ * 
+ * @param decoder the decoder
+ * @param value the value from the sender
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+extern Std_ReturnType CounterCodec_Resync(counterDecoder_t* decoder, uint32_t value);
+
+/**
+ * @brief Writes a varint
+ * 
+ * @param value the value
+ * @param buffer where to write it, at least COUNTER_CODEC_VARINT_MAX bytes
+ * @return uint16_t The number of bytes written
+ */
+extern uint16_t CounterCodec_PutVarint(uint32_t value, uint8_t* buffer);
+/**
+ * @brief Reads a varint
+ * 
+ * @param data the message
+ * @param length the length of the message
+ * @param index the index of the varint, it is moved past it
+ * @param value where to put the value
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the varint is cut or too long
+ */
+extern Std_ReturnType CounterCodec_GetVarint(const uint8_t* data, uint16_t length, uint16_t* index, uint32_t* value);
+
+#endif
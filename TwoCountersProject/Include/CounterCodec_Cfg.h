@@ -0,0 +1,17 @@
+/**
+ * @file CounterCodec_Cfg.h
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief These are the user's configurations for the counter codec
+ * @version 0.1
+ * @date 2020-04-15
+ * 
+ * @copyright Copyright (c) 2020
+ * 
+ */
+#ifndef COUNTER_CODEC_CFG_H
+#define COUNTER_CODEC_CFG_H
+
+/* A full value is sent once every this number of updates */
+#define COUNTER_CODEC_SNAPSHOT_PERIOD    32
+
+#endif
@@ -0,0 +1,62 @@
+/**
+ * @file Flash.h
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief This is the user interface for the flash driver (the STM32F1 flash program
+ * and erase controller), erasing and writing run from Flash_Task a little at a time
+ * @version 0.1
+ * @date 2020-04-20
+ * 
+ * @copyright Copyright (c) 2020
+ * 
+ */
+#ifndef FLASH_H
+#define FLASH_H
+
+#define FLASH_BASE_ADDRESS           0x08000000
+#define FLASH_PAGE_SIZE              1024
+
+/* The value of an erased half word */
+#define FLASH_ERASED                 0xFFFF
+
+/* Called from Flash_Task when a job ends, E_NOT_OK if the controller reported an error */
+typedef void (*flashDoneCb_t)(Std_ReturnType result);
+
+/**
+ * @brief Starts erasing pages
+ * 
+ * @param address the address of the first page, aligned to FLASH_PAGE_SIZE
+ * @param pages the number of pages
+ * @param cb the function called when it is done, can be NULL
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the erase started
+ *                  E_NOT_OK: If the pages are not in the flash or a job is running
+ */
+extern Std_ReturnType Flash_Erase(uint32_t address, uint16_t pages, flashDoneCb_t cb);
+/**
+ * @brief Starts writing erased flash, the data has to stay there until it is done
+ * 
+ * @param address the address to write at, aligned to 2
+ * @param data the data, an odd last byte is written with 0xFF after it
+ * @param length the length of the data in bytes
+ * @param cb the function called when it is done, can be NULL
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the write started
+ *                  E_NOT_OK: If the range is not in the flash or a job is running
+ */
+extern Std_ReturnType Flash_Write(uint32_t address, const uint8_t* data, uint16_t length, flashDoneCb_t cb);
+/**
+ * @brief Checks if a job is running
+ * 
+ * @param busy where to put 1 if a job is running and 0 if not
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+extern Std_ReturnType Flash_IsBusy(uint8_t* busy);
+/**
+ * @brief The flash task, it carries on the running job, it comes every 1 milli second
+ * 
+ */
+extern void Flash_Task(void);
+
+#endif
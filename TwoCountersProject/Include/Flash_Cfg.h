@@ -0,0 +1,21 @@
+/**
+ * @file Flash_Cfg.h
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief These are the user's configurations for the flash driver
+ * @version 0.1
+ * @date 2020-04-20
+ * 
+ * @copyright Copyright (c) 2020
+ * 
+ */
+#ifndef FLASH_CFG_H
+#define FLASH_CFG_H
+
+/* The size of the flash of the part (STM32F103x8) */
+#define FLASH_SIZE                   0x10000
+
+/* The half words Flash_Task starts in one run, the CPU waits about 50 us for each one
+ * but the last, which is checked in the next run */
+#define FLASH_HALFWORDS_PER_RUN      2
+
+#endif
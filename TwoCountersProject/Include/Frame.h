@@ -0,0 +1,85 @@
+/**
+ * @file Frame.h
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief This is the user interface for the framing layer, a payload is sent
+ * with a CRC-16 and COBS encoded so the 0x00 delimiter only shows up between frames
+ * @version 0.1
+ * @date 2020-04-12
+ * 
+ * @copyright Copyright (c) 2020
+ * 
+ */
+#ifndef FRAME_H
+#define FRAME_H
+
+#define FRAME_DELIMITER              0x00
+#define FRAME_CRC_SIZE               2
+/* The largest size an encoded frame of a payload can have, with the delimiter */
+#define FRAME_ENCODED_SIZE(length)   ((length) + FRAME_CRC_SIZE + (((length) + FRAME_CRC_SIZE) / 254) + 2)
+
+#define FRAME_INCOMPLETE             0
+#define FRAME_RECEIVED               1
+#define FRAME_ERROR                  2
+
+typedef struct
+{
+    /* The decoded payload followed by its CRC */
+    uint8_t data[FRAME_MAX_PAYLOAD + FRAME_CRC_SIZE];
+    /* The payload length once a frame is received */
+    uint16_t length;
+    uint8_t left;
+    uint8_t code;
+    uint8_t started;
+    uint8_t overflow;
+    uint32_t frames;
+    uint32_t crcErrors;
+    uint32_t formatErrors;
+}frameDecoder_t;
+
+/**
+ * @brief Calculates the CRC-16/CCITT (polynomial 0x1021) of a block, it can be
+ * called block by block passing the CRC of the previous blocks
+ * 
+ * @param data the data
+ * @param length the length of the data in bytes
+ * @param crc 0xFFFF for the first block or the CRC of the previous blocks
+ * @return uint16_t the CRC
+ */
+extern uint16_t Frame_Crc16(const uint8_t* data, uint16_t length, uint16_t crc);
+/**
+ * @brief Encodes a payload into a frame ending with the delimiter
+ * 
+ * @param payload the payload
+ * @param length the length of the payload in bytes
+ * @param frame the buffer to encode in, FRAME_ENCODED_SIZE(length) bytes are enough
+ * @param frameSize the size of the buffer
+ * @param frameLength the length of the encoded frame
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the frame is encoded
+ *                  E_NOT_OK: If the buffer is too small
+ */
+extern Std_ReturnType Frame_Encode(const uint8_t* payload, uint16_t length, uint8_t* frame, uint16_t frameSize, uint16_t* frameLength);
+/**
+ * @brief Initializes a decoder, it waits for a delimiter before the first frame
+ * 
+ * @param decoder the decoder
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+extern Std_ReturnType Frame_InitDecoder(frameDecoder_t* decoder);
+/**
+ * @brief Feeds one received byte to a decoder, a frame that is cut or corrupted is
+ * dropped at the next delimiter and decoding goes on with the frame after it
+ * 
+ * @param decoder the decoder
+ * @param byte the received byte
+ * @return uint8_t The state of the decoder
+ *                  FRAME_INCOMPLETE: More bytes are needed
+ *                  FRAME_RECEIVED: A frame is received, the payload is in decoder->data
+ *                  and its length in decoder->length until the next byte is fed
+ *                  FRAME_ERROR: A frame was dropped
+ */
+extern uint8_t Frame_DecodeByte(frameDecoder_t* decoder, uint8_t byte);
+
+#endif
@@ -0,0 +1,17 @@
+/**
+ * @file Frame_Cfg.h
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief These are the user's configurations for the framing layer
+ * @version 0.1
+ * @date 2020-04-12
+ * 
+ * @copyright Copyright (c) 2020
+ * 
+ */
+#ifndef FRAME_CFG_H
+#define FRAME_CFG_H
+
+/* The largest payload a decoder accepts, longer frames are dropped */
+#define FRAME_MAX_PAYLOAD            72
+
+#endif
@@ -0,0 +1,110 @@
+/**
+ * @file FwUpdate.h
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief This is the user interface for the firmware update, a new image is streamed
+ * over the link into the download slot while the application keeps running and the
+ * boot loader copies it over the application after a reset
+ * @version 0.1
+ * @date 2020-04-20
+ * 
+ * @copyright Copyright (c) 2020
+ * 
+ */
+#ifndef FWUPDATE_H
+#define FWUPDATE_H
+
+/* The first byte of a message, a request is followed by the operation and a 16 bits
+ * argument and a reply by the operation, the status and the blocks programmed so far */
+#define FWUPDATE_MSG_REQUEST         0x20
+#define FWUPDATE_MSG_REPLY           0x21
+#define FWUPDATE_HEADER_SIZE         4
+#define FWUPDATE_REPLY_SIZE          5
+
+/* The data of one FWUPDATE_OP_DATA message, a block is a whole number of chunks */
+#define FWUPDATE_CHUNK_SIZE          64
+
+/* Starts or resumes an update, the arguments are the image size (4 bytes) and CRC (2 bytes) */
+#define FWUPDATE_OP_START            0x01
+/* A chunk of the image, the argument is the index of the chunk */
+#define FWUPDATE_OP_DATA             0x02
+/* Ends a block, the argument is the index of the block and the arguments its CRC (2 bytes) */
+#define FWUPDATE_OP_BLOCK_END        0x03
+/* Checks the whole image once every block is programmed */
+#define FWUPDATE_OP_FINISH           0x04
+#define FWUPDATE_OP_STATUS           0x05
+/* Resets into the boot loader once the image is checked */
+#define FWUPDATE_OP_REBOOT           0x06
+
+#define FWUPDATE_STATUS_OK           0x00
+#define FWUPDATE_STATUS_BUSY         0x01
+#define FWUPDATE_STATUS_BAD_ARGS     0x02
+#define FWUPDATE_STATUS_BAD_STATE    0x03
+#define FWUPDATE_STATUS_CRC_ERROR    0x04
+#define FWUPDATE_STATUS_FLASH_ERROR  0x05
+
+/* The update state page, in half words: the magic, the image size, the image CRC,
+ * the state and then a zeroed half word for every block programmed and checked */
+#define FWUPDATE_META_MAGIC          0x5746
+#define FWUPDATE_META_MAGIC_INDEX    0
+#define FWUPDATE_META_SIZE_INDEX     1
+#define FWUPDATE_META_CRC_INDEX      3
+#define FWUPDATE_META_STATE_INDEX    4
+#define FWUPDATE_META_BLOCKS_INDEX   8
+#define FWUPDATE_META_READY          0x5AA5
+#define FWUPDATE_META_BLOCK_DONE     0x0000
+
+#define FWUPDATE_IDLE                0
+#define FWUPDATE_ERASING             1
+#define FWUPDATE_RECEIVING           2
+#define FWUPDATE_CHECKING            3
+#define FWUPDATE_READY               4
+
+typedef struct
+{
+    uint8_t state;
+    uint32_t size;
+    uint16_t blocks;
+    /* The blocks programmed and checked */
+    uint16_t programmed;
+    uint32_t chunks;
+    uint32_t crcErrors;
+    uint32_t flashErrors;
+    /* Chunks and block ends of a block that is not the one being received */
+    uint32_t dropped;
+}fwUpdateStats_t;
+
+/**
+ * @brief Initializes the firmware update, the link has to be initialized first
+ * 
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+extern Std_ReturnType FwUpdate_Init(void);
+/**
+ * @brief Handles a request received from the link
+ * 
+ * @param data the message starting with FWUPDATE_MSG_REQUEST
+ * @param length the length of the message
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the request is handled
+ *                  E_NOT_OK: If the message is not a request
+ */
+extern Std_ReturnType FwUpdate_Receive(const uint8_t* data, uint16_t length);
+/**
+ * @brief Gets the progress of the update
+ * 
+ * @param stats where to put the progress
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+extern Std_ReturnType FwUpdate_GetStats(fwUpdateStats_t* stats);
+/**
+ * @brief The firmware update task, it programs the received blocks, checks the image
+ * and sends the replies
+ * 
+ */
+extern void FwUpdate_Task(void);
+
+#endif
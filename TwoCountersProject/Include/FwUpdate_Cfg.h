@@ -0,0 +1,32 @@
+/**
+ * @file FwUpdate_Cfg.h
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief These are the user's configurations for the firmware update
+ * @version 0.1
+ * @date 2020-04-20
+ * 
+ * @copyright Copyright (c) 2020
+ * 
+ */
+#ifndef FWUPDATE_CFG_H
+#define FWUPDATE_CFG_H
+
+/* The flash of the part is split into the boot loader, the running application,
+ * the download slot the new image is received in and the update state page, the
+ * two slots are whole pages, Build/Memory.ld has to give the same regions */
+#define FWUPDATE_APP_ADDRESS         0x08002000
+#define FWUPDATE_DOWNLOAD_ADDRESS    0x08008800
+#define FWUPDATE_SLOT_SIZE           0x6800
+#define FWUPDATE_META_ADDRESS        0x0800F000
+
+/* The image is programmed and checked block by block, a block is received in one
+ * buffer while the other one is programmed */
+#define FWUPDATE_BLOCK_SIZE          256
+
+/* The replies waiting for the link */
+#define FWUPDATE_REPLY_QUEUE_LENGTH  4
+
+/* The period of FwUpdate_Task */
+#define FWUPDATE_TASK_PERIOD_MS      10
+
+#endif
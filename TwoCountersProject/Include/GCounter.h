@@ -0,0 +1,146 @@
+/**
+ * @file GCounter.h
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief This is the user interface for the replicated counter (a state based
+ * G-counter), every node counts in its own slot and the slots received from the
+ * other nodes are merged by taking the larger value, so a message can be lost,
+ * repeated or reordered without breaking the total
+ * @version 0.1
+ * @date 2020-04-16
+ * 
+ * @copyright Copyright (c) 2020
+ * 
+ */
+#ifndef GCOUNTER_H
+#define GCOUNTER_H
+
+/* A message entry is the node number and the slot value as a varint */
+#define GCOUNTER_MAX_ENTRY           (1 + COUNTER_CODEC_VARINT_MAX)
+/* A delta entry is the node number and a record of the delta stream of the slot */
+#define GCOUNTER_MAX_DELTA_ENTRY     (1 + COUNTER_CODEC_MAX_RECORD)
+
+/**
+ * @brief Initializes the counter with all the slots cleared
+ * 
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+extern Std_ReturnType GCounter_Init(void);
+/**
+ * @brief Increments the slot of this node
+ * 
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+extern Std_ReturnType GCounter_Increment(void);
+/**
+ * @brief Builds a delta message with the slots a press or a merge changed since they
+ * were last sent, every slot goes as a record of its delta stream and stays pending
+ * until the message is committed, a message has to be committed before the next one
+ * is built
+ * 
+ * @param buffer where to put the message
+ * @param bufferSize the size of the buffer, at least GCOUNTER_MAX_DELTA_ENTRY
+ * @param length where to put the length of the message, 0 if nothing changed
+ * @param sentMask where to put the slots in the message
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+extern Std_ReturnType GCounter_BuildDelta(uint8_t* buffer, uint16_t bufferSize, uint16_t* length, uint32_t* sentMask);
+/**
+ * @brief Marks the slots of a delta message as sent after the link took it, the
+ * next deltas of these slots are taken from the values in the message
+ * 
+ * @param sentMask the slots given by GCounter_BuildDelta
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+extern Std_ReturnType GCounter_CommitDelta(uint32_t sentMask);
+/**
+ * @brief Builds an anti-entropy message with the next slots in turn, sending one
+ * from time to time repairs the slots a node missed or lost in a reset, the slots
+ * go as whole values so a peer that lost a delta stream can take it again
+ * 
+ * @param buffer where to put the message
+ * @param bufferSize the size of the buffer, at least GCOUNTER_MAX_ENTRY
+ * @param length where to put the length of the message, 0 if all the slots are 0
+ * @param sentMask where to put the slots in the message
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+extern Std_ReturnType GCounter_BuildSync(uint8_t* buffer, uint16_t bufferSize, uint16_t* length, uint32_t* sentMask);
+/**
+ * @brief Restarts the delta streams of the slots of an anti-entropy message after
+ * the link took it, the peer takes the values in it as the base of the next deltas
+ * 
+ * @param sentMask the slots given by GCounter_BuildSync
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+extern Std_ReturnType GCounter_CommitSync(uint32_t sentMask);
+/**
+ * @brief Merges a delta message received from another node, a slot whose stream
+ * has no base yet is skipped until its next snapshot or anti-entropy message
+ * 
+ * @param data the message
+ * @param length the length of the message
+ * @param changed where to put 1 if a slot got larger and 0 if not
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the message is corrupted, the entries before the
+ *                  corrupted one are merged
+ */
+extern Std_ReturnType GCounter_MergeDelta(const uint8_t* data, uint16_t length, uint8_t* changed);
+/**
+ * @brief Merges an anti-entropy message received from another node, the values in
+ * it are the base of the next deltas of their slots
+ * 
+ * @param data the message
+ * @param length the length of the message
+ * @param changed where to put 1 if a slot got larger and 0 if not
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the message is corrupted, the entries before the
+ *                  corrupted one are merged
+ */
+extern Std_ReturnType GCounter_MergeSync(const uint8_t* data, uint16_t length, uint8_t* changed);
+/**
+ * @brief Merges whole slot values that did not come from the link, like the ones
+ * kept in flash, the delta streams are not touched
+ * 
+ * @param data the slots as node numbers and varints
+ * @param length the length of the data
+ * @param changed where to put 1 if a slot got larger and 0 if not
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the data is corrupted, the entries before the
+ *                  corrupted one are merged
+ */
+extern Std_ReturnType GCounter_Merge(const uint8_t* data, uint16_t length, uint8_t* changed);
+/**
+ * @brief Gets the sum of all the slots
+ * 
+ * @param total where to put the sum
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+extern Std_ReturnType GCounter_GetTotal(uint32_t* total);
+/**
+ * @brief Gets the count of one node
+ * 
+ * @param node the node number
+ * @param value where to put the count
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+extern Std_ReturnType GCounter_GetSlot(uint8_t node, uint32_t* value);
+
+#endif
@@ -0,0 +1,24 @@
+/**
+ * @file GCounter_Cfg.h
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief These are the user's configurations for the replicated counter
+ * @version 0.1
+ * @date 2020-04-16
+ * 
+ * @copyright Copyright (c) 2020
+ * 
+ */
+#ifndef GCOUNTER_CFG_H
+#define GCOUNTER_CFG_H
+
+/* The number of nodes sharing the counter, at most 32 */
+#define GCOUNTER_MAX_NODES           8
+/* The slot owned by this node, every board gets its own number from the build
+ * (-DGCOUNTER_NODE_ID=n) so two boards never count in the same slot */
+#ifndef GCOUNTER_NODE_ID
+#error "GCOUNTER_NODE_ID has to be defined for every board"
+#elif GCOUNTER_NODE_ID >= GCOUNTER_MAX_NODES
+#error "GCOUNTER_NODE_ID has to be less than GCOUNTER_MAX_NODES"
+#endif
+
+#endif
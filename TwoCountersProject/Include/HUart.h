@@ -23,11 +23,89 @@
 #define HUART_STOP_ONE_BIT 0x00000000
 #define HUART_STOP_TWO_BITS 0x00003000
 
-#define HUART_FLOW_CONTROL_EN 0x00000100
+/* RTS is driven from the receive buffer watermarks, CTS pauses the transmitter in hardware */
+#define HUART_FLOW_CONTROL_RTS 0x00000100
+#define HUART_FLOW_CONTROL_CTS 0x00000200
+#define HUART_FLOW_CONTROL_EN 0x00000300
 #define HUART_FLOW_CONTROL_DIS 0x00000000
 
+#define HUART_CLOCK_DIS 0x00000000
+#define HUART_CLOCK_EN 0x00000800
+#define HUART_CLOCK_CPOL_HIGH 0x00000400
+#define HUART_CLOCK_CPHA_SECOND 0x00000200
+#define HUART_CLOCK_LAST_BIT 0x00000100
+
+#define HUART_LANE_HIGH          0
+#define HUART_LANE_NORMAL        1
+#define HUART_TX_LANES           2
+
+#define HUART_MAX_ADDRESS        0x0F
+#define HUART_NO_ADDRESS         0xFF
+
+#define HUART_DROP_REJECT        0
+#define HUART_DROP_OLDEST        1
+
+#define HUART_RX_COMPLETE            0
+#define HUART_RX_TIMEOUT             1
+#define HUART_RX_INTERBYTE_TIMEOUT   2
+
 typedef void (*hUartTxCb_t)(void);
 typedef void (*hUartRxCb_t)(void);
+typedef void (*hUartNotifyCb_t)(uint8_t uartModule, uint16_t length);
+typedef void (*hUartRxStatusCb_t)(uint8_t uartModule, uint16_t length, uint8_t status);
+
+typedef struct
+{
+    uint8_t* data;
+    uint16_t length;
+}hUartSegment_t;
+
+typedef struct
+{
+    uint32_t txBytes;
+    uint32_t rxBytes;
+    uint32_t txFrames;
+    uint32_t rxFrames;
+    uint32_t overruns;
+    uint32_t framingErrors;
+    uint32_t noiseErrors;
+    uint32_t parityErrors;
+    uint32_t rxDropped;
+    uint32_t queueFull;
+    uint32_t laneDropped;
+    uint32_t rxTimeouts;
+    /* Time from the end of the last stop bit to the release of DE in half-duplex mode */
+    uint32_t turnarounds;
+    uint32_t turnaroundMinUs;
+    uint32_t turnaroundMaxUs;
+    uint32_t turnaroundTotalUs;
+    /* Time from queuing a packet to the end of its transmission */
+    uint32_t latencySamples;
+    uint32_t latencyMinUs;
+    uint32_t latencyMaxUs;
+    uint32_t latencyTotalUs;
+    /* Time the counters cover, txBytes / elapsedUs is the throughput */
+    uint32_t elapsedUs;
+    /* CPU cycles in the interrupt handler, only counted when UART_ISR_PROFILING is 1 */
+    uint32_t isrCalls;
+    uint32_t isrCycles;
+    /* coalescedSends / coalescedTransfers is the coalescing ratio */
+    uint32_t coalescedSends;
+    uint32_t coalescedTransfers;
+    uint8_t peakTxQueue;
+    uint8_t peakRxQueue;
+}hUartStats_t;
+
+typedef struct
+{
+    uint32_t allocs;
+    /* Allocations that failed because every block was in use */
+    uint32_t exhausted;
+    uint8_t freeBlocks;
+    uint8_t minFreeBlocks;
+}hUartPoolStats_t;
+
+typedef void (*hUartSgDoneCb_t)(uint8_t uartModule, const hUartSegment_t* segments, uint8_t nSegments);
 
 /**
  * @brief Initializes the UART Module
@@ -36,6 +114,20 @@ typedef void (*hUartRxCb_t)(void);
  *                  E_NOT_OK: If the did not execute successfully
  */
 extern Std_ReturnType HUart_Init(void);
+/**
+ * @brief Initializes a specific UART Module
+ * 
+ * @param uartModule The UART module
+ *                  HUART_MODULE_1
+ *                  HUART_MODULE_2
+ *                  HUART_MODULE_3
+ *                  HUART_MODULE_4
+ *                  HUART_MODULE_5
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the configured baud rate can't be reached from the bus clock
+ */
+extern Std_ReturnType HUart_InitOn(uint8_t uartModule);
 /**
  * @brief Sets configurations for the UART module
  * *The UART must be initialized after setting configurations to apply the changes
@@ -48,7 +140,9 @@ extern Std_ReturnType HUart_Init(void);
  *                 HUART_ODD_PARITY
  *                 HUART_EVEN_PARITY
  *                 HUART_NO_PARITY
- * @param flowControl the flow control
+ * @param flowControl the flow control (only UART1 to UART3 have the pins for it)
+ *                 HUART_FLOW_CONTROL_RTS
+ *                 HUART_FLOW_CONTROL_CTS
  *                 HUART_FLOW_CONTROL_EN
  *                 HUART_FLOW_CONTROL_DIS
  * @return Std_ReturnType A Status
@@ -56,6 +150,50 @@ extern Std_ReturnType HUart_Init(void);
  *                  E_NOT_OK: If the did not execute successfully
  */
 extern Std_ReturnType HUart_Config(uint32_t baudRate, uint32_t stopBits, uint32_t parity, uint32_t flowControl);
+/**
+ * @brief Sets configurations for a specific UART module
+ * *The UART must be initialized after setting configurations to apply the changes
+ * 
+ * @param uartModule The UART module
+ *                  HUART_MODULE_1
+ *                  HUART_MODULE_2
+ *                  HUART_MODULE_3
+ *                  HUART_MODULE_4
+ *                  HUART_MODULE_5
+ * @param baudRate the baud rate of the UART (uint32_t)
+ * @param stopBits The number of the stop bits
+ *                 HUART_ONE_STOP_BIT
+ *                 HUART_TWO_STOP_BITS
+ * @param parity The parity of the transmission
+ *                 HUART_ODD_PARITY
+ *                 HUART_EVEN_PARITY
+ *                 HUART_NO_PARITY
+ * @param flowControl the flow control (only UART1 to UART3 have the pins for it)
+ *                 HUART_FLOW_CONTROL_RTS
+ *                 HUART_FLOW_CONTROL_CTS
+ *                 HUART_FLOW_CONTROL_EN
+ *                 HUART_FLOW_CONTROL_DIS
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+extern Std_ReturnType HUart_ConfigOn(uint8_t uartModule, uint32_t baudRate, uint32_t stopBits, uint32_t parity, uint32_t flowControl);
+/**
+ * @brief Gets the baud rate achieved on a specific UART module
+ *
+ * @param uartModule The UART module
+ *                  HUART_MODULE_1
+ *                  HUART_MODULE_2
+ *                  HUART_MODULE_3
+ *                  HUART_MODULE_4
+ *                  HUART_MODULE_5
+ * @param actualBaud the baud rate generated from the bus clock
+ * @param errorPpm the difference from the configured baud rate in ppm
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the module is not initialized
+ */
+extern Std_ReturnType HUart_GetBaudRateOn(uint8_t uartModule, uint32_t* actualBaud, sint32_t* errorPpm);
 /**
  * @brief Sets the module that you will be using
  * 
@@ -80,6 +218,159 @@ extern Std_ReturnType HUart_SetModule(uint8_t uartModule);
  *                  E_NOT_OK: If the driver can't send data right now
  */
 extern Std_ReturnType HUart_Send(uint8_t *data, uint16_t length);
+/**
+ * @brief Sends data through a specific UART module
+ * *With coalescing enabled small sends are copied, so the buffer can be reused on return
+ *
+ * @param uartModule The UART module
+ *                  HUART_MODULE_1
+ *                  HUART_MODULE_2
+ *                  HUART_MODULE_3
+ *                  HUART_MODULE_4
+ *                  HUART_MODULE_5
+ * @param data The data to send
+ * @param length the length of the data in bytes
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the driver is ready to send
+ *                  E_NOT_OK: If the driver can't send data right now
+ */
+extern Std_ReturnType HUart_SendOn(uint8_t uartModule, uint8_t *data, uint16_t length);
+/**
+ * @brief Sends data through a specific UART module on a priority lane
+ * *Queued packets of the high lane always go out before the ones of the normal lane
+ *
+ * @param uartModule The UART module
+ *                  HUART_MODULE_1
+ *                  HUART_MODULE_2
+ *                  HUART_MODULE_3
+ *                  HUART_MODULE_4
+ *                  HUART_MODULE_5
+ * @param lane The transmit lane
+ *                  HUART_LANE_HIGH
+ *                  HUART_LANE_NORMAL
+ * @param data The data to send
+ * @param length the length of the data in bytes
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the driver is ready to send
+ *                  E_NOT_OK: If the driver can't send data right now
+ */
+extern Std_ReturnType HUart_SendPriorityOn(uint8_t uartModule, uint8_t lane, uint8_t *data, uint16_t length);
+/**
+ * @brief Sets the depth limit and the drop policy of a transmit lane
+ * *Lanes using HUART_DROP_OLDEST must be fed from task level
+ *
+ * @param uartModule The UART module
+ *                  HUART_MODULE_1
+ *                  HUART_MODULE_2
+ *                  HUART_MODULE_3
+ *                  HUART_MODULE_4
+ *                  HUART_MODULE_5
+ * @param lane The transmit lane
+ *                  HUART_LANE_HIGH
+ *                  HUART_LANE_NORMAL
+ * @param depth The maximum number of queued packets (1 to 5)
+ * @param policy What happens to a send when the lane is full
+ *                  HUART_DROP_REJECT: The new packet is rejected
+ *                  HUART_DROP_OLDEST: The oldest queued packet is dropped
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+extern Std_ReturnType HUart_SetLanePolicyOn(uint8_t uartModule, uint8_t lane, uint8_t depth, uint8_t policy);
+/**
+ * @brief Sends data to one node on a multi-drop bus through a specific UART module
+ * *Only the node with this address wakes up to receive it
+ *
+ * @param uartModule The UART module
+ *                  HUART_MODULE_1
+ *                  HUART_MODULE_2
+ *                  HUART_MODULE_3
+ *                  HUART_MODULE_4
+ *                  HUART_MODULE_5
+ * @param address The address of the receiving node (0 to 15)
+ * @param data The data to send
+ * @param length the length of the data in bytes
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the driver is ready to send
+ *                  E_NOT_OK: If the driver can't send data right now
+ */
+extern Std_ReturnType HUart_SendToOn(uint8_t uartModule, uint8_t address, uint8_t *data, uint16_t length);
+/**
+ * @brief Sets the address of this node for the multi-drop mode of a specific module
+ * *The receiver is muted in hardware between frames and only wakes up for its own
+ * address, each receive request is taken as one frame
+ * *Multi-drop needs the module to be configured without parity
+ *
+ * @param uartModule The UART module
+ *                  HUART_MODULE_1
+ *                  HUART_MODULE_2
+ *                  HUART_MODULE_3
+ *                  HUART_MODULE_4
+ *                  HUART_MODULE_5
+ * @param address The address of this node (0 to 15) or HUART_NO_ADDRESS to leave multi-drop mode
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+extern Std_ReturnType HUart_SetNodeAddressOn(uint8_t uartModule, uint8_t address);
+/**
+ * @brief Puts a specific module in half-duplex (RS-485) mode with a GPIO driving
+ * the DE/RE pins of the transceiver, the pin is high while transmitting
+ * *The pin is asserted before the first byte and released on the transmission
+ * complete interrupt once the last stop bit is out
+ *
+ * @param uartModule The UART module
+ *                  HUART_MODULE_1
+ *                  HUART_MODULE_2
+ *                  HUART_MODULE_3
+ *                  HUART_MODULE_4
+ *                  HUART_MODULE_5
+ * @param port the port of the DE/RE pin or 0 to go back to full-duplex
+ * @param pin the DE/RE pin
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+extern Std_ReturnType HUart_SetDriverEnablePinOn(uint8_t uartModule, uint32_t port, uint32_t pin);
+/**
+ * @brief Puts a specific module in synchronous mode, the module drives the
+ * clock on its CK pin so the link can run faster than in asynchronous mode
+ * *The module is always the clock master, the other board has to take the
+ * clock in as a slave
+ *
+ * @param uartModule The UART module
+ *                  HUART_MODULE_1
+ *                  HUART_MODULE_2
+ *                  HUART_MODULE_3
+ * @param clockMode HUART_CLOCK_DIS to go back to asynchronous mode or HUART_CLOCK_EN combined with
+ *                  HUART_CLOCK_CPOL_HIGH: CK is high when idle
+ *                  HUART_CLOCK_CPHA_SECOND: Data is captured on the second clock edge
+ *                  HUART_CLOCK_LAST_BIT: A clock pulse is given for the last data bit
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the module has no CK pin (HUART_MODULE_4 and HUART_MODULE_5)
+ */
+extern Std_ReturnType HUart_SetClockModeOn(uint8_t uartModule, uint32_t clockMode);
+/**
+ * @brief Sends a list of segments back to back through a specific UART module
+ * without copying them into one buffer
+ * *The segments list and the buffers it points to are owned by the driver until
+ * the done callback is called
+ *
+ * @param uartModule The UART module
+ *                  HUART_MODULE_1
+ *                  HUART_MODULE_2
+ *                  HUART_MODULE_3
+ *                  HUART_MODULE_4
+ *                  HUART_MODULE_5
+ * @param segments The segments to send
+ * @param nSegments The number of segments
+ * @param doneCb The function called when the last segment is sent to give back the buffers (can be NULL)
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the driver is ready to send
+ *                  E_NOT_OK: If the driver can't send data right now
+ */
+extern Std_ReturnType HUart_SendSegmentsOn(uint8_t uartModule, const hUartSegment_t* segments, uint8_t nSegments, hUartSgDoneCb_t doneCb);
 /**
  * @brief Receives data through the UART
  *
@@ -90,6 +381,61 @@ extern Std_ReturnType HUart_Send(uint8_t *data, uint16_t length);
  *                  E_NOT_OK: If the driver can't receive data right now
  */
 extern Std_ReturnType HUart_Receive(uint8_t *data, uint16_t length);
+/**
+ * @brief Receives data through a specific UART module
+ *
+ * @param uartModule The UART module
+ *                  HUART_MODULE_1
+ *                  HUART_MODULE_2
+ *                  HUART_MODULE_3
+ *                  HUART_MODULE_4
+ *                  HUART_MODULE_5
+ * @param data The buffer to receive data in
+ * @param length the length of the data in bytes
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the driver is ready to receive
+ *                  E_NOT_OK: If the driver can't receive data right now
+ */
+extern Std_ReturnType HUart_ReceiveOn(uint8_t uartModule, uint8_t *data, uint16_t length);
+/**
+ * @brief Reads the bytes that arrived on a specific UART module while no receive
+ * request was waiting, it does not wait for more so it suits byte stream decoders
+ *
+ * @param uartModule The UART module
+ *                  HUART_MODULE_1
+ *                  HUART_MODULE_2
+ *                  HUART_MODULE_3
+ *                  HUART_MODULE_4
+ *                  HUART_MODULE_5
+ * @param data The buffer to read into
+ * @param maxLength the size of the buffer in bytes
+ * @param count the number of bytes read
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+extern Std_ReturnType HUart_ReadOn(uint8_t uartModule, uint8_t *data, uint16_t maxLength, uint16_t *count);
+/**
+ * @brief Receives data through a specific UART module with timeouts
+ * *When a timeout expires the request ends early and the bytes received so far
+ * are reported through the receive status callback
+ *
+ * @param uartModule The UART module
+ *                  HUART_MODULE_1
+ *                  HUART_MODULE_2
+ *                  HUART_MODULE_3
+ *                  HUART_MODULE_4
+ *                  HUART_MODULE_5
+ * @param data The buffer to receive data in
+ * @param length the length of the data in bytes
+ * @param totalTimeout the time in milliseconds allowed for the whole request or 0 to wait forever
+ * @param interByteTimeout the time in milliseconds allowed between two bytes once the
+ * first byte is received or 0 for no limit
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the driver is ready to receive
+ *                  E_NOT_OK: If the driver can't receive data right now
+ */
+extern Std_ReturnType HUart_ReceiveTimeoutOn(uint8_t uartModule, uint8_t *data, uint16_t length, uint16_t totalTimeout, uint16_t interByteTimeout);
 /**
  * @brief Sets the callback function that will be called when receive is
  * completed
@@ -110,9 +456,171 @@ extern Std_ReturnType HUart_SetRxCb(hUartRxCb_t func);
  *                  E_NOT_OK: If the did not execute successfully
  */
 extern Std_ReturnType HUart_SetTxCb(hUartTxCb_t func);
+/**
+ * @brief Sets the callback function that will be called when a receive request
+ * on a specific module is completed
+ *
+ * @param uartModule The UART module
+ *                  HUART_MODULE_1
+ *                  HUART_MODULE_2
+ *                  HUART_MODULE_3
+ *                  HUART_MODULE_4
+ *                  HUART_MODULE_5
+ * @param func the callback function, it receives the module and the number of bytes received
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+extern Std_ReturnType HUart_SetRxNotifyOn(uint8_t uartModule, hUartNotifyCb_t func);
+/**
+ * @brief Sets the callback function that will be called when a receive request
+ * on a specific module ends, either completed or timed out
+ *
+ * @param uartModule The UART module
+ *                  HUART_MODULE_1
+ *                  HUART_MODULE_2
+ *                  HUART_MODULE_3
+ *                  HUART_MODULE_4
+ *                  HUART_MODULE_5
+ * @param func the callback function, it receives the module, the number of bytes
+ * received and the status
+ *                  HUART_RX_COMPLETE
+ *                  HUART_RX_TIMEOUT
+ *                  HUART_RX_INTERBYTE_TIMEOUT
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+extern Std_ReturnType HUart_SetRxStatusCbOn(uint8_t uartModule, hUartRxStatusCb_t func);
+/**
+ * @brief Sets the callback function that will be called when a transmission
+ * on a specific module is completed
+ *
+ * @param uartModule The UART module
+ *                  HUART_MODULE_1
+ *                  HUART_MODULE_2
+ *                  HUART_MODULE_3
+ *                  HUART_MODULE_4
+ *                  HUART_MODULE_5
+ * @param func the callback function, it receives the module and the number of bytes sent
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+extern Std_ReturnType HUart_SetTxNotifyOn(uint8_t uartModule, hUartNotifyCb_t func);
+
+/**
+ * @brief Enables or disables the coalescing of small sends on a specific module
+ * *Sends that fit in HUART_COALESCE_BUFFER_SIZE are copied into a staging buffer
+ * that goes out as one transfer when the window elapses or the threshold is reached
+ * *Coalesced sends must be issued from task level
+ *
+ * @param uartModule The UART module
+ *                  HUART_MODULE_1
+ *                  HUART_MODULE_2
+ *                  HUART_MODULE_3
+ *                  HUART_MODULE_4
+ *                  HUART_MODULE_5
+ * @param windowMs The longest time data waits in the staging buffer, 0 disables coalescing
+ * @param threshold The number of staged bytes that triggers the transfer right away
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+extern Std_ReturnType HUart_SetCoalescingOn(uint8_t uartModule, uint16_t windowMs, uint16_t threshold);
+/**
+ * @brief Sends whatever is in the staging buffer of a specific module now
+ *
+ * @param uartModule The UART module
+ *                  HUART_MODULE_1
+ *                  HUART_MODULE_2
+ *                  HUART_MODULE_3
+ *                  HUART_MODULE_4
+ *                  HUART_MODULE_5
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the staged data is queued or nothing is staged
+ *                  E_NOT_OK: If the previous transfer is still going, try again later
+ */
+extern Std_ReturnType HUart_FlushOn(uint8_t uartModule);
+/**
+ * @brief Takes a block from the transmit buffer pool, the caller owns it until
+ * it is sent with HUart_SendBlockOn or given back with HUart_FreeBlock
+ *
+ * @param block where to put the address of the block, it holds HUART_POOL_BLOCK_SIZE bytes
+ * @return Std_ReturnType A Status
+ *                  E_OK: If a block is allocated
+ *                  E_NOT_OK: If the pool is empty
+ */
+extern Std_ReturnType HUart_AllocBlock(uint8_t** block);
+/**
+ * @brief Gives a block that will not be sent back to the transmit buffer pool
+ *
+ * @param block the block
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the block is freed
+ *                  E_NOT_OK: If it is not a pool block owned by the caller
+ */
+extern Std_ReturnType HUart_FreeBlock(uint8_t* block);
+/**
+ * @brief Sends a pool block through a specific UART module, the driver owns
+ * the block from now on and frees it once it is sent or dropped
+ * *The block is freed as well if it can't be queued
+ *
+ * @param uartModule The UART module
+ *                  HUART_MODULE_1
+ *                  HUART_MODULE_2
+ *                  HUART_MODULE_3
+ *                  HUART_MODULE_4
+ *                  HUART_MODULE_5
+ * @param block the block taken with HUart_AllocBlock
+ * @param length the number of bytes to send from the block
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the block is queued
+ *                  E_NOT_OK: If the block is not owned by the caller or can't be queued
+ */
+extern Std_ReturnType HUart_SendBlockOn(uint8_t uartModule, uint8_t* block, uint16_t length);
+/**
+ * @brief Gets the statistics of the transmit buffer pool
+ *
+ * @param stats where to copy the statistics
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+extern Std_ReturnType HUart_GetPoolStats(hUartPoolStats_t* stats);
+/**
+ * @brief Gets the statistics of a specific UART module
+ *
+ * @param uartModule The UART module
+ *                  HUART_MODULE_1
+ *                  HUART_MODULE_2
+ *                  HUART_MODULE_3
+ *                  HUART_MODULE_4
+ *                  HUART_MODULE_5
+ * @param stats where to copy the statistics
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+extern Std_ReturnType HUart_GetStatsOn(uint8_t uartModule, hUartStats_t* stats);
+/**
+ * @brief Clears the statistics of a specific UART module
+ *
+ * @param uartModule The UART module
+ *                  HUART_MODULE_1
+ *                  HUART_MODULE_2
+ *                  HUART_MODULE_3
+ *                  HUART_MODULE_4
+ *                  HUART_MODULE_5
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+extern Std_ReturnType HUart_ResetStatsOn(uint8_t uartModule);
 
 /**
  * @brief The HUart Running task to handle the UART Requests
+ * *Only the modules that have queued or staged work are visited
  * 
  */
 extern void HUart_Task(void);
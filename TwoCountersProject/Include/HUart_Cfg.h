@@ -11,6 +11,7 @@
 #ifndef HUART_CFG_H
 #define HUART_CFG_H
 
+/* The system clock (SYSCLK), the clock of each UART is derived from it through the AHB/APB prescalers */
 #define HUART_SYSTEM_CLK             8000000
 
 #define HUART_DEFAULT_BAUDRATE       9600
@@ -20,4 +21,15 @@
 
 #define HUART_DEFAULT_MODULE         HUART_MODULE_1
 
+/* The period of HUart_Task in milli seconds, the receive timeouts and the coalescing
+ * window are timed on the SysTick and checked this often */
+#define HUART_TASK_PERIOD_MS         1
+
+/* The size of each of the two staging buffers used to coalesce small sends */
+#define HUART_COALESCE_BUFFER_SIZE   32
+
+/* The transmit buffer pool, blocks are sent with HUart_SendBlockOn (at most 254 blocks) */
+#define HUART_POOL_BLOCKS            8
+#define HUART_POOL_BLOCK_SIZE        80
+
 #endif
\ No newline at end of file
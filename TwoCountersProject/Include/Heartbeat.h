@@ -0,0 +1,99 @@
+/**
+ * @file Heartbeat.h
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief This is the user interface for the link heartbeat, it pings the peer
+ * with link datagrams to measure the RTT and the loss and to tell if it is alive
+ * @version 0.1
+ * @date 2020-04-17
+ * 
+ * @copyright Copyright (c) 2020
+ * 
+ */
+#ifndef HEARTBEAT_H
+#define HEARTBEAT_H
+
+/* The RTT histogram, bin i counts the RTTs below HEARTBEAT_BIN_LIMIT_US(i) and
+ * the last bin counts the rest */
+#define HEARTBEAT_HIST_BINS          8
+#define HEARTBEAT_BIN_LIMIT_US(bin)  ((uint32_t)1000 << (bin))
+
+/* The loss is taken over the last pings */
+#define HEARTBEAT_LOSS_WINDOW        32
+
+/* The local time the ping was sent, the peer time it was answered and the
+ * local time the pong came, all in micro seconds */
+typedef void (*heartbeatSampleCb_t)(uint32_t sentAt, uint32_t peerTime, uint32_t receivedAt);
+
+typedef struct
+{
+    uint32_t pingsSent;
+    uint32_t pongsReceived;
+    /* Pongs for a ping that was already counted as lost */
+    uint32_t pongsLate;
+    uint32_t rttSamples;
+    uint32_t rttMinUs;
+    uint32_t rttMaxUs;
+    uint32_t rttAvgUs;
+    uint32_t histogram[HEARTBEAT_HIST_BINS];
+    /* The pings lost out of the last HEARTBEAT_LOSS_WINDOW */
+    uint8_t lossPercent;
+    uint8_t peerAlive;
+    uint32_t peerLosses;
+    uint16_t periodMs;
+}heartbeatStats_t;
+
+/**
+ * @brief Initializes the heartbeat, the link has to be initialized first
+ * 
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+extern Std_ReturnType Heartbeat_Init(void);
+/**
+ * @brief Sets the callback function that will be called with the times of every
+ * answered ping
+ * 
+ * @param func the callback function
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+extern Std_ReturnType Heartbeat_SetSampleCb(heartbeatSampleCb_t func);
+/**
+ * @brief Checks if the peer was heard in the last HEARTBEAT_PEER_TIMEOUT_MS
+ * 
+ * @param alive where to put 1 if the peer is alive and 0 if not
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+extern Std_ReturnType Heartbeat_IsPeerAlive(uint8_t* alive);
+/**
+ * @brief Gets an RTT percentile from the histogram, the result is the upper limit
+ * of the bin it falls in
+ * 
+ * @param percent the percentile from 1 to 100
+ * @param rttUs where to put the RTT in micro seconds
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If there is no RTT sample yet or the percent is wrong
+ */
+extern Std_ReturnType Heartbeat_GetRttPercentile(uint8_t percent, uint32_t* rttUs);
+/**
+ * @brief Gets the statistics of the heartbeat
+ * 
+ * @param stats where to copy the statistics
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+extern Std_ReturnType Heartbeat_GetStats(heartbeatStats_t* stats);
+/**
+ * @brief The heartbeat task, it sends the pings and watches the peer, it comes
+ * every HEARTBEAT_TASK_PERIOD_MS
+ * 
+ */
+extern void Heartbeat_Task(void);
+
+#endif
@@ -0,0 +1,26 @@
+/**
+ * @file Heartbeat_Cfg.h
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief These are the user's configurations for the link heartbeat
+ * @version 0.1
+ * @date 2020-04-17
+ * 
+ * @copyright Copyright (c) 2020
+ * 
+ */
+#ifndef HEARTBEAT_CFG_H
+#define HEARTBEAT_CFG_H
+
+/* The period of Heartbeat_Task in milli seconds */
+#define HEARTBEAT_TASK_PERIOD_MS     10
+
+/* The ping period starts at the minimum, doubles with every pong up to the
+ * maximum and goes back to the minimum when a pong is missed */
+#define HEARTBEAT_MIN_PERIOD_MS      100
+#define HEARTBEAT_MAX_PERIOD_MS      2000
+
+/* The peer is lost when nothing is heard from it for this time, it has to be
+ * longer than the maximum period */
+#define HEARTBEAT_PEER_TIMEOUT_MS    5000
+
+#endif
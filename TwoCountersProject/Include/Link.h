@@ -0,0 +1,110 @@
+/**
+ * @file Link.h
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief This is the user interface for the reliable link layer, messages are
+ * numbered and kept until the peer acknowledges them (Go-Back-N)
+ * @version 0.1
+ * @date 2020-04-14
+ * 
+ * @copyright Copyright (c) 2020
+ * 
+ */
+#ifndef LINK_H
+#define LINK_H
+
+typedef void (*linkRxCb_t)(const uint8_t* data, uint16_t length);
+
+typedef struct
+{
+    uint32_t sent;
+    uint32_t retransmits;
+    uint32_t timeouts;
+    uint32_t delivered;
+    /* Messages received again or out of order, they are dropped and acked */
+    uint32_t duplicates;
+    uint32_t outOfOrder;
+    uint32_t acksSent;
+    /* Every valid frame, it shows the peer is alive */
+    uint32_t framesReceived;
+    /* Sessions started again because the peer started again */
+    uint32_t restarts;
+    uint32_t rttSamples;
+    uint16_t rttMinMs;
+    uint16_t rttMaxMs;
+    uint16_t srttMs;
+    uint16_t rtoMs;
+}linkStats_t;
+
+/**
+ * @brief Initializes the link, the transport has to be initialized first
+ * 
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+extern Std_ReturnType Link_Init(void);
+/**
+ * @brief Sends a message, it is copied and kept until the peer acknowledges it
+ * 
+ * @param data the message
+ * @param length the length of the message in bytes, at most LINK_MAX_PAYLOAD
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the message is accepted
+ *                  E_NOT_OK: If the message is too long or the window is full
+ */
+extern Std_ReturnType Link_Send(const uint8_t* data, uint16_t length);
+/**
+ * @brief Sends a datagram right away, it is not numbered, acked or sent again
+ * 
+ * @param data the datagram
+ * @param length the length of the datagram in bytes, at most LINK_MAX_PAYLOAD
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the transport accepted the datagram
+ *                  E_NOT_OK: If the datagram is too long or the transport is busy
+ */
+extern Std_ReturnType Link_SendDatagram(const uint8_t* data, uint16_t length);
+/**
+ * @brief Gets the number of messages sent and not yet acknowledged
+ * 
+ * @param pending where to put the number of messages
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+extern Std_ReturnType Link_GetPending(uint8_t* pending);
+/**
+ * @brief Sets the callback function that will be called with every message
+ * received in order
+ * 
+ * @param func the callback function
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+extern Std_ReturnType Link_SetRxCb(linkRxCb_t func);
+/**
+ * @brief Sets the callback function that will be called with every datagram received
+ * 
+ * @param func the callback function
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+extern Std_ReturnType Link_SetDatagramCb(linkRxCb_t func);
+/**
+ * @brief Gets the statistics of the link
+ * 
+ * @param stats where to copy the statistics
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+extern Std_ReturnType Link_GetStats(linkStats_t* stats);
+/**
+ * @brief The link task, it decodes the received frames, sends the messages and acks
+ * and retransmits on timeout, it comes every LINK_TASK_PERIOD_MS
+ * 
+ */
+extern void Link_Task(void);
+
+#endif
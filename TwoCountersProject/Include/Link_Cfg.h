@@ -0,0 +1,30 @@
+/**
+ * @file Link_Cfg.h
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief These are the user's configurations for the reliable link layer
+ * @version 0.1
+ * @date 2020-04-14
+ * 
+ * @copyright Copyright (c) 2020
+ * 
+ */
+#ifndef LINK_CFG_H
+#define LINK_CFG_H
+
+/* The period of Link_Task in milli seconds */
+#define LINK_TASK_PERIOD_MS          1
+
+/* The number of messages that can wait for an ack, a power of two up to 128 */
+#define LINK_WINDOW_SIZE             8
+/* The largest message Link_Send accepts, its frame has to fit the transport (LINK_MAX_PAYLOAD + 7 bytes) */
+#define LINK_MAX_PAYLOAD             68
+
+/* The retransmission timeout before the first RTT sample and its limits */
+#define LINK_INITIAL_RTO_MS          200
+#define LINK_MIN_RTO_MS              20
+#define LINK_MAX_RTO_MS              2000
+
+/* The number of received bytes decoded at a time */
+#define LINK_READ_CHUNK              16
+
+#endif
@@ -144,4 +144,9 @@ extern void NVIC_controlFault(u8 status);
  * @param priority the priority of the interrupt
  */
 extern void NVIC_filterInterrupts(u8 priority);
+/**
+ * @brief Resets the whole system, it does not return
+ * 
+ */
+extern void NVIC_systemReset(void);
 #endif
\ No newline at end of file
@@ -0,0 +1,52 @@
+/**
+ * @file Persist.h
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief This is the user interface for the counter persistence, the slots of the
+ * counter are appended as records to a log in flash pages used in turn and the
+ * last record is merged back into the counter at start up
+ * @version 0.1
+ * @date 2020-04-21
+ * 
+ * @copyright Copyright (c) 2020
+ * 
+ */
+#ifndef PERSIST_H
+#define PERSIST_H
+
+typedef struct
+{
+    /* The sequence number of the page written now, it goes up with every new page */
+    uint32_t sequence;
+    uint32_t records;
+    uint32_t erases;
+    uint32_t errors;
+    /* The records restored at start up, 0 or 1 */
+    uint8_t restored;
+}persistStats_t;
+
+/**
+ * @brief Initializes the persistence and merges the last record into the counter,
+ * the counter has to be initialized first
+ * 
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+extern Std_ReturnType Persist_Init(void);
+/**
+ * @brief Gets the statistics of the log
+ * 
+ * @param stats where to put the statistics
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+extern Std_ReturnType Persist_GetStats(persistStats_t* stats);
+/**
+ * @brief The persistence task, it appends a record when the counter changed and
+ * the last record is old enough
+ * 
+ */
+extern void Persist_Task(void);
+
+#endif
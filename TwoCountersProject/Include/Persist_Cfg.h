@@ -0,0 +1,24 @@
+/**
+ * @file Persist_Cfg.h
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief These are the user's configurations for the counter persistence
+ * @version 0.1
+ * @date 2020-04-21
+ * 
+ * @copyright Copyright (c) 2020
+ * 
+ */
+#ifndef PERSIST_CFG_H
+#define PERSIST_CFG_H
+
+/* The flash pages the records are written in turn (at most 8), after the update
+ * state page up to the end of the flash, the PERSIST region of Build/Memory.ld */
+#define PERSIST_FIRST_PAGE           0x0800F400
+#define PERSIST_PAGES                3
+
+/* The period of Persist_Task */
+#define PERSIST_TASK_PERIOD_MS       100
+/* The shortest time between two records, the presses in between go in one record */
+#define PERSIST_MIN_INTERVAL_MS      5000
+
+#endif
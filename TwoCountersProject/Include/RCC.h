@@ -347,4 +347,18 @@ void RCC_configurePrescalers(u32 target, u32 preValue);
 */
 void RCC_configureMCO(u32 clkNum);
 
+/**
+* Function Name: RCC_getBusClock
+* Usage: get the current clock of a bus from the configured prescalers
+* Function Arguments:
+* u32 target - takes one of these values
+*   RCC_AHB_PRESCALER 
+*   RCC_APB2_PRESCALER
+*   RCC_APB1_PRESCALER
+
+* u32 sysClk - the system clock in Hz
+* Return: the clock of the bus in Hz
+*/
+u32 RCC_getBusClock(u32 target, u32 sysClk);
+
 #endif
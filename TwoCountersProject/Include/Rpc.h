@@ -0,0 +1,66 @@
+/**
+ * @file Rpc.h
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief This is the user interface for the command channel, requests come over the
+ * link next to the counter messages and are answered from Rpc_Task
+ * @version 0.1
+ * @date 2020-04-19
+ * 
+ * @copyright Copyright (c) 2020
+ * 
+ */
+#ifndef RPC_H
+#define RPC_H
+
+/* The first byte of a message, a request is followed by a tag and the command and
+ * a response by the tag of the request and the status, the rest is data */
+#define RPC_MSG_REQUEST              0x10
+#define RPC_MSG_RESPONSE             0x11
+#define RPC_HEADER_SIZE              3
+
+/* The largest arguments or reply of a command */
+#define RPC_MAX_DATA                 (LINK_MAX_PAYLOAD - RPC_HEADER_SIZE)
+
+/* A command that takes any number of arguments */
+#define RPC_ANY_LENGTH               0xFF
+
+#define RPC_STATUS_OK                0x00
+#define RPC_STATUS_UNKNOWN           0x01
+#define RPC_STATUS_BAD_ARGS          0x02
+#define RPC_STATUS_FAILED            0x03
+
+/* Runs a command, it returns the status and puts the reply data in reply */
+typedef uint8_t (*rpcHandler_t)(const uint8_t* args, uint8_t argLength, uint8_t* reply, uint8_t* replyLength);
+
+typedef struct
+{
+    rpcHandler_t handler;
+    /* The exact number of arguments or RPC_ANY_LENGTH */
+    uint8_t argLength;
+}rpcCommand_t;
+
+/**
+ * @brief Initializes the command channel, the link has to be initialized first
+ * 
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+extern Std_ReturnType Rpc_Init(void);
+/**
+ * @brief Queues a request received from the link, it is run by Rpc_Task
+ * 
+ * @param data the message starting with RPC_MSG_REQUEST
+ * @param length the length of the message
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the request is queued
+ *                  E_NOT_OK: If the message is not a request or the queue is full
+ */
+extern Std_ReturnType Rpc_Receive(const uint8_t* data, uint16_t length);
+/**
+ * @brief The command task, it runs the queued requests and sends the responses
+ * 
+ */
+extern void Rpc_Task(void);
+
+#endif
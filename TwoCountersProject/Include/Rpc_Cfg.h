@@ -0,0 +1,34 @@
+/**
+ * @file Rpc_Cfg.h
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief These are the user's configurations for the command channel
+ * @version 0.1
+ * @date 2020-04-19
+ * 
+ * @copyright Copyright (c) 2020
+ * 
+ */
+#ifndef RPC_CFG_H
+#define RPC_CFG_H
+
+/* The requests that can wait for Rpc_Task */
+#define RPC_QUEUE_LENGTH             2
+
+/* The commands, they index the table in Rpc_Cfg.c */
+#define RPC_CMD_PING                 0x00
+#define RPC_CMD_SCHED_STATS          0x01
+#define RPC_CMD_UART_TRAFFIC         0x02
+#define RPC_CMD_UART_ERRORS          0x03
+#define RPC_CMD_LCD_STATUS           0x04
+#define RPC_CMD_LINK_STATS           0x05
+#define RPC_CMD_SET_PERIOD           0x06
+#define RPC_CMD_RESET_STATS          0x07
+
+#define RPC_COMMAND_COUNT            8
+
+/* The statistics RPC_CMD_RESET_STATS clears */
+#define RPC_RESET_SCHED              0x01
+#define RPC_RESET_UART               0x02
+#define RPC_RESET_LCD                0x04
+
+#endif
@@ -12,13 +12,30 @@
 #define SCHED1_H 
 typedef void (*taskRunnable)(void);
 
+/* The task counts its runs as time, its period is fixed */
+#define SCHED_TASK_FIXED       0x00
+/* The task takes its time from the SysTick, SCHED_setPeriod may change its period */
+#define SCHED_TASK_TUNABLE     0x01
+
 typedef struct
 {
   taskRunnable runnable;
   u32 periodicTime;
   u32 priority;
+  /* SCHED_TASK_FIXED or SCHED_TASK_TUNABLE */
+  u32 flags;
 } Task;
 
+typedef struct
+{
+  u32 ticks;
+  /* The time spent running the tasks, the load is busyUs / (ticks * tick time) */
+  u32 busyUs;
+  u32 maxTickUs;
+  /* The ticks lost because the tasks of the previous one were still running */
+  u32 overruns;
+} SchedStats;
+
 /**
  * @brief The initialization function
  * 
@@ -35,4 +52,30 @@ void SCHED_createTask (Task *appTask);
  * 
  */
 void SCHED_start(void);
+/**
+ * @brief Changes the period of a task created with SCHED_TASK_TUNABLE, such a task
+ * times itself on the SysTick so its timeouts stay the same, only how often they
+ * are checked changes
+ * 
+ * @param priority The priority of the task
+ * @param periodicTime The new period in micro seconds, at least one tick
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If there is no such task, its period is fixed or the period is too short
+ */
+Std_ReturnType SCHED_setPeriod(u32 priority, u32 periodicTime);
+/**
+ * @brief Gets the load statistics of the scheduler
+ * 
+ * @param stats where to copy the statistics
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+Std_ReturnType SCHED_getStats(SchedStats *stats);
+/**
+ * @brief Clears the load statistics of the scheduler
+ * 
+ */
+void SCHED_resetStats(void);
 #endif
\ No newline at end of file
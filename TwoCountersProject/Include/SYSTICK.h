@@ -43,4 +43,11 @@ void SYSTICK_setTime(u32 time, u32 AHB_clockHz);
  * 
  * @param cbF the function to set
  */
-void SYSTICK_setCallbackFcn(SYSTICK_cbF cbF);
\ No newline at end of file
+void SYSTICK_setCallbackFcn(SYSTICK_cbF cbF);
+/**
+ * @brief Gets the time since the SysTick was started
+ * *It can be called from an interrupt that blocks the SysTick handler
+ * 
+ * @return u32 the time in micro seconds, it wraps around after about 71 minutes
+ */
+u32 SYSTICK_getMicros(void);
\ No newline at end of file
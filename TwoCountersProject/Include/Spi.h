@@ -0,0 +1,88 @@
+/**
+ * @file Spi.h
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief This is the user interface for the SPI driver
+ * @version 0.1
+ * @date 2020-04-10
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#ifndef SPI_H
+#define SPI_H
+
+#define SPI1        0
+#define SPI2        1
+
+/* The chip select is handled in software, a slave is always selected */
+#define SPI_MASTER 0x00000304
+#define SPI_SLAVE 0x00000200
+
+#define SPI_MODE_0 0x00000000
+#define SPI_MODE_1 0x00000001
+#define SPI_MODE_2 0x00000002
+#define SPI_MODE_3 0x00000003
+
+#define SPI_BAUD_DIV_2 0x00000000
+#define SPI_BAUD_DIV_4 0x00000008
+#define SPI_BAUD_DIV_8 0x00000010
+#define SPI_BAUD_DIV_16 0x00000018
+#define SPI_BAUD_DIV_32 0x00000020
+#define SPI_BAUD_DIV_64 0x00000028
+#define SPI_BAUD_DIV_128 0x00000030
+#define SPI_BAUD_DIV_256 0x00000038
+
+typedef void (*spiDoneCb_t)(uint8_t spiModule, uint16_t length);
+
+/**
+ * @brief Initializes the SPI, the GPIO pins, the clock and the interrupt of the
+ * module have to be set up by the user
+ *
+ * @param role the role of the module
+ *                 SPI_MASTER
+ *                 SPI_SLAVE
+ * @param mode the clock polarity and phase
+ *                 SPI_MODE_0
+ *                 SPI_MODE_1
+ *                 SPI_MODE_2
+ *                 SPI_MODE_3
+ * @param baudDiv the division of the bus clock for the master
+ *                 SPI_BAUD_DIV_2 to SPI_BAUD_DIV_256
+ * @param spiModule the module number of the SPI
+ *                 SPI1
+ *                 SPI2
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+extern Std_ReturnType Spi_Init(uint32_t role, uint32_t mode, uint32_t baudDiv, uint8_t spiModule);
+/**
+ * @brief Exchanges data through the SPI, one byte is received for every byte sent
+ * *A slave only moves when the master gives the clock
+ *
+ * @param txData the data to send or NULL to send SPI_DUMMY_BYTE
+ * @param rxData the buffer to receive in or NULL to drop the received bytes
+ * @param length the number of bytes to exchange
+ * @param spiModule the module number of the SPI
+ *                 SPI1
+ *                 SPI2
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the driver started the transfer
+ *                  E_NOT_OK: If the driver is busy with another transfer
+ */
+extern Std_ReturnType Spi_Transfer(const uint8_t *txData, uint8_t *rxData, uint16_t length, uint8_t spiModule);
+/**
+ * @brief Sets the callback function that will be called when a transfer is
+ * completed
+ *
+ * @param func the callback function
+ * @param spiModule the module number of the SPI
+ *                 SPI1
+ *                 SPI2
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+extern Std_ReturnType Spi_SetDoneCb(spiDoneCb_t func, uint8_t spiModule);
+
+#endif
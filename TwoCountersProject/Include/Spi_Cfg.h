@@ -0,0 +1,17 @@
+/**
+ * @file Spi_Cfg.h
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief These are the user's configurations for the SPI driver
+ * @version 0.1
+ * @date 2020-04-10
+ * 
+ * @copyright Copyright (c) 2020
+ * 
+ */
+#ifndef SPI_CFG_H
+#define SPI_CFG_H
+
+/* The byte sent when a transfer has no data to send */
+#define SPI_DUMMY_BYTE              0x00
+
+#endif
@@ -0,0 +1,141 @@
+/**
+ * @file Transport.h
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief This is the user interface for the transport layer, it lets the
+ * application send and receive frames without knowing the peripheral
+ * @version 0.1
+ * @date 2020-04-10
+ * 
+ * @copyright Copyright (c) 2020
+ * 
+ */
+#ifndef TRANSPORT_H
+#define TRANSPORT_H
+
+#define TRANSPORT_HUART              0
+#define TRANSPORT_SPI                1
+#define TRANSPORT_LOOPBACK           2
+
+/* The backend supports the inter-byte receive timeout */
+#define TRANSPORT_CAP_RX_TIMEOUT     0x01
+/* Data can be sent at any time, not only when the peer gives the clock */
+#define TRANSPORT_CAP_TX_ANYTIME     0x02
+/* Data can be received at any time, not only while sending */
+#define TRANSPORT_CAP_RX_ANYTIME     0x04
+/* The backend moves data through a peripheral */
+#define TRANSPORT_CAP_HARDWARE       0x08
+/* Received bytes can be read as a stream with Transport_Read */
+#define TRANSPORT_CAP_STREAM         0x10
+
+#define TRANSPORT_RX_COMPLETE        0
+#define TRANSPORT_RX_TIMEOUT         1
+
+typedef void (*transportTxCb_t)(uint16_t length);
+typedef void (*transportRxCb_t)(uint16_t length, uint8_t status);
+
+typedef struct
+{
+    uint8_t flags;
+    /* The largest frame Transport_Send accepts */
+    uint16_t maxFrame;
+    /* The line rate in bits per second, 0 if there is no line */
+    uint32_t bitRate;
+}transportCaps_t;
+
+/* The operations a backend provides */
+typedef struct
+{
+    Std_ReturnType (*init)(void);
+    Std_ReturnType (*send)(const uint8_t* data, uint16_t length);
+    Std_ReturnType (*receive)(uint8_t* data, uint16_t length, uint16_t interByteTimeout);
+    Std_ReturnType (*read)(uint8_t* data, uint16_t maxLength, uint16_t* count);
+    Std_ReturnType (*getCaps)(transportCaps_t* caps);
+}transport_t;
+
+/**
+ * @brief Initializes the backend selected by TRANSPORT_BACKEND
+ * 
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+extern Std_ReturnType Transport_Init(void);
+/**
+ * @brief Switches to another backend and initializes it
+ * 
+ * @param backend the backend
+ *                  TRANSPORT_HUART
+ *                  TRANSPORT_SPI
+ *                  TRANSPORT_LOOPBACK
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the backend is unknown or can't be initialized
+ */
+extern Std_ReturnType Transport_SetBackend(uint8_t backend);
+/**
+ * @brief Sends a frame, the data is copied so the buffer can be reused
+ * as soon as the function returns
+ * 
+ * @param data the frame
+ * @param length the length of the frame in bytes
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the frame is accepted
+ *                  E_NOT_OK: If the frame is too long or the backend is busy
+ */
+extern Std_ReturnType Transport_Send(const uint8_t* data, uint16_t length);
+/**
+ * @brief Receives a frame, the receive callback is called when it is received
+ * or when the inter-byte timeout expires
+ * 
+ * @param data the buffer to receive in
+ * @param length the length of the frame in bytes
+ * @param interByteTimeout the time allowed between two bytes in milli seconds or 0 for no limit,
+ * it is ignored by backends without TRANSPORT_CAP_RX_TIMEOUT
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the backend is ready to receive
+ *                  E_NOT_OK: If the backend can't receive right now
+ */
+extern Std_ReturnType Transport_Receive(uint8_t* data, uint16_t length, uint16_t interByteTimeout);
+/**
+ * @brief Reads the bytes received while no receive was armed, it does not wait
+ * for more, only backends with TRANSPORT_CAP_STREAM support it
+ * 
+ * @param data the buffer to read into
+ * @param maxLength the size of the buffer in bytes
+ * @param count the number of bytes read
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the backend has no byte stream
+ */
+extern Std_ReturnType Transport_Read(uint8_t* data, uint16_t maxLength, uint16_t* count);
+/**
+ * @brief Sets the callback function that will be called when a frame is sent
+ * 
+ * @param func the callback function
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+extern Std_ReturnType Transport_SetTxCb(transportTxCb_t func);
+/**
+ * @brief Sets the callback function that will be called when a receive ends
+ * 
+ * @param func the callback function, it receives the number of bytes received and the status
+ *                  TRANSPORT_RX_COMPLETE
+ *                  TRANSPORT_RX_TIMEOUT
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+extern Std_ReturnType Transport_SetRxCb(transportRxCb_t func);
+/**
+ * @brief Gets the capabilities of the current backend
+ * 
+ * @param caps where to copy the capabilities
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+extern Std_ReturnType Transport_GetCaps(transportCaps_t* caps);
+
+#endif
@@ -0,0 +1,35 @@
+/**
+ * @file Transport_Cfg.h
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief These are the user's configurations for the transport layer
+ * @version 0.1
+ * @date 2020-04-10
+ * 
+ * @copyright Copyright (c) 2020
+ * 
+ */
+#ifndef TRANSPORT_CFG_H
+#define TRANSPORT_CFG_H
+
+/* The backend used by Transport_Init */
+#define TRANSPORT_BACKEND            TRANSPORT_HUART
+
+/* The system clock (SYSCLK), the SPI bit rate is derived from it */
+#define TRANSPORT_SYSTEM_CLK         8000000
+
+#define TRANSPORT_HUART_MODULE       HUART_DEFAULT_MODULE
+
+#define TRANSPORT_SPI_MODULE         SPI1
+#define TRANSPORT_SPI_ROLE           SPI_MASTER
+#define TRANSPORT_SPI_MODE           SPI_MODE_0
+#define TRANSPORT_SPI_BAUD_DIV       SPI_BAUD_DIV_8
+
+/* The largest frame the SPI backend can copy */
+#define TRANSPORT_SPI_MAX_FRAME      80
+/* The bytes the SPI backend keeps from its transfers until they are read as a stream */
+#define TRANSPORT_SPI_STREAM_SIZE    128
+
+/* The bytes the loopback backend can hold before they are received */
+#define TRANSPORT_LOOPBACK_SIZE      160
+
+#endif
@@ -23,11 +23,48 @@
 #define UART_STOP_ONE_BIT 0x00000000
 #define UART_STOP_TWO_BITS 0x00003000
 
-#define UART_FLOW_CONTROL_EN 0x00000100
+#define UART_FLOW_CONTROL_RTS 0x00000100
+#define UART_FLOW_CONTROL_CTS 0x00000200
+#define UART_FLOW_CONTROL_EN 0x00000300
 #define UART_FLOW_CONTROL_DIS 0x00000000
 
+#define UART_FLOW_GO 0
+#define UART_FLOW_STOP 1
+
+#define UART_CLOCK_DIS 0x00000000
+#define UART_CLOCK_EN 0x00000800
+#define UART_CLOCK_CPOL_HIGH 0x00000400
+#define UART_CLOCK_CPHA_SECOND 0x00000200
+#define UART_CLOCK_LAST_BIT 0x00000100
+
+#define UART_DE_RELEASE 0
+#define UART_DE_ASSERT 1
+#define UART_DE_DRAIN 2
+
 typedef void (*txCb_t)(void);
 typedef void (*rxCb_t)(void);
+typedef void (*doneCb_t)(uint8_t uartModule, uint16_t length);
+typedef void (*flowCb_t)(uint8_t uartModule, uint8_t state);
+
+typedef struct
+{
+  uint8_t *data;
+  uint16_t length;
+} uartSegment_t;
+
+typedef struct
+{
+  uint32_t txBytes;
+  uint32_t rxBytes;
+  uint32_t overruns;
+  uint32_t framingErrors;
+  uint32_t noiseErrors;
+  uint32_t parityErrors;
+  uint32_t rxDropped;
+  /* Only counted when UART_ISR_PROFILING is 1 */
+  uint32_t isrCalls;
+  uint32_t isrCycles;
+} uartStats_t;
 
 /**
  * @brief Initializes the UART
@@ -41,9 +78,13 @@ typedef void (*rxCb_t)(void);
  *                 UART_EVEN_PARITY
  *                 UART_NO_PARITY
  * @param flowControl the flow control
+ *                 UART_FLOW_CONTROL_RTS
+ *                 UART_FLOW_CONTROL_CTS
  *                 UART_FLOW_CONTROL_EN
  *                 UART_FLOW_CONTROL_DIS
- * @param sysClk the clock of the system
+ * @param busClk the clock of the bus the module is on
+ *                 PCLK2 for UART1
+ *                 PCLK1 for UART2 to UART5
  * @param uartModule the module number of the UART
  *                 UART1
  *                 UART2
@@ -52,10 +93,10 @@ typedef void (*rxCb_t)(void);
  *                 UART5
  * @return Std_ReturnType A Status
  *                  E_OK: If the function executed successfully
- *                  E_NOT_OK: If the did not execute successfully
+ *                  E_NOT_OK: If the baud rate can't be reached within UART_BAUD_TOLERANCE_PPM
  */
 extern Std_ReturnType Uart_Init(uint32_t baudRate, uint32_t stopBits,
-                                uint32_t parity, uint32_t flowControl, uint32_t sysClk, uint8_t uartModule);
+                                uint32_t parity, uint32_t flowControl, uint32_t busClk, uint8_t uartModule);
 /**
  * @brief Sends data through the UART
  *
@@ -72,6 +113,42 @@ extern Std_ReturnType Uart_Init(uint32_t baudRate, uint32_t stopBits,
  *                  E_NOT_OK: If the driver can't send data right now
  */
 extern Std_ReturnType Uart_Send(uint8_t *data, uint16_t length, uint8_t uartModule);
+/**
+ * @brief Sends data to one node of a multi-drop bus, the address byte is sent
+ * with the address mark first so only that node wakes up to receive the data
+ *
+ * @param data The data to send
+ * @param length the length of the data in bytes
+ * @param address the address of the receiving node (0 to 15)
+ * @param uartModule the module number of the UART
+ *                 UART1
+ *                 UART2
+ *                 UART3
+ *                 UART4
+ *                 UART5
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the driver is ready to send
+ *                  E_NOT_OK: If the driver can't send data right now or the module is not in multi-drop mode
+ */
+extern Std_ReturnType Uart_SendTo(uint8_t *data, uint16_t length, uint8_t address, uint8_t uartModule);
+/**
+ * @brief Sends a list of segments back to back through the UART without
+ * copying them, the segments and the data they point to must stay valid
+ * until the transmission is completed
+ *
+ * @param segments The segments to send
+ * @param nSegments the number of segments
+ * @param uartModule the module number of the UART
+ *                 UART1
+ *                 UART2
+ *                 UART3
+ *                 UART4
+ *                 UART5
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the driver is ready to send
+ *                  E_NOT_OK: If the driver can't send data right now
+ */
+extern Std_ReturnType Uart_SendSegments(const uartSegment_t *segments, uint8_t nSegments, uint8_t uartModule);
 /**
  * @brief Receives data through the UART
  *
@@ -88,6 +165,24 @@ extern Std_ReturnType Uart_Send(uint8_t *data, uint16_t length, uint8_t uartModu
  *                  E_NOT_OK: If the driver can't receive data right now
  */
 extern Std_ReturnType Uart_Receive(uint8_t *data, uint16_t length, uint8_t uartModule);
+/**
+ * @brief Reads the bytes that arrived while no receive request was waiting,
+ * it does not wait for more so it suits byte stream decoders
+ *
+ * @param data The buffer to read into
+ * @param maxLength the size of the buffer in bytes
+ * @param count the number of bytes read
+ * @param uartModule the module number of the UART
+ *                 UART1
+ *                 UART2
+ *                 UART3
+ *                 UART4
+ *                 UART5
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+extern Std_ReturnType Uart_Read(uint8_t *data, uint16_t maxLength, uint16_t *count, uint8_t uartModule);
 /**
  * @brief Sets the callback function that will be called when transmission is
  * completed
@@ -120,5 +215,211 @@ extern Std_ReturnType Uart_SetTxCb(txCb_t func, uint8_t uartModule);
  *                  E_NOT_OK: If the did not execute successfully
  */
 extern Std_ReturnType Uart_SetRxCb(rxCb_t func, uint8_t uartModule);
+/**
+ * @brief Sets the callback function that will be called with the module number
+ * and the number of bytes sent when a transmission is completed
+ *
+ * @param func the callback function
+ * @param uartModule the module number of the UART
+ *                 UART1
+ *                 UART2
+ *                 UART3
+ *                 UART4
+ *                 UART5
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+extern Std_ReturnType Uart_SetTxDoneCb(doneCb_t func, uint8_t uartModule);
+/**
+ * @brief Sets the callback function that will be called with the module number
+ * and the number of bytes received when a receive is completed
+ *
+ * @param func the callback function
+ * @param uartModule the module number of the UART
+ *                 UART1
+ *                 UART2
+ *                 UART3
+ *                 UART4
+ *                 UART5
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+extern Std_ReturnType Uart_SetRxDoneCb(doneCb_t func, uint8_t uartModule);
+
+/**
+ * @brief Gets the baud rate achieved by the last successful initialization
+ *
+ * @param actualBaud the achieved baud rate
+ * @param errorPpm the difference from the requested baud rate in ppm
+ * @param uartModule the module number of the UART
+ *                 UART1
+ *                 UART2
+ *                 UART3
+ *                 UART4
+ *                 UART5
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+extern Std_ReturnType Uart_GetBaudRate(uint32_t *actualBaud, sint32_t *errorPpm, uint8_t uartModule);
+
+/**
+ * @brief Sets the callback function that will be called when the receive ring
+ * buffer crosses its watermarks, it can be used to drive the RTS line
+ *
+ * @param func the callback function
+ *                 UART_FLOW_STOP: The ring buffer reached UART_RX_HIGH_WATERMARK
+ *                 UART_FLOW_GO: The ring buffer drained to UART_RX_LOW_WATERMARK
+ * @param uartModule the module number of the UART
+ *                 UART1
+ *                 UART2
+ *                 UART3
+ *                 UART4
+ *                 UART5
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+extern Std_ReturnType Uart_SetRxFlowCb(flowCb_t func, uint8_t uartModule);
+
+/**
+ * @brief Gets the byte and error counters of a module
+ *
+ * @param stats where to copy the counters
+ * @param uartModule the module number of the UART
+ *                 UART1
+ *                 UART2
+ *                 UART3
+ *                 UART4
+ *                 UART5
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+extern Std_ReturnType Uart_GetStats(uartStats_t *stats, uint8_t uartModule);
+/**
+ * @brief Clears the byte and error counters of a module
+ *
+ * @param uartModule the module number of the UART
+ *                 UART1
+ *                 UART2
+ *                 UART3
+ *                 UART4
+ *                 UART5
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+extern Std_ReturnType Uart_ResetStats(uint8_t uartModule);
+
+/**
+ * @brief Puts the module in multi-drop mode with the given node address, the
+ * receiver stays muted until a byte with the address mark and this address
+ * arrives, the module must be initialized without parity
+ *
+ * @param address the address of this node (0 to 15)
+ * @param uartModule the module number of the UART
+ *                 UART1
+ *                 UART2
+ *                 UART3
+ *                 UART4
+ *                 UART5
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the address is invalid or parity is enabled
+ */
+extern Std_ReturnType Uart_SetAddress(uint8_t address, uint8_t uartModule);
+/**
+ * @brief Mutes the receiver of a multi-drop module until its address is
+ * received again
+ *
+ * @param uartModule the module number of the UART
+ *                 UART1
+ *                 UART2
+ *                 UART3
+ *                 UART4
+ *                 UART5
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the module is not in multi-drop mode
+ */
+extern Std_ReturnType Uart_Mute(uint8_t uartModule);
+
+/**
+ * @brief Gets the number of bytes received so far for the current receive request
+ *
+ * @param count the number of bytes received
+ * @param uartModule the module number of the UART
+ *                 UART1
+ *                 UART2
+ *                 UART3
+ *                 UART4
+ *                 UART5
+ * @return Std_ReturnType A Status
+ *                  E_OK: If a receive request is running
+ *                  E_NOT_OK: If there is no receive request
+ */
+extern Std_ReturnType Uart_GetRxCount(uint16_t *count, uint8_t uartModule);
+/**
+ * @brief Ends the current receive request without notifying the user,
+ * the bytes already received stay in the buffer of the request
+ * *Bytes that arrive after the abort are kept in the receive ring
+ *
+ * @param count the number of bytes received before the abort
+ * @param uartModule the module number of the UART
+ *                 UART1
+ *                 UART2
+ *                 UART3
+ *                 UART4
+ *                 UART5
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the request is aborted
+ *                  E_NOT_OK: If there is no receive request, it may have just completed
+ */
+extern Std_ReturnType Uart_AbortReceive(uint16_t *count, uint8_t uartModule);
+
+/**
+ * @brief Sets the callback function that drives the driver enable line of a
+ * half-duplex (RS-485) transceiver, setting it puts the module in half-duplex mode
+ * *In half-duplex mode the transmission is only done once the last stop bit has
+ * left the line (TC) so the next one can't start before the line is released
+ *
+ * @param func the callback function or NULL for full-duplex
+ *                 UART_DE_ASSERT: Before the first byte is written
+ *                 UART_DE_DRAIN: The last byte is in the shift register
+ *                 UART_DE_RELEASE: The transmission is complete
+ * @param uartModule the module number of the UART
+ *                 UART1
+ *                 UART2
+ *                 UART3
+ *                 UART4
+ *                 UART5
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+extern Std_ReturnType Uart_SetDriverEnableCb(flowCb_t func, uint8_t uartModule);
+
+/**
+ * @brief Sets the synchronous clock mode of a module, in synchronous mode the
+ * module is the clock master and drives CK while it transmits
+ * *The USART can't take its clock from CK so there is no slave mode, the peer
+ * of a synchronous link has to be a clock slave (like an SPI slave)
+ *
+ * @param clockMode UART_CLOCK_DIS or UART_CLOCK_EN combined with
+ *                 UART_CLOCK_CPOL_HIGH: CK is high when idle
+ *                 UART_CLOCK_CPHA_SECOND: Data is captured on the second clock edge
+ *                 UART_CLOCK_LAST_BIT: A clock pulse is given for the last data bit
+ * @param uartModule the module number of the UART
+ *                 UART1
+ *                 UART2
+ *                 UART3
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the module has no CK pin (UART4 and UART5) or is sending
+ */
+extern Std_ReturnType Uart_SetClockMode(uint32_t clockMode, uint8_t uartModule);
 
 #endif
@@ -14,4 +14,16 @@
 
 #define UART_SYSTEM_CLK             8000000
 
+/* The maximum accepted difference between the requested and the achieved baud rate in ppm */
+#define UART_BAUD_TOLERANCE_PPM     20000
+
+/* The size of the buffer keeping bytes received while no receive request is waiting */
+#define UART_RX_RING_SIZE           64
+/* The fill levels at which the sender is asked to stop and to continue */
+#define UART_RX_HIGH_WATERMARK      48
+#define UART_RX_LOW_WATERMARK       16
+
+/* Set to 1 to count the CPU cycles spent in the interrupt handler with the DWT cycle counter */
+#define UART_ISR_PROFILING          0
+
 #endif
\ No newline at end of file
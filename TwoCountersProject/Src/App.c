@@ -11,27 +11,207 @@
 #include "Std_Types.h"
 #include <stdlib.h>
 #include "stdio.h"
-#include "HUart_Cfg.h"
-#include "HUart.h"
+#include "Transport.h"
+#include "Link_Cfg.h"
+#include "Link.h"
+#include "CounterCodec.h"
+#include "GCounter_Cfg.h"
+#include "GCounter.h"
+#include "Heartbeat_Cfg.h"
+#include "Heartbeat.h"
+#include "ClockSync_Cfg.h"
+#include "ClockSync.h"
+#include "SYSTICK.h"
+#include "Rpc_Cfg.h"
+#include "Rpc.h"
+#include "FwUpdate_Cfg.h"
+#include "FwUpdate.h"
+#include "Persist_Cfg.h"
+#include "Persist.h"
 #include "Clcd.h"
 #include "Switch_Cfg.h"
 #include "Switch.h"
 #include "Led_Cfg.h"
 #include "Led.h"
+#include "App_Cfg.h"
 #include "App.h"
+
+/* A press message carries the time of the first press of the batch, the slots
+ * follow the header of both kinds of messages */
+#define APP_MSG_PRESS         0x01
+#define APP_MSG_SYNC          0x02
+#define APP_PRESS_HEADER      5
+#define APP_SYNC_HEADER       1
+
+/* The presses not sent yet, the time of the first of them and the batch window in milli seconds */
+static u8 APP_batchOpen;
+static u32 APP_batchStart;
+static u16 APP_batchWindow = APP_BATCH_MIN_MS;
+
+/* The latency of the last press from the other board and its largest error */
+static u32 APP_pressLatency;
+static u32 APP_pressLatencyError;
+static u8 APP_pressLatencyValid;
+
+/* The total waits to be shown while the LCD is busy */
+static u8 APP_totalPending;
+
+/* The link status line waits here while the LCD is busy */
+static u8 APP_statusPending;
+static char APP_status[17];
+
+/**
+ * @brief Appends a number to a string
+ * 
+ * @param str the string
+ * @param index where to write the number, it is moved past it
+ * @param value the number
+ */
+static void APP_appendNumber(char* str, u8* index, u32 value)
+{
+  char digits[11];
+  u8 i = 0;
+  itoa(value, digits, 10);
+  while (digits[i])
+  {
+    str[(*index)++] = digits[i++];
+  }
+}
+
+/**
+ * @brief Prepares the second LCD line with the link quality, the average RTT and
+ * the loss, or PEER LOST when the other board is not heard any more
+ * 
+ */
+static void APP_updateStatus(void)
+{
+  heartbeatStats_t stats;
+  u8 index = 0;
+  const char* text;
+  Heartbeat_GetStats(&stats);
+  if (!stats.peerAlive)
+  {
+    for (text = "PEER LOST"; *text; text++)
+    {
+      APP_status[index++] = *text;
+    }
+  }
+  else
+  {
+    for (text = "RTT "; *text; text++)
+    {
+      APP_status[index++] = *text;
+    }
+    APP_appendNumber(APP_status, &index, stats.rttAvgUs / 1000);
+    for (text = "ms L"; *text; text++)
+    {
+      APP_status[index++] = *text;
+    }
+    APP_appendNumber(APP_status, &index, stats.lossPercent);
+    APP_status[index++] = '%';
+  }
+  /* Blank the rest of the line so a shorter text does not leave old characters */
+  while (index < 16)
+  {
+    APP_status[index++] = ' ';
+  }
+  APP_status[index] = '\0';
+  APP_statusPending = 1;
+}
+
 /**
- * @brief This is the frame type of size 4 byte
+ * @brief Checks if the presses gathered so far have to be sent now, they are sent
+ * right away while the link is idle and after the batch window while it is busy
  * 
+ * @return u8 1 if the batch is due and 0 if not
  */
-typedef union
+static u8 APP_batchDue(void)
 {
-    uint8_t data[4];
-    uint32_t fullFrame;
-}frame_t;
+  uint8_t pending = 0;
+  Link_GetPending(&pending);
+  return APP_BATCHING == STD_OFF || pending == 0 ||
+         SYSTICK_getMicros() - APP_batchStart >= (u32)APP_batchWindow * 1000;
+}
 
-frame_t recFrame, sendFrame;
+/**
+ * @brief Widens the batch window while messages pile up in the link and narrows
+ * it back once they drain, so the link load stays bounded whatever the press rate
+ * 
+ */
+static void APP_batchAdapt(void)
+{
+  uint8_t pending = 0;
+  Link_GetPending(&pending);
+  if (pending >= LINK_WINDOW_SIZE / 2)
+  {
+    APP_batchWindow = APP_batchWindow * 2 > APP_BATCH_MAX_MS ? APP_BATCH_MAX_MS : APP_batchWindow * 2;
+  }
+  else if (pending <= 1)
+  {
+    APP_batchWindow = APP_batchWindow / 2 < APP_BATCH_MIN_MS ? APP_BATCH_MIN_MS : APP_batchWindow / 2;
+  }
+}
+
+/**
+ * @brief Shows the total count of all the nodes on the LCD
+ * 
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the LCD took the total
+ *                  E_NOT_OK: If the LCD is busy
+ */
+static Std_ReturnType APP_showTotal(void)
+{
+  char strBuffer[20];
+  uint32_t total;
+  GCounter_GetTotal(&total);
+  itoa(total, strBuffer, 10);
+  return CLcd_WriteString((uint8_t*)strBuffer, 0, 0);
+}
 
-static volatile u32 counter = 0;
+/**
+ * @brief Merges the slots received from another node, the press time is turned
+ * into local time to get the latency from the press to here
+ * 
+ * @param data the message
+ * @param length the length of the message
+ */
+static void APP_linkReceive(const uint8_t* data, uint16_t length)
+{
+  uint8_t changed = 0;
+  u32 pressTime = 0;
+  u32 localTime;
+  u8 i;
+  if (length > APP_PRESS_HEADER && data[0] == APP_MSG_PRESS)
+  {
+    for (i = 0; i < 4; i++)
+    {
+      pressTime |= (u32)data[1 + i] << (8 * i);
+    }
+    if (E_OK == ClockSync_PeerToLocal(pressTime, &localTime, &APP_pressLatencyError))
+    {
+      APP_pressLatency = SYSTICK_getMicros() - localTime;
+      APP_pressLatencyValid = 1;
+    }
+    GCounter_MergeDelta(&data[APP_PRESS_HEADER], length - APP_PRESS_HEADER, &changed);
+  }
+  else if (length > APP_SYNC_HEADER && data[0] == APP_MSG_SYNC)
+  {
+    GCounter_MergeSync(&data[APP_SYNC_HEADER], length - APP_SYNC_HEADER, &changed);
+  }
+  else if (length && data[0] == RPC_MSG_REQUEST)
+  {
+    /* Run later by Rpc_Task, not from the link */
+    Rpc_Receive(data, length);
+  }
+  else if (length && data[0] == FWUPDATE_MSG_REQUEST)
+  {
+    FwUpdate_Receive(data, length);
+  }
+  if (changed)
+  {
+    APP_receiveFcn();
+  }
+}
 
 /**
  * @brief This is the initialization for the two counter application
@@ -45,31 +225,93 @@ Std_ReturnType APP_init(void)
   Led_Init();
   Switch_Init();
   error |= CLcd_Init(CLCD_TWO_LINES, CLCD_CURSOR_OFF, CLCD_BLINKING_OFF);
-  HUart_Init();
-  HUart_SetRxCb(APP_receiveFcn);
-  error |= HUart_Receive(recFrame.data, 4);
+  error |= Transport_Init();
+  error |= Link_Init();
+  error |= Link_SetRxCb(APP_linkReceive);
+  error |= GCounter_Init();
+  error |= Persist_Init();
+  APP_totalPending = 1;
+  error |= Heartbeat_Init();
+  error |= ClockSync_Init();
+  error |= Rpc_Init();
+  error |= FwUpdate_Init();
   return error;
 }
 
 /**
- * @brief The free running task that comes every 1 milli second
+ * @brief The free running task that comes every APP_TASK_PERIOD_MS milli seconds
  * 
  */
 void APP_sendTask(void)
 {
   static u8 prevSwitchStat = SWITCH_NOT_PRESSED;
   static u8 currentSwitchState = SWITCH_NOT_PRESSED;
+  static u32 syncStart = 0;
+  uint8_t message[LINK_MAX_PAYLOAD];
+  uint16_t messageLength;
+  uint32_t sentMask;
+  u8 i;
 
   Switch_GetSwitchStatus(SWITCH_1, &currentSwitchState);
 
   if (currentSwitchState == SWITCH_PRESSED && prevSwitchStat == SWITCH_NOT_PRESSED)
   {
-    counter++;
+    GCounter_Increment();
+    if (E_OK != APP_showTotal())
+    {
+      APP_totalPending = 1;
+    }
+    if (!APP_batchOpen)
+    {
+      APP_batchOpen = 1;
+      APP_batchStart = SYSTICK_getMicros();
+    }
     prevSwitchStat = SWITCH_PRESSED;
-    sendFrame.fullFrame = counter;
-    HUart_Send(sendFrame.data, 4);
   }
    prevSwitchStat = currentSwitchState;
+
+  if (APP_batchOpen)
+  {
+    /* The slot holds the count so all the presses of a batch go in one update,
+     * a batch the link refused stays open and is sent with the next run */
+    message[0] = APP_MSG_PRESS;
+    for (i = 0; i < 4; i++)
+    {
+      message[1 + i] = (uint8_t)(APP_batchStart >> (8 * i));
+    }
+    if (APP_batchDue() &&
+        E_OK == GCounter_BuildDelta(&message[APP_PRESS_HEADER], sizeof(message) - APP_PRESS_HEADER, &messageLength, &sentMask) &&
+        (messageLength == 0 || E_OK == Link_Send(message, APP_PRESS_HEADER + messageLength)))
+    {
+      GCounter_CommitDelta(sentMask);
+      APP_batchOpen = 0;
+      APP_batchAdapt();
+    }
+  }
+
+  if (SYSTICK_getMicros() - syncStart >= (u32)APP_SYNC_PERIOD_MS * 1000)
+  {
+    syncStart = SYSTICK_getMicros();
+    APP_updateStatus();
+    /* A refused sync message is fine, the next one covers it, the delta streams
+     * are only restarted from the values the link took */
+    message[0] = APP_MSG_SYNC;
+    if (E_OK == GCounter_BuildSync(&message[APP_SYNC_HEADER], sizeof(message) - APP_SYNC_HEADER, &messageLength, &sentMask) &&
+        messageLength && E_OK == Link_Send(message, APP_SYNC_HEADER + messageLength))
+    {
+      GCounter_CommitSync(sentMask);
+    }
+  }
+
+  if (APP_totalPending && E_OK == APP_showTotal())
+  {
+    APP_totalPending = 0;
+  }
+
+  if (APP_statusPending && E_OK == CLcd_WriteString((uint8_t*)APP_status, 0, 1))
+  {
+    APP_statusPending = 0;
+  }
 }
 
 
@@ -80,16 +322,34 @@ void APP_sendTask(void)
  */
 void APP_receiveFcn(void)
 {
-  char strBuffer[20];
-
   /* Toggle Led */
   static u8 ledStat = LED_ON;
   ledStat = !ledStat;
   
   Led_SetLedStatus(LED_1, ledStat);
   
-  /* Display on LCD */
-  itoa(recFrame.fullFrame, strBuffer, 10);
-  CLcd_WriteString((uint8_t*)strBuffer, 0, 0);
-  HUart_Receive(recFrame.data, 4);
+  /* Display on LCD, a busy LCD gets the total on the next send task */
+  if (E_OK != APP_showTotal())
+  {
+    APP_totalPending = 1;
+  }
+}
+
+/**
+ * @brief Gets the latency of the last press received from the other board, from
+ * the press to its arrival here, measured on the synchronized clocks
+ *  @returns: A status
+ *                 E_OK : if the function is executed correctly
+ *                 E_NOT_OK : if no press came yet or the clocks are not synchronized
+ */
+Std_ReturnType APP_getPressLatency(u32* latencyUs, u32* errorUs)
+{
+  Std_ReturnType error = E_NOT_OK;
+  if (latencyUs && errorUs && APP_pressLatencyValid)
+  {
+    *latencyUs = APP_pressLatency;
+    *errorUs = APP_pressLatencyError;
+    error = E_OK;
+  }
+  return error;
 }
@@ -0,0 +1,137 @@
+/**
+ * @file Boot.c
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief This is the implementation for the boot loader
+ * @version 0.1
+ * @date 2020-04-20
+ * 
+ * @copyright Copyright (c) 2020
+ * 
+ */
+#include "Std_Types.h"
+#include "Frame_Cfg.h"
+#include "Frame.h"
+#include "Flash_Cfg.h"
+#include "Flash.h"
+#include "FwUpdate_Cfg.h"
+#include "FwUpdate.h"
+#include "Boot.h"
+
+#define BOOT_CRC_INIT                0xFFFF
+
+/* The vector table offset register */
+#define BOOT_VTOR                    (*(volatile uint32_t*)0xE000ED08)
+
+/* The stack of an application is in the RAM */
+#define BOOT_RAM_MASK                0xFFF00000
+#define BOOT_RAM_ADDRESS             0x20000000
+
+#define BOOT_META                    ((const volatile uint16_t*)FWUPDATE_META_ADDRESS)
+
+static Std_ReturnType Boot_result;
+
+/**
+ * @brief Called by the flash driver when a job ends
+ * 
+ * @param result the result of the job
+ */
+static void Boot_FlashDone(Std_ReturnType result)
+{
+    Boot_result = result;
+}
+
+/**
+ * @brief Runs the flash job started until it ends, nothing else runs in the boot loader
+ * 
+ * @param error the result of starting the job
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the job ended well
+ *                  E_NOT_OK: If it did not start or the flash reported an error
+ */
+static Std_ReturnType Boot_Wait(Std_ReturnType error)
+{
+    uint8_t busy = 1;
+    if(E_OK == error)
+    {
+        while(busy)
+        {
+            Flash_Task();
+            Flash_IsBusy(&busy);
+        }
+        error = Boot_result;
+    }
+    return error;
+}
+
+/**
+ * @brief Copies the download slot over the application and checks the copy
+ * 
+ * @param size the size of the image
+ * @param crc the CRC of the image
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the image is installed
+ *                  E_NOT_OK: If the flash reported an error or the copy is not right
+ */
+static Std_ReturnType Boot_Install(uint32_t size, uint16_t crc)
+{
+    Std_ReturnType error;
+    uint32_t offset;
+    uint16_t length;
+    error = Boot_Wait(Flash_Erase(FWUPDATE_APP_ADDRESS, FWUPDATE_SLOT_SIZE / FLASH_PAGE_SIZE, Boot_FlashDone));
+    for(offset = 0; offset < size && E_OK == error; offset += length)
+    {
+        length = size - offset < FLASH_PAGE_SIZE ? (uint16_t)(size - offset) : FLASH_PAGE_SIZE;
+        error = Boot_Wait(Flash_Write(FWUPDATE_APP_ADDRESS + offset, (const uint8_t*)(FWUPDATE_DOWNLOAD_ADDRESS + offset),
+                                        length, Boot_FlashDone));
+    }
+    if(E_OK == error && crc != Frame_Crc16((const uint8_t*)FWUPDATE_APP_ADDRESS, (uint16_t)size, BOOT_CRC_INIT))
+    {
+        error = E_NOT_OK;
+    }
+    return error;
+}
+
+/**
+ * @brief Starts the application, it does not return
+ * 
+ */
+static void Boot_Jump(void)
+{
+    uint32_t stack = *(const volatile uint32_t*)FWUPDATE_APP_ADDRESS;
+    void (*reset)(void) = (void (*)(void))(*(const volatile uint32_t*)(FWUPDATE_APP_ADDRESS + 4));
+    BOOT_VTOR = FWUPDATE_APP_ADDRESS;
+    asm("MSR MSP, %0"
+        :
+        : "r" (stack));
+    reset();
+}
+
+/**
+ * @brief Installs the downloaded image if there is a checked one and jumps to the
+ * application, it is the only thing the main of the boot loader calls
+ * 
+ * @return Std_ReturnType A Status
+ *                  E_NOT_OK: If there is no valid application to jump to
+ */
+Std_ReturnType Boot_Run(void)
+{
+    uint32_t size = BOOT_META[FWUPDATE_META_SIZE_INDEX] | ((uint32_t)BOOT_META[FWUPDATE_META_SIZE_INDEX + 1] << 16);
+    uint16_t crc = BOOT_META[FWUPDATE_META_CRC_INDEX];
+    /* The image is checked again, the state page could be left from a broken update */
+    if(BOOT_META[FWUPDATE_META_MAGIC_INDEX] == FWUPDATE_META_MAGIC &&
+        BOOT_META[FWUPDATE_META_STATE_INDEX] == FWUPDATE_META_READY &&
+        size && size <= FWUPDATE_SLOT_SIZE &&
+        crc == Frame_Crc16((const uint8_t*)FWUPDATE_DOWNLOAD_ADDRESS, (uint16_t)size, BOOT_CRC_INIT))
+    {
+        /* The state page is erased only once the copy is right, a reset in between copies again */
+        if(E_OK == Boot_Install(size, crc))
+        {
+            Boot_Wait(Flash_Erase(FWUPDATE_META_ADDRESS, 1, Boot_FlashDone));
+        }
+    }
+    if(BOOT_RAM_ADDRESS == (*(const volatile uint32_t*)FWUPDATE_APP_ADDRESS & BOOT_RAM_MASK))
+    {
+        Boot_Jump();
+    }
+    return E_NOT_OK;
+}
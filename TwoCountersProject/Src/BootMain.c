@@ -0,0 +1,20 @@
+/**
+ * @file BootMain.c
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief This is the main function of the boot loader, it is linked at the start of the
+ * flash on its own (Build/Boot.ld) and the application after it at FWUPDATE_APP_ADDRESS
+ * @version 0.1
+ * @date 2020-04-20
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include "Std_Types.h"
+#include "Boot.h"
+
+void main(void)
+{
+    Boot_Run();
+    /* No application to start, one has to be flashed with a debugger */
+    while(1);
+}
@@ -76,6 +76,26 @@ extern const clcd_t CLcd_clcd;
 
 volatile static lcdCb_t appNotify = NULL;
 
+/* The requests taken and the ones turned away because the LCD was busy */
+volatile static uint32_t CLcd_accepted;
+volatile static uint32_t CLcd_rejected;
+
+/**
+ * @brief Counts a request for the LCD status
+ * 
+ * @param error the result of the request
+ */
+static void CLcd_CountRequest(Std_ReturnType error)
+{
+	if(E_OK == error)
+	{
+		CLcd_accepted++;
+	}
+	else
+	{
+		CLcd_rejected++;
+	}
+}
 /**
  * @brief The Character LCD initialization
  * 
@@ -157,6 +177,7 @@ Std_ReturnType CLcd_WriteString(uint8_t* str, uint8_t x, uint8_t y)
 		CLcd_process = write_p;
 		error = E_OK;
 	}
+	CLcd_CountRequest(error);
 	return error;
 }
 /**
@@ -174,6 +195,7 @@ Std_ReturnType CLcd_ClearDisplay(void)
 		CLcd_process = clear_p;
 		error = E_OK;
 	}
+	CLcd_CountRequest(error);
 	return error;
 }
 /**
@@ -196,6 +218,7 @@ Std_ReturnType CLcd_GotoXY(uint8_t x, uint8_t y)
 		CLcd_process = goto_p;
 		error = E_OK;
 	}
+	CLcd_CountRequest(error);
 	return error;
 }
 /**
@@ -220,6 +243,7 @@ Std_ReturnType CLcd_ConfigCursor(uint8_t cursor, uint8_t blink)
 		CLcd_configDisplay = CLCD_DISP_SETTING | CLCD_DISP_ON | cursor | blink;
 		error = E_OK;
 	}
+	CLcd_CountRequest(error);
 	return error;
 }
 /**
@@ -242,8 +266,42 @@ Std_ReturnType CLcd_ConfigDisplay(uint8_t disp)
 		CLcd_configDisplay |= disp;
 		error = E_OK;
 	}
+	CLcd_CountRequest(error);
 	return error;
 }
+/**
+ * @brief Gets the status of the LCD
+ * 
+ * @param status where to copy the status
+ * @return Std_ReturnType 
+ * 				E_OK : If executed successfully
+ * 				E_NOT_OK : If it failed to execute
+ */
+Std_ReturnType CLcd_GetStatus(clcdStatus_t* status)
+{
+	Std_ReturnType error = E_NOT_OK;
+	if(status)
+	{
+		status->busy = idle_p != CLcd_process;
+		status->accepted = CLcd_accepted;
+		status->rejected = CLcd_rejected;
+		error = E_OK;
+	}
+	return error;
+}
+/**
+ * @brief Clears the request counters of the LCD
+ * 
+ * @return Std_ReturnType 
+ * 				E_OK : If executed successfully
+ * 				E_NOT_OK : If it failed to execute
+ */
+Std_ReturnType CLcd_ResetStatus(void)
+{
+	CLcd_accepted = 0;
+	CLcd_rejected = 0;
+	return E_OK;
+}
 /**
  * @brief writes 4-bit data into the lcd
  * 
@@ -0,0 +1,189 @@
+/**
+ * @file ClockSync.c
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief This is the implementation for the clock synchronization
+ * @version 0.1
+ * @date 2020-04-18
+ * 
+ * @copyright Copyright (c) 2020
+ * 
+ */
+#include "Std_Types.h"
+#include "SYSTICK.h"
+#include "Heartbeat_Cfg.h"
+#include "Heartbeat.h"
+#include "ClockSync_Cfg.h"
+#include "ClockSync.h"
+
+/* The drift is kept as a Q8.24 fraction of the elapsed time */
+#define CLOCKSYNC_DRIFT_SHIFT        24
+
+typedef struct
+{
+    /* The local time in the middle of the exchange */
+    uint32_t localTime;
+    sint32_t offset;
+    uint32_t delay;
+}clockSyncSample_t;
+
+static clockSyncSample_t ClockSync_filter[CLOCKSYNC_FILTER_SIZE];
+static uint8_t ClockSync_filterIndex;
+static uint8_t ClockSync_filterCount;
+
+/* The sample the conversions start from and the one the drift was last measured from */
+static clockSyncSample_t ClockSync_reference;
+static clockSyncSample_t ClockSync_anchor;
+static sint32_t ClockSync_drift;
+
+static clockSyncState_t ClockSync_state;
+
+/**
+ * @brief Gets the offset at a local time, moved from the reference by the drift
+ * 
+ * @param localTime the local time
+ * @return sint32_t The offset in micro seconds
+ */
+static sint32_t ClockSync_OffsetAt(uint32_t localTime)
+{
+    sint32_t elapsed = (sint32_t)(localTime - ClockSync_reference.localTime);
+    return ClockSync_reference.offset + (sint32_t)(((sint64_t)ClockSync_drift * elapsed) >> CLOCKSYNC_DRIFT_SHIFT);
+}
+
+/**
+ * @brief Measures the drift between the anchor and a new reference
+ * 
+ * @param sample the new reference
+ */
+static void ClockSync_UpdateDrift(const clockSyncSample_t* sample)
+{
+    sint32_t span = (sint32_t)(sample->localTime - ClockSync_anchor.localTime);
+    sint32_t measured;
+    if(span >= CLOCKSYNC_MIN_DRIFT_SPAN_US)
+    {
+        measured = (sint32_t)(((sint64_t)(sample->offset - ClockSync_anchor.offset) << CLOCKSYNC_DRIFT_SHIFT) / span);
+        if(ClockSync_state.driftValid)
+        {
+            /* Smoothed so one bad pair of references can't throw it off */
+            ClockSync_drift += (measured - ClockSync_drift) / 4;
+        }
+        else
+        {
+            ClockSync_drift = measured;
+            ClockSync_state.driftValid = 1;
+        }
+        ClockSync_anchor = *sample;
+        ClockSync_state.driftPpb = (sint32_t)(((sint64_t)ClockSync_drift * 1000000000) >> CLOCKSYNC_DRIFT_SHIFT);
+    }
+}
+
+/**
+ * @brief Initializes the clock synchronization, the heartbeat has to be initialized first
+ * 
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+Std_ReturnType ClockSync_Init(void)
+{
+    clockSyncState_t emptyState = {0};
+    ClockSync_filterIndex = 0;
+    ClockSync_filterCount = 0;
+    ClockSync_drift = 0;
+    ClockSync_state = emptyState;
+    return Heartbeat_SetSampleCb(ClockSync_AddSample);
+}
+
+/**
+ * @brief Adds an exchange with the peer, the peer has to answer right away
+ * 
+ * @param sentAt the local time the request was sent
+ * @param peerTime the peer time it was answered at
+ * @param receivedAt the local time the answer came
+ */
+void ClockSync_AddSample(uint32_t sentAt, uint32_t peerTime, uint32_t receivedAt)
+{
+    clockSyncSample_t* sample = &ClockSync_filter[ClockSync_filterIndex];
+    clockSyncSample_t* best;
+    uint8_t i;
+    /* The answer is taken to be half way, so the error is at most half the delay */
+    sample->delay = receivedAt - sentAt;
+    sample->localTime = sentAt + sample->delay / 2;
+    sample->offset = (sint32_t)(peerTime - sample->localTime);
+    ClockSync_filterIndex = (ClockSync_filterIndex + 1) % CLOCKSYNC_FILTER_SIZE;
+    if(ClockSync_filterCount < CLOCKSYNC_FILTER_SIZE)
+    {
+        ClockSync_filterCount++;
+    }
+    ClockSync_state.samples++;
+
+    /* The exchange that waited least in queues has the least asymmetry */
+    best = &ClockSync_filter[0];
+    for(i = 1; i < ClockSync_filterCount; i++)
+    {
+        if(ClockSync_filter[i].delay < best->delay)
+        {
+            best = &ClockSync_filter[i];
+        }
+    }
+    if(!ClockSync_state.synced)
+    {
+        ClockSync_anchor = *best;
+        ClockSync_state.synced = 1;
+    }
+    else if(best->localTime != ClockSync_reference.localTime)
+    {
+        ClockSync_UpdateDrift(best);
+    }
+    ClockSync_reference = *best;
+    ClockSync_state.offsetUs = best->offset;
+    ClockSync_state.delayUs = best->delay;
+}
+
+/**
+ * @brief Turns a peer time into local time
+ * 
+ * @param peerTime the peer time in micro seconds
+ * @param localTime where to put the local time
+ * @param errorUs where to put the largest error of the result, can be NULL
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If there is no sample yet
+ */
+Std_ReturnType ClockSync_PeerToLocal(uint32_t peerTime, uint32_t* localTime, uint32_t* errorUs)
+{
+    Std_ReturnType error = E_NOT_OK;
+    uint32_t age;
+    if(localTime && ClockSync_state.synced)
+    {
+        /* The offset at the peer time is close enough to the one at the local time */
+        *localTime = peerTime - ClockSync_reference.offset;
+        *localTime = peerTime - ClockSync_OffsetAt(*localTime);
+        if(errorUs)
+        {
+            age = (uint32_t)(SYSTICK_getMicros() - ClockSync_reference.localTime);
+            *errorUs = ClockSync_reference.delay / 2 + age / 1000000 *
+                        (ClockSync_state.driftValid ? CLOCKSYNC_DRIFT_ERROR_PPM : CLOCKSYNC_MAX_DRIFT_PPM);
+        }
+        error = E_OK;
+    }
+    return error;
+}
+
+/**
+ * @brief Gets the state of the estimator
+ * 
+ * @param state where to copy the state
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+Std_ReturnType ClockSync_GetState(clockSyncState_t* state)
+{
+    Std_ReturnType error = E_NOT_OK;
+    if(state)
+    {
+        *state = ClockSync_state;
+        error = E_OK;
+    }
+    return error;
+}
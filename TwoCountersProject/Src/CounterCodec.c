@@ -0,0 +1,308 @@
+/**
+ * @file CounterCodec.c
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief This is the implementation for the counter codec
+ * @version 0.1
+ * @date 2020-04-15
+ * 
+ * @copyright Copyright (c) 2020
+ * 
+ */
+#include "Std_Types.h"
+#include "CounterCodec_Cfg.h"
+#include "CounterCodec.h"
+
+/* A record starts with a varint, a delta has bit 0 cleared and the zig-zag delta
+ * above it, a snapshot is the tag alone followed by the value as a varint */
+#define COUNTER_CODEC_SNAPSHOT_TAG   0x01
+
+#define COUNTER_CODEC_VARINT_MORE    0x80
+#define COUNTER_CODEC_VARINT_BITS    0x7F
+
+/* The largest delta that still fits next to the record type bit */
+#define COUNTER_CODEC_MAX_DELTA      0x3FFFFFFF
+
+#define COUNTER_CODEC_ZIGZAG(delta)  (((uint32_t)(delta) << 1) ^ (uint32_t)((delta) >> 31))
+#define COUNTER_CODEC_UNZIGZAG(code) ((sint32_t)((code) >> 1) ^ -(sint32_t)((code) & 1))
+
+/**
+ * @brief Checks if the next update has to be a snapshot
+ * 
+ * @param encoder the encoder
+ * @param delta the difference from the reference
+ * @return uint8_t 1 for a snapshot and 0 for a delta
+ */
+static uint8_t CounterCodec_NeedsSnapshot(const counterEncoder_t* encoder, sint32_t delta)
+{
+    return !encoder->started || encoder->sinceSnapshot >= COUNTER_CODEC_SNAPSHOT_PERIOD - 1 ||
+            delta > COUNTER_CODEC_MAX_DELTA || delta < -COUNTER_CODEC_MAX_DELTA;
+}
+
+/**
+ * @brief Initializes an encoder, the first update it encodes is a snapshot
+ * 
+ * @param encoder the encoder
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+Std_ReturnType CounterCodec_InitEncoder(counterEncoder_t* encoder)
+{
+    Std_ReturnType error = E_NOT_OK;
+    if(encoder)
+    {
+        encoder->reference = 0;
+        encoder->sinceSnapshot = 0;
+        encoder->started = 0;
+        error = E_OK;
+    }
+    return error;
+}
+
+/**
+ * @brief Encodes a counter value as one record, the encoder is not changed until
+ * the record is committed so a record the link refused can be encoded again
+ * 
+ * @param encoder the encoder
+ * @param value the counter value
+ * @param buffer where to put the record
+ * @param bufferSize the size of the buffer, COUNTER_CODEC_MAX_RECORD is always enough
+ * @param length where to put the length of the record
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the buffer is too small
+ */
+Std_ReturnType CounterCodec_Encode(const counterEncoder_t* encoder, uint32_t value, uint8_t* buffer, uint16_t bufferSize, uint16_t* length)
+{
+    Std_ReturnType error = E_NOT_OK;
+    uint8_t record[COUNTER_CODEC_MAX_RECORD];
+    uint16_t recordLength;
+    uint16_t i;
+    sint32_t delta;
+    if(encoder && buffer && length)
+    {
+        /* The counter wraps so the difference is taken modulo 2^32 */
+        delta = (sint32_t)(value - encoder->reference);
+        if(CounterCodec_NeedsSnapshot(encoder, delta))
+        {
+            record[0] = COUNTER_CODEC_SNAPSHOT_TAG;
+            recordLength = 1 + CounterCodec_PutVarint(value, &record[1]);
+        }
+        else
+        {
+            recordLength = CounterCodec_PutVarint(COUNTER_CODEC_ZIGZAG(delta) << 1, record);
+        }
+        if(recordLength <= bufferSize)
+        {
+            for(i = 0; i < recordLength; i++)
+            {
+                buffer[i] = record[i];
+            }
+            *length = recordLength;
+            error = E_OK;
+        }
+    }
+    return error;
+}
+
+/**
+ * @brief Commits a value after its record was accepted by the link, the following
+ * deltas are taken from it
+ * 
+ * @param encoder the encoder
+ * @param value the counter value that was encoded
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+Std_ReturnType CounterCodec_Commit(counterEncoder_t* encoder, uint32_t value)
+{
+    Std_ReturnType error = E_NOT_OK;
+    if(encoder)
+    {
+        if(CounterCodec_NeedsSnapshot(encoder, (sint32_t)(value - encoder->reference)))
+        {
+            encoder->sinceSnapshot = 0;
+            encoder->started = 1;
+        }
+        else
+        {
+            encoder->sinceSnapshot++;
+        }
+        encoder->reference = value;
+        error = E_OK;
+    }
+    return error;
+}
+
+/**
+ * @brief Takes the deltas from a value the receiver got in full some other way,
+ * it counts as a snapshot
+ * 
+ * @param encoder the encoder
+ * @param value the value the receiver has now
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+Std_ReturnType CounterCodec_Rebase(counterEncoder_t* encoder, uint32_t value)
+{
+    Std_ReturnType error = E_NOT_OK;
+    if(encoder)
+    {
+        encoder->reference = value;
+        encoder->sinceSnapshot = 0;
+        encoder->started = 1;
+        error = E_OK;
+    }
+    return error;
+}
+
+/**
+ * @brief Initializes a decoder
+ * 
+ * @param decoder the decoder
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+Std_ReturnType CounterCodec_InitDecoder(counterDecoder_t* decoder)
+{
+    Std_ReturnType error = E_NOT_OK;
+    if(decoder)
+    {
+        decoder->value = 0;
+        decoder->synced = 0;
+        decoder->snapshots = 0;
+        decoder->deltas = 0;
+        decoder->errors = 0;
+        error = E_OK;
+    }
+    return error;
+}
+
+/**
+ * @brief Decodes one record, the result is in decoder->value while decoder->synced is set
+ * 
+ * @param decoder the decoder
+ * @param data the message
+ * @param length the length of the message
+ * @param index the index of the record, it is moved past it
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the record is read, a delta before the first snapshot is dropped
+ *                  E_NOT_OK: If the record is cut or corrupted
+ */
+Std_ReturnType CounterCodec_Decode(counterDecoder_t* decoder, const uint8_t* data, uint16_t length, uint16_t* index)
+{
+    Std_ReturnType error = E_NOT_OK;
+    uint32_t code;
+    uint32_t value;
+    if(decoder && data && index)
+    {
+        error = CounterCodec_GetVarint(data, length, index, &code);
+        if(error != E_OK)
+        {
+            /* Cut or corrupted, nothing after it can be trusted */
+        }
+        else if(code == COUNTER_CODEC_SNAPSHOT_TAG)
+        {
+            error = CounterCodec_GetVarint(data, length, index, &value);
+            if(error == E_OK)
+            {
+                decoder->value = value;
+                decoder->synced = 1;
+                decoder->snapshots++;
+            }
+        }
+        else if(code & COUNTER_CODEC_SNAPSHOT_TAG)
+        {
+            error = E_NOT_OK;
+        }
+        else if(decoder->synced)
+        {
+            decoder->value += (uint32_t)COUNTER_CODEC_UNZIGZAG(code >> 1);
+            decoder->deltas++;
+        }
+        else
+        {
+            /* The base of the delta is not known yet, the next snapshot or sync brings it */
+            decoder->errors++;
+        }
+        if(error != E_OK)
+        {
+            decoder->errors++;
+        }
+    }
+    return error;
+}
+
+/**
+ * @brief Takes a value the sender sent in full some other way, the next deltas
+ * are added to it
+ * 
+ * @param decoder the decoder
+ * @param value the value from the sender
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+Std_ReturnType CounterCodec_Resync(counterDecoder_t* decoder, uint32_t value)
+{
+    Std_ReturnType error = E_NOT_OK;
+    if(decoder)
+    {
+        decoder->value = value;
+        decoder->synced = 1;
+        error = E_OK;
+    }
+    return error;
+}
+
+/**
+ * @brief Writes a varint
+ * 
+ * @param value the value
+ * @param buffer where to write it, at least COUNTER_CODEC_VARINT_MAX bytes
+ * @return uint16_t The number of bytes written
+ */
+uint16_t CounterCodec_PutVarint(uint32_t value, uint8_t* buffer)
+{
+    uint16_t length = 0;
+    while(value > COUNTER_CODEC_VARINT_BITS)
+    {
+        buffer[length] = (uint8_t)(value & COUNTER_CODEC_VARINT_BITS) | COUNTER_CODEC_VARINT_MORE;
+        value >>= 7;
+        length++;
+    }
+    buffer[length] = (uint8_t)value;
+    return length + 1;
+}
+
+/**
+ * @brief Reads a varint
+ * 
+ * @param data the message
+ * @param length the length of the message
+ * @param index the index of the varint, it is moved past it
+ * @param value where to put the value
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the varint is cut or too long
+ */
+Std_ReturnType CounterCodec_GetVarint(const uint8_t* data, uint16_t length, uint16_t* index, uint32_t* value)
+{
+    Std_ReturnType error = E_NOT_OK;
+    uint8_t i;
+    *value = 0;
+    for(i = 0; i < COUNTER_CODEC_VARINT_MAX && *index < length; i++)
+    {
+        *value |= (uint32_t)(data[*index] & COUNTER_CODEC_VARINT_BITS) << (7 * i);
+        (*index)++;
+        if(!(data[*index - 1] & COUNTER_CODEC_VARINT_MORE))
+        {
+            error = E_OK;
+            break;
+        }
+    }
+    return error;
+}
@@ -0,0 +1,337 @@
+/**
+ * @file Flash.c
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief This is the implementation for the flash driver
+ * @version 0.1
+ * @date 2020-04-20
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include "Std_Types.h"
+#include "Flash_Cfg.h"
+#include "Flash.h"
+
+typedef struct 
+{
+  uint32_t ACR;
+  uint32_t KEYR;
+  uint32_t OPTKEYR;
+  uint32_t SR;
+  uint32_t CR;
+  uint32_t AR;
+  uint32_t RESERVED;
+  uint32_t OBR;
+  uint32_t WRPR;
+} flash_t;
+
+#define FLASH_REGISTERS ((volatile flash_t*)0x40022000)
+
+#define FLASH_KEY1 0x45670123
+#define FLASH_KEY2 0xCDEF89AB
+
+/*Busy*/
+#define FLASH_BSY_GET 0x00000001
+/*Programming error, write protection error and end of operation (cleared by writing 1)*/
+#define FLASH_PGERR_GET 0x00000004
+#define FLASH_WRPRTERR_GET 0x00000010
+#define FLASH_EOP_GET 0x00000020
+
+/*Programming, page erase, start and lock*/
+#define FLASH_PG_SET 0x00000001
+#define FLASH_PER_SET 0x00000002
+#define FLASH_STRT_SET 0x00000040
+#define FLASH_LOCK_SET 0x00000080
+#define FLASH_PG_PER_CLR 0xFFFFFFFC
+
+#define FLASH_JOB_IDLE 0
+#define FLASH_JOB_ERASE 1
+#define FLASH_JOB_WRITE 2
+
+typedef struct 
+{
+  uint8_t type;
+  /* The page being erased or the half word being written is started and waits for the controller */
+  uint8_t started;
+  uint32_t address;
+  const uint8_t *data;
+  /* Pages left to erase or bytes left to write */
+  uint16_t left;
+  flashDoneCb_t cb;
+} flashJob_t;
+
+static flashJob_t Flash_job;
+
+/**
+ * @brief Checks that a range is in the flash
+ * 
+ * @param address the start of the range
+ * @param length the length of the range in bytes
+ * @return uint8_t 1 if it is and 0 if not
+ */
+static uint8_t Flash_InRange(uint32_t address, uint32_t length)
+{
+  return address >= FLASH_BASE_ADDRESS && length <= FLASH_SIZE &&
+          address - FLASH_BASE_ADDRESS <= FLASH_SIZE - length;
+}
+
+/**
+ * @brief Unlocks the controller for a job
+ * 
+ */
+static void Flash_Unlock(void)
+{
+  if (FLASH_REGISTERS->CR & FLASH_LOCK_SET) 
+  {
+    FLASH_REGISTERS->KEYR = FLASH_KEY1;
+    FLASH_REGISTERS->KEYR = FLASH_KEY2;
+  }
+}
+
+/**
+ * @brief Reads and clears the result of the last operation
+ * 
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the operation succeeded
+ *                  E_NOT_OK: If the controller reported an error
+ */
+static Std_ReturnType Flash_Result(void)
+{
+  Std_ReturnType error = E_OK;
+  uint32_t status = FLASH_REGISTERS->SR;
+  if (status & (FLASH_PGERR_GET | FLASH_WRPRTERR_GET)) 
+  {
+    error = E_NOT_OK;
+  }
+  /* The flags are cleared by writing 1, only the ones that are set are written back */
+  FLASH_REGISTERS->SR = status & (FLASH_PGERR_GET | FLASH_WRPRTERR_GET | FLASH_EOP_GET);
+  return error;
+}
+
+/**
+ * @brief Ends the running job, locks the controller and calls the user
+ * 
+ * @param result the result of the job
+ */
+static void Flash_Finish(Std_ReturnType result)
+{
+  flashDoneCb_t cb = Flash_job.cb;
+  FLASH_REGISTERS->CR &= FLASH_PG_PER_CLR;
+  FLASH_REGISTERS->CR |= FLASH_LOCK_SET;
+  Flash_job.type = FLASH_JOB_IDLE;
+  if (cb) 
+  {
+    cb(result);
+  }
+}
+
+/**
+ * @brief Carries on an erase, the controller erases a page on its own and is
+ * polled until it is done
+ * 
+ */
+static void Flash_EraseStep(void)
+{
+  if (!Flash_job.started) 
+  {
+    FLASH_REGISTERS->CR |= FLASH_PER_SET;
+    FLASH_REGISTERS->AR = Flash_job.address;
+    FLASH_REGISTERS->CR |= FLASH_STRT_SET;
+    Flash_job.started = 1;
+  }
+  else if (!(FLASH_REGISTERS->SR & FLASH_BSY_GET)) 
+  {
+    Flash_job.started = 0;
+    if (E_OK != Flash_Result()) 
+    {
+      Flash_Finish(E_NOT_OK);
+    }
+    else 
+    {
+      Flash_job.address += FLASH_PAGE_SIZE;
+      Flash_job.left--;
+      if (0 == Flash_job.left) 
+      {
+        Flash_Finish(E_OK);
+      }
+    }
+  }
+}
+
+/**
+ * @brief Gets the half word the running write puts at its address
+ * 
+ * @return uint16_t the half word, an odd last byte is padded with 0xFF
+ */
+static uint16_t Flash_NextHalfWord(void)
+{
+  uint16_t halfWord = Flash_job.data[0];
+  halfWord |= (Flash_job.left > 1 ? Flash_job.data[1] : 0xFF) << 8;
+  return halfWord;
+}
+
+/**
+ * @brief Moves the running write past its half word and ends it after the last one
+ * 
+ */
+static void Flash_NextAddress(void)
+{
+  Flash_job.address += 2;
+  Flash_job.data += 2;
+  Flash_job.left = Flash_job.left > 1 ? Flash_job.left - 2 : 0;
+  if (0 == Flash_job.left) 
+  {
+    Flash_Finish(E_OK);
+  }
+}
+
+/**
+ * @brief Carries on a write, up to FLASH_HALFWORDS_PER_RUN half words each run, the
+ * controller is only waited for between them, the last one started is polled like
+ * an erase and checked in the next run
+ * 
+ */
+static void Flash_WriteStep(void)
+{
+  uint8_t count = 0;
+  uint16_t halfWord;
+  while (FLASH_JOB_WRITE == Flash_job.type) 
+  {
+    if (Flash_job.started) 
+    {
+      if (FLASH_REGISTERS->SR & FLASH_BSY_GET) 
+      {
+        if (count >= FLASH_HALFWORDS_PER_RUN) 
+        {
+          break;
+        }
+      }
+      else 
+      {
+        Flash_job.started = 0;
+        FLASH_REGISTERS->CR &= FLASH_PG_PER_CLR;
+        if (E_OK != Flash_Result() || Flash_NextHalfWord() != *(volatile uint16_t*)Flash_job.address) 
+        {
+          Flash_Finish(E_NOT_OK);
+        }
+        else 
+        {
+          Flash_NextAddress();
+        }
+      }
+    }
+    else if (count >= FLASH_HALFWORDS_PER_RUN) 
+    {
+      break;
+    }
+    else 
+    {
+      count++;
+      halfWord = Flash_NextHalfWord();
+      /* Half words already holding the value are skipped, writing them again is an error */
+      if (halfWord == *(volatile uint16_t*)Flash_job.address) 
+      {
+        Flash_NextAddress();
+      }
+      else 
+      {
+        FLASH_REGISTERS->CR |= FLASH_PG_SET;
+        *(volatile uint16_t*)Flash_job.address = halfWord;
+        Flash_job.started = 1;
+      }
+    }
+  }
+}
+
+/**
+ * @brief Starts erasing pages
+ * 
+ * @param address the address of the first page, aligned to FLASH_PAGE_SIZE
+ * @param pages the number of pages
+ * @param cb the function called when it is done, can be NULL
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the erase started
+ *                  E_NOT_OK: If the pages are not in the flash or a job is running
+ */
+Std_ReturnType Flash_Erase(uint32_t address, uint16_t pages, flashDoneCb_t cb)
+{
+  Std_ReturnType error = E_NOT_OK;
+  if (FLASH_JOB_IDLE == Flash_job.type && pages && 0 == (address % FLASH_PAGE_SIZE) &&
+      Flash_InRange(address, (uint32_t)pages * FLASH_PAGE_SIZE)) 
+  {
+    Flash_Unlock();
+    Flash_Result();
+    Flash_job.address = address;
+    Flash_job.left = pages;
+    Flash_job.started = 0;
+    Flash_job.cb = cb;
+    Flash_job.type = FLASH_JOB_ERASE;
+    error = E_OK;
+  }
+  return error;
+}
+
+/**
+ * @brief Starts writing erased flash, the data has to stay there until it is done
+ * 
+ * @param address the address to write at, aligned to 2
+ * @param data the data, an odd last byte is written with 0xFF after it
+ * @param length the length of the data in bytes
+ * @param cb the function called when it is done, can be NULL
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the write started
+ *                  E_NOT_OK: If the range is not in the flash or a job is running
+ */
+Std_ReturnType Flash_Write(uint32_t address, const uint8_t* data, uint16_t length, flashDoneCb_t cb)
+{
+  Std_ReturnType error = E_NOT_OK;
+  if (FLASH_JOB_IDLE == Flash_job.type && data && length && 0 == (address & 1) &&
+      Flash_InRange(address, length + (length & 1))) 
+  {
+    Flash_Unlock();
+    Flash_Result();
+    Flash_job.address = address;
+    Flash_job.data = data;
+    Flash_job.left = length;
+    Flash_job.started = 0;
+    Flash_job.cb = cb;
+    Flash_job.type = FLASH_JOB_WRITE;
+    error = E_OK;
+  }
+  return error;
+}
+
+/**
+ * @brief Checks if a job is running
+ * 
+ * @param busy where to put 1 if a job is running and 0 if not
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+Std_ReturnType Flash_IsBusy(uint8_t* busy)
+{
+  Std_ReturnType error = E_NOT_OK;
+  if (busy) 
+  {
+    *busy = FLASH_JOB_IDLE != Flash_job.type;
+    error = E_OK;
+  }
+  return error;
+}
+
+/**
+ * @brief The flash task, it carries on the running job, it comes every 1 milli second
+ * 
+ */
+void Flash_Task(void)
+{
+  if (FLASH_JOB_ERASE == Flash_job.type) 
+  {
+    Flash_EraseStep();
+  }
+  else if (FLASH_JOB_WRITE == Flash_job.type) 
+  {
+    Flash_WriteStep();
+  }
+}
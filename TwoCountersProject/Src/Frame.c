@@ -0,0 +1,261 @@
+/**
+ * @file Frame.c
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief This is the implementation for the framing layer
+ * @version 0.1
+ * @date 2020-04-12
+ * 
+ * @copyright Copyright (c) 2020
+ * 
+ */
+#include "Std_Types.h"
+#include "Frame_Cfg.h"
+#include "Frame.h"
+
+/* A COBS code byte covers up to 254 data bytes */
+#define FRAME_COBS_MAX_CODE          0xFF
+
+#define FRAME_CRC_INIT               0xFFFF
+
+/* The CRC-16/CCITT of every byte value */
+static const uint16_t Frame_crcTable[256] = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+    0x1231, 0x0210, 0x3273, 0x2252, 0x52B5, 0x4294, 0x72F7, 0x62D6,
+    0x9339, 0x8318, 0xB37B, 0xA35A, 0xD3BD, 0xC39C, 0xF3FF, 0xE3DE,
+    0x2462, 0x3443, 0x0420, 0x1401, 0x64E6, 0x74C7, 0x44A4, 0x5485,
+    0xA56A, 0xB54B, 0x8528, 0x9509, 0xE5EE, 0xF5CF, 0xC5AC, 0xD58D,
+    0x3653, 0x2672, 0x1611, 0x0630, 0x76D7, 0x66F6, 0x5695, 0x46B4,
+    0xB75B, 0xA77A, 0x9719, 0x8738, 0xF7DF, 0xE7FE, 0xD79D, 0xC7BC,
+    0x48C4, 0x58E5, 0x6886, 0x78A7, 0x0840, 0x1861, 0x2802, 0x3823,
+    0xC9CC, 0xD9ED, 0xE98E, 0xF9AF, 0x8948, 0x9969, 0xA90A, 0xB92B,
+    0x5AF5, 0x4AD4, 0x7AB7, 0x6A96, 0x1A71, 0x0A50, 0x3A33, 0x2A12,
+    0xDBFD, 0xCBDC, 0xFBBF, 0xEB9E, 0x9B79, 0x8B58, 0xBB3B, 0xAB1A,
+    0x6CA6, 0x7C87, 0x4CE4, 0x5CC5, 0x2C22, 0x3C03, 0x0C60, 0x1C41,
+    0xEDAE, 0xFD8F, 0xCDEC, 0xDDCD, 0xAD2A, 0xBD0B, 0x8D68, 0x9D49,
+    0x7E97, 0x6EB6, 0x5ED5, 0x4EF4, 0x3E13, 0x2E32, 0x1E51, 0x0E70,
+    0xFF9F, 0xEFBE, 0xDFDD, 0xCFFC, 0xBF1B, 0xAF3A, 0x9F59, 0x8F78,
+    0x9188, 0x81A9, 0xB1CA, 0xA1EB, 0xD10C, 0xC12D, 0xF14E, 0xE16F,
+    0x1080, 0x00A1, 0x30C2, 0x20E3, 0x5004, 0x4025, 0x7046, 0x6067,
+    0x83B9, 0x9398, 0xA3FB, 0xB3DA, 0xC33D, 0xD31C, 0xE37F, 0xF35E,
+    0x02B1, 0x1290, 0x22F3, 0x32D2, 0x4235, 0x5214, 0x6277, 0x7256,
+    0xB5EA, 0xA5CB, 0x95A8, 0x8589, 0xF56E, 0xE54F, 0xD52C, 0xC50D,
+    0x34E2, 0x24C3, 0x14A0, 0x0481, 0x7466, 0x6447, 0x5424, 0x4405,
+    0xA7DB, 0xB7FA, 0x8799, 0x97B8, 0xE75F, 0xF77E, 0xC71D, 0xD73C,
+    0x26D3, 0x36F2, 0x0691, 0x16B0, 0x6657, 0x7676, 0x4615, 0x5634,
+    0xD94C, 0xC96D, 0xF90E, 0xE92F, 0x99C8, 0x89E9, 0xB98A, 0xA9AB,
+    0x5844, 0x4865, 0x7806, 0x6827, 0x18C0, 0x08E1, 0x3882, 0x28A3,
+    0xCB7D, 0xDB5C, 0xEB3F, 0xFB1E, 0x8BF9, 0x9BD8, 0xABBB, 0xBB9A,
+    0x4A75, 0x5A54, 0x6A37, 0x7A16, 0x0AF1, 0x1AD0, 0x2AB3, 0x3A92,
+    0xFD2E, 0xED0F, 0xDD6C, 0xCD4D, 0xBDAA, 0xAD8B, 0x9DE8, 0x8DC9,
+    0x7C26, 0x6C07, 0x5C64, 0x4C45, 0x3CA2, 0x2C83, 0x1CE0, 0x0CC1,
+    0xEF1F, 0xFF3E, 0xCF5D, 0xDF7C, 0xAF9B, 0xBFBA, 0x8FD9, 0x9FF8,
+    0x6E17, 0x7E36, 0x4E55, 0x5E74, 0x2E93, 0x3EB2, 0x0ED1, 0x1EF0
+};
+
+/**
+ * @brief Adds a decoded byte to the frame being received
+ * 
+ * @param decoder the decoder
+ * @param byte the byte
+ */
+static void Frame_Put(frameDecoder_t* decoder, uint8_t byte)
+{
+    if(decoder->length < sizeof(decoder->data))
+    {
+        decoder->data[decoder->length] = byte;
+        decoder->length++;
+    }
+    else
+    {
+        decoder->overflow = 1;
+    }
+}
+
+/**
+ * @brief Gets the decoder ready for the next frame
+ * 
+ * @param decoder the decoder
+ */
+static void Frame_Restart(frameDecoder_t* decoder)
+{
+    decoder->length = 0;
+    decoder->left = 0;
+    decoder->code = 0;
+    decoder->started = 0;
+    decoder->overflow = 0;
+}
+
+/**
+ * @brief Calculates the CRC-16/CCITT (polynomial 0x1021) of a block, it can be
+ * called block by block passing the CRC of the previous blocks
+ * 
+ * @param data the data
+ * @param length the length of the data in bytes
+ * @param crc 0xFFFF for the first block or the CRC of the previous blocks
+ * @return uint16_t the CRC
+ */
+uint16_t Frame_Crc16(const uint8_t* data, uint16_t length, uint16_t crc)
+{
+    uint16_t i;
+    for(i=0; i<length; i++)
+    {
+        crc = (uint16_t)(crc << 8) ^ Frame_crcTable[(uint8_t)(crc >> 8) ^ data[i]];
+    }
+    return crc;
+}
+/**
+ * @brief Encodes a payload into a frame ending with the delimiter
+ * 
+ * @param payload the payload
+ * @param length the length of the payload in bytes
+ * @param frame the buffer to encode in, FRAME_ENCODED_SIZE(length) bytes are enough
+ * @param frameSize the size of the buffer
+ * @param frameLength the length of the encoded frame
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the frame is encoded
+ *                  E_NOT_OK: If the buffer is too small
+ */
+Std_ReturnType Frame_Encode(const uint8_t* payload, uint16_t length, uint8_t* frame, uint16_t frameSize, uint16_t* frameLength)
+{
+    Std_ReturnType error = E_NOT_OK;
+    uint16_t crc;
+    uint8_t crcBytes[FRAME_CRC_SIZE];
+    uint16_t codePos = 0;
+    uint16_t pos = 1;
+    uint8_t code = 1;
+    uint16_t i;
+    uint8_t byte;
+    if((payload || 0 == length) && frame && frameLength && frameSize >= FRAME_ENCODED_SIZE(length))
+    {
+        /* The CRC is sent high byte first so the CRC of the whole frame is 0 */
+        crc = Frame_Crc16(payload, length, FRAME_CRC_INIT);
+        crcBytes[0] = (uint8_t)(crc >> 8);
+        crcBytes[1] = (uint8_t)crc;
+        for(i=0; i<length + FRAME_CRC_SIZE; i++)
+        {
+            byte = (i < length) ? payload[i] : crcBytes[i - length];
+            if(0 == byte)
+            {
+                frame[codePos] = code;
+                codePos = pos++;
+                code = 1;
+            }
+            else
+            {
+                frame[pos++] = byte;
+                code++;
+                if(FRAME_COBS_MAX_CODE == code)
+                {
+                    frame[codePos] = code;
+                    codePos = pos++;
+                    code = 1;
+                }
+            }
+        }
+        frame[codePos] = code;
+        frame[pos++] = FRAME_DELIMITER;
+        *frameLength = pos;
+        error = E_OK;
+    }
+    return error;
+}
+/**
+ * @brief Initializes a decoder, it waits for a delimiter before the first frame
+ * 
+ * @param decoder the decoder
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+Std_ReturnType Frame_InitDecoder(frameDecoder_t* decoder)
+{
+    Std_ReturnType error = E_NOT_OK;
+    if(decoder)
+    {
+        Frame_Restart(decoder);
+        /* Joining mid-stream, whatever comes before the first delimiter is dropped */
+        decoder->overflow = 1;
+        decoder->frames = 0;
+        decoder->crcErrors = 0;
+        decoder->formatErrors = 0;
+        error = E_OK;
+    }
+    return error;
+}
+/**
+ * @brief Feeds one received byte to a decoder, a frame that is cut or corrupted is
+ * dropped at the next delimiter and decoding goes on with the frame after it
+ * 
+ * @param decoder the decoder
+ * @param byte the received byte
+ * @return uint8_t The state of the decoder
+ *                  FRAME_INCOMPLETE: More bytes are needed
+ *                  FRAME_RECEIVED: A frame is received, the payload is in decoder->data
+ *                  and its length in decoder->length until the next byte is fed
+ *                  FRAME_ERROR: A frame was dropped
+ */
+uint8_t Frame_DecodeByte(frameDecoder_t* decoder, uint8_t byte)
+{
+    uint8_t state = FRAME_INCOMPLETE;
+    if(FRAME_DELIMITER != byte)
+    {
+        if(!decoder->overflow)
+        {
+            if(!decoder->started)
+            {
+                decoder->length = 0;
+                decoder->started = 1;
+            }
+            if(0 == decoder->left)
+            {
+                /* A code byte, the block before it ended with a zero unless it was full */
+                if(decoder->code && FRAME_COBS_MAX_CODE != decoder->code)
+                {
+                    Frame_Put(decoder, 0);
+                }
+                decoder->code = byte;
+                decoder->left = byte - 1;
+            }
+            else
+            {
+                Frame_Put(decoder, byte);
+                decoder->left--;
+            }
+        }
+    }
+    else
+    {
+        if(decoder->started)
+        {
+            if(decoder->overflow || decoder->left || decoder->length < FRAME_CRC_SIZE)
+            {
+                decoder->formatErrors++;
+                state = FRAME_ERROR;
+            }
+            else if(0 != Frame_Crc16(decoder->data, decoder->length, FRAME_CRC_INIT))
+            {
+                decoder->crcErrors++;
+                state = FRAME_ERROR;
+            }
+            else
+            {
+                decoder->frames++;
+                decoder->length -= FRAME_CRC_SIZE;
+                state = FRAME_RECEIVED;
+            }
+        }
+        if(FRAME_RECEIVED == state)
+        {
+            /* The payload stays in the buffer until the next byte */
+            decoder->left = 0;
+            decoder->code = 0;
+            decoder->started = 0;
+        }
+        else
+        {
+            Frame_Restart(decoder);
+        }
+    }
+    return state;
+}
@@ -0,0 +1,582 @@
+/**
+ * @file FwUpdate.c
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief This is the implementation for the firmware update
+ * @version 0.1
+ * @date 2020-04-20
+ * 
+ * @copyright Copyright (c) 2020
+ * 
+ */
+#include "Std_Types.h"
+#include "Frame_Cfg.h"
+#include "Frame.h"
+#include "Link_Cfg.h"
+#include "Link.h"
+#include "Flash_Cfg.h"
+#include "Flash.h"
+#include "NVIC.h"
+#include "FwUpdate_Cfg.h"
+#include "FwUpdate.h"
+
+#define FWUPDATE_KIND_INDEX          0
+#define FWUPDATE_OP_INDEX            1
+#define FWUPDATE_ARG_INDEX           2
+#define FWUPDATE_STATUS_INDEX        2
+#define FWUPDATE_NEXT_INDEX          3
+
+#define FWUPDATE_START_ARGS          6
+#define FWUPDATE_BLOCK_END_ARGS      2
+#define FWUPDATE_CHUNKS_PER_BLOCK    (FWUPDATE_BLOCK_SIZE / FWUPDATE_CHUNK_SIZE)
+#define FWUPDATE_MAX_BLOCKS          (FWUPDATE_SLOT_SIZE / FWUPDATE_BLOCK_SIZE)
+
+#define FWUPDATE_CRC_INIT            0xFFFF
+
+/* The flash jobs, one runs at a time and they are started again while the flash is busy */
+#define FWUPDATE_STEP_NONE           0
+#define FWUPDATE_STEP_ERASE_META     1
+#define FWUPDATE_STEP_ERASE_SLOT     2
+#define FWUPDATE_STEP_HEADER         3
+#define FWUPDATE_STEP_PROGRAM        4
+#define FWUPDATE_STEP_PROGRESS       5
+#define FWUPDATE_STEP_READY          6
+#define FWUPDATE_STEP_DISCARD        7
+
+#define FWUPDATE_META                ((const volatile uint16_t*)FWUPDATE_META_ADDRESS)
+
+typedef struct
+{
+    uint8_t data[FWUPDATE_BLOCK_SIZE];
+    uint16_t block;
+    uint16_t length;
+    uint16_t crc;
+    /* The block is complete and waits to be programmed */
+    uint8_t full;
+}fwUpdateBuffer_t;
+
+static fwUpdateStats_t FwUpdate_stats;
+static uint16_t FwUpdate_crc;
+
+/* One buffer receives while the other one is programmed */
+static fwUpdateBuffer_t FwUpdate_buffers[2];
+static uint8_t FwUpdate_rxBuffer;
+static uint16_t FwUpdate_rxBlock;
+static uint8_t FwUpdate_program;
+
+static uint8_t FwUpdate_step;
+static uint8_t FwUpdate_stepStarted;
+static uint8_t FwUpdate_stepDone;
+static Std_ReturnType FwUpdate_stepResult;
+
+/* The magic, the size and the CRC written at the start of the state page */
+static uint16_t FwUpdate_header[FWUPDATE_META_STATE_INDEX];
+static const uint16_t FwUpdate_blockDone = FWUPDATE_META_BLOCK_DONE;
+static const uint16_t FwUpdate_ready = FWUPDATE_META_READY;
+
+static uint32_t FwUpdate_checkOffset;
+static uint16_t FwUpdate_checkCrc;
+
+static uint8_t FwUpdate_replies[FWUPDATE_REPLY_QUEUE_LENGTH][FWUPDATE_REPLY_SIZE];
+static uint8_t FwUpdate_replyHead;
+static uint8_t FwUpdate_replyCount;
+
+static uint8_t FwUpdate_reboot;
+
+/**
+ * @brief Queues a reply, the newest one is replaced if the queue is full
+ * 
+ * @param op the operation replied to
+ * @param status the status
+ * @param next the block to go on from
+ */
+static void FwUpdate_Reply(uint8_t op, uint8_t status, uint16_t next)
+{
+    uint8_t* reply;
+    if(FwUpdate_replyCount < FWUPDATE_REPLY_QUEUE_LENGTH)
+    {
+        FwUpdate_replyCount++;
+    }
+    reply = FwUpdate_replies[(FwUpdate_replyHead + FwUpdate_replyCount - 1) % FWUPDATE_REPLY_QUEUE_LENGTH];
+    reply[FWUPDATE_KIND_INDEX] = FWUPDATE_MSG_REPLY;
+    reply[FWUPDATE_OP_INDEX] = op;
+    reply[FWUPDATE_STATUS_INDEX] = status;
+    reply[FWUPDATE_NEXT_INDEX] = (uint8_t)next;
+    reply[FWUPDATE_NEXT_INDEX + 1] = (uint8_t)(next >> 8);
+}
+
+/**
+ * @brief Gets the length of a block, only the last one can be shorter
+ * 
+ * @param block the index of the block
+ * @return uint16_t the length in bytes
+ */
+static uint16_t FwUpdate_BlockLength(uint16_t block)
+{
+    uint32_t left = FwUpdate_stats.size - (uint32_t)block * FWUPDATE_BLOCK_SIZE;
+    return left < FWUPDATE_BLOCK_SIZE ? (uint16_t)left : FWUPDATE_BLOCK_SIZE;
+}
+
+/**
+ * @brief Empties both buffers and starts receiving a block
+ * 
+ * @param block the index of the block
+ */
+static void FwUpdate_ResetBuffers(uint16_t block)
+{
+    FwUpdate_buffers[0].length = 0;
+    FwUpdate_buffers[0].full = 0;
+    FwUpdate_buffers[1].length = 0;
+    FwUpdate_buffers[1].full = 0;
+    FwUpdate_rxBuffer = 0;
+    FwUpdate_rxBlock = block;
+}
+
+/**
+ * @brief Drops the update, the state page is erased so the next start begins again
+ * 
+ */
+static void FwUpdate_Abort(void)
+{
+    FwUpdate_stats.state = FWUPDATE_IDLE;
+    FwUpdate_ResetBuffers(0);
+    FwUpdate_step = FWUPDATE_STEP_DISCARD;
+    FwUpdate_stepStarted = 0;
+}
+
+/**
+ * @brief Called by the flash driver when a job ends
+ * 
+ * @param result the result of the job
+ */
+static void FwUpdate_FlashDone(Std_ReturnType result)
+{
+    FwUpdate_stepResult = result;
+    FwUpdate_stepDone = 1;
+}
+
+/**
+ * @brief Starts the flash job of the current step
+ * 
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the job started
+ *                  E_NOT_OK: If the flash is busy
+ */
+static Std_ReturnType FwUpdate_StartStep(void)
+{
+    Std_ReturnType error = E_NOT_OK;
+    fwUpdateBuffer_t* buffer = &FwUpdate_buffers[FwUpdate_program];
+    switch(FwUpdate_step)
+    {
+        case FWUPDATE_STEP_ERASE_META:
+        case FWUPDATE_STEP_DISCARD:
+            error = Flash_Erase(FWUPDATE_META_ADDRESS, 1, FwUpdate_FlashDone);
+        break;
+        case FWUPDATE_STEP_ERASE_SLOT:
+            error = Flash_Erase(FWUPDATE_DOWNLOAD_ADDRESS, FWUPDATE_SLOT_SIZE / FLASH_PAGE_SIZE, FwUpdate_FlashDone);
+        break;
+        case FWUPDATE_STEP_HEADER:
+            error = Flash_Write(FWUPDATE_META_ADDRESS, (const uint8_t*)FwUpdate_header, sizeof(FwUpdate_header), FwUpdate_FlashDone);
+        break;
+        case FWUPDATE_STEP_PROGRAM:
+            error = Flash_Write(FWUPDATE_DOWNLOAD_ADDRESS + (uint32_t)buffer->block * FWUPDATE_BLOCK_SIZE,
+                                buffer->data, buffer->length, FwUpdate_FlashDone);
+        break;
+        case FWUPDATE_STEP_PROGRESS:
+            error = Flash_Write(FWUPDATE_META_ADDRESS + (FWUPDATE_META_BLOCKS_INDEX + buffer->block) * 2,
+                                (const uint8_t*)&FwUpdate_blockDone, 2, FwUpdate_FlashDone);
+        break;
+        case FWUPDATE_STEP_READY:
+            error = Flash_Write(FWUPDATE_META_ADDRESS + FWUPDATE_META_STATE_INDEX * 2,
+                                (const uint8_t*)&FwUpdate_ready, 2, FwUpdate_FlashDone);
+        break;
+    }
+    return error;
+}
+
+/**
+ * @brief Moves to the next step once a flash job ends
+ * 
+ */
+static void FwUpdate_EndStep(void)
+{
+    uint8_t step = FwUpdate_step;
+    fwUpdateBuffer_t* buffer = &FwUpdate_buffers[FwUpdate_program];
+    FwUpdate_step = FWUPDATE_STEP_NONE;
+    FwUpdate_stepStarted = 0;
+    /* The block is read back from the flash before it counts as programmed */
+    if(E_OK == FwUpdate_stepResult && FWUPDATE_STEP_PROGRAM == step &&
+        buffer->crc != Frame_Crc16((const uint8_t*)(FWUPDATE_DOWNLOAD_ADDRESS + (uint32_t)buffer->block * FWUPDATE_BLOCK_SIZE),
+                                    buffer->length, FWUPDATE_CRC_INIT))
+    {
+        FwUpdate_stepResult = E_NOT_OK;
+    }
+    if(E_OK != FwUpdate_stepResult && FWUPDATE_STEP_DISCARD != step)
+    {
+        FwUpdate_stats.flashErrors++;
+        FwUpdate_Reply(step <= FWUPDATE_STEP_HEADER ? FWUPDATE_OP_START :
+                       step == FWUPDATE_STEP_READY ? FWUPDATE_OP_FINISH : FWUPDATE_OP_BLOCK_END,
+                       FWUPDATE_STATUS_FLASH_ERROR, 0);
+        FwUpdate_Abort();
+    }
+    else if(FWUPDATE_STEP_ERASE_META == step)
+    {
+        FwUpdate_step = FWUPDATE_STEP_ERASE_SLOT;
+    }
+    else if(FWUPDATE_STEP_ERASE_SLOT == step)
+    {
+        FwUpdate_step = FWUPDATE_STEP_HEADER;
+    }
+    else if(FWUPDATE_STEP_HEADER == step)
+    {
+        FwUpdate_stats.state = FWUPDATE_RECEIVING;
+        FwUpdate_Reply(FWUPDATE_OP_START, FWUPDATE_STATUS_OK, 0);
+    }
+    else if(FWUPDATE_STEP_PROGRAM == step)
+    {
+        FwUpdate_step = FWUPDATE_STEP_PROGRESS;
+    }
+    else if(FWUPDATE_STEP_PROGRESS == step)
+    {
+        buffer->full = 0;
+        buffer->length = 0;
+        FwUpdate_stats.programmed++;
+        FwUpdate_Reply(FWUPDATE_OP_BLOCK_END, FWUPDATE_STATUS_OK, FwUpdate_stats.programmed);
+    }
+    else if(FWUPDATE_STEP_READY == step)
+    {
+        FwUpdate_stats.state = FWUPDATE_READY;
+        FwUpdate_Reply(FWUPDATE_OP_FINISH, FWUPDATE_STATUS_OK, FwUpdate_stats.programmed);
+    }
+}
+
+/**
+ * @brief Starts an update, it goes on from the blocks already programmed if the
+ * state page holds the same image
+ * 
+ * @param args the size and the CRC of the image
+ */
+static void FwUpdate_Start(const uint8_t* args)
+{
+    uint32_t size = args[0] | ((uint32_t)args[1] << 8) | ((uint32_t)args[2] << 16) | ((uint32_t)args[3] << 24);
+    uint16_t crc = args[4] | (uint16_t)(args[5] << 8);
+    uint16_t programmed = 0;
+    if(FWUPDATE_STEP_NONE != FwUpdate_step || FwUpdate_buffers[0].full || FwUpdate_buffers[1].full ||
+        FWUPDATE_CHECKING == FwUpdate_stats.state)
+    {
+        FwUpdate_Reply(FWUPDATE_OP_START, FWUPDATE_STATUS_BUSY, 0);
+    }
+    else if(0 == size || size > FWUPDATE_SLOT_SIZE)
+    {
+        FwUpdate_Reply(FWUPDATE_OP_START, FWUPDATE_STATUS_BAD_ARGS, 0);
+    }
+    else
+    {
+        FwUpdate_stats.size = size;
+        FwUpdate_stats.blocks = (uint16_t)((size + FWUPDATE_BLOCK_SIZE - 1) / FWUPDATE_BLOCK_SIZE);
+        FwUpdate_crc = crc;
+        FwUpdate_header[FWUPDATE_META_MAGIC_INDEX] = FWUPDATE_META_MAGIC;
+        FwUpdate_header[FWUPDATE_META_SIZE_INDEX] = (uint16_t)size;
+        FwUpdate_header[FWUPDATE_META_SIZE_INDEX + 1] = (uint16_t)(size >> 16);
+        FwUpdate_header[FWUPDATE_META_CRC_INDEX] = crc;
+        if(FWUPDATE_META[FWUPDATE_META_MAGIC_INDEX] == FWUPDATE_META_MAGIC &&
+            FWUPDATE_META[FWUPDATE_META_SIZE_INDEX] == FwUpdate_header[FWUPDATE_META_SIZE_INDEX] &&
+            FWUPDATE_META[FWUPDATE_META_SIZE_INDEX + 1] == FwUpdate_header[FWUPDATE_META_SIZE_INDEX + 1] &&
+            FWUPDATE_META[FWUPDATE_META_CRC_INDEX] == crc)
+        {
+            /* The same image, the blocks marked in the state page are kept */
+            while(programmed < FwUpdate_stats.blocks &&
+                    FWUPDATE_META[FWUPDATE_META_BLOCKS_INDEX + programmed] == FWUPDATE_META_BLOCK_DONE)
+            {
+                programmed++;
+            }
+            FwUpdate_stats.state = FWUPDATE_META[FWUPDATE_META_STATE_INDEX] == FWUPDATE_META_READY ?
+                                    FWUPDATE_READY : FWUPDATE_RECEIVING;
+            FwUpdate_Reply(FWUPDATE_OP_START, FWUPDATE_STATUS_OK, programmed);
+        }
+        else
+        {
+            FwUpdate_stats.state = FWUPDATE_ERASING;
+            FwUpdate_step = FWUPDATE_STEP_ERASE_META;
+        }
+        FwUpdate_stats.programmed = programmed;
+        FwUpdate_ResetBuffers(programmed);
+    }
+}
+
+/**
+ * @brief Copies a chunk into the block being received
+ * 
+ * @param chunk the index of the chunk in the image
+ * @param data the data
+ * @param length the length of the data
+ */
+static void FwUpdate_Data(uint16_t chunk, const uint8_t* data, uint16_t length)
+{
+    uint16_t block = chunk / FWUPDATE_CHUNKS_PER_BLOCK;
+    uint16_t offset = (chunk % FWUPDATE_CHUNKS_PER_BLOCK) * FWUPDATE_CHUNK_SIZE;
+    fwUpdateBuffer_t* buffer = &FwUpdate_buffers[FwUpdate_rxBuffer];
+    uint16_t i;
+    /* The link delivers in order so a chunk out of place belongs to a block sent again */
+    if(FWUPDATE_RECEIVING != FwUpdate_stats.state || block != FwUpdate_rxBlock || block >= FwUpdate_stats.blocks ||
+        buffer->full || offset != buffer->length || 0 == length || length > FWUPDATE_CHUNK_SIZE ||
+        offset + length > FwUpdate_BlockLength(block))
+    {
+        FwUpdate_stats.dropped++;
+    }
+    else
+    {
+        for(i = 0; i < length; i++)
+        {
+            buffer->data[offset + i] = data[i];
+        }
+        buffer->length += length;
+        FwUpdate_stats.chunks++;
+    }
+}
+
+/**
+ * @brief Ends the block being received, it is checked and handed to be programmed
+ * and the other buffer starts receiving the next block
+ * 
+ * @param block the index of the block
+ * @param args the CRC of the block
+ */
+static void FwUpdate_BlockEnd(uint16_t block, const uint8_t* args)
+{
+    uint16_t crc = args[0] | (uint16_t)(args[1] << 8);
+    fwUpdateBuffer_t* buffer = &FwUpdate_buffers[FwUpdate_rxBuffer];
+    if(FWUPDATE_RECEIVING != FwUpdate_stats.state || block != FwUpdate_rxBlock || block >= FwUpdate_stats.blocks)
+    {
+        FwUpdate_stats.dropped++;
+        FwUpdate_Reply(FWUPDATE_OP_BLOCK_END, FWUPDATE_STATUS_BAD_STATE, FwUpdate_rxBlock);
+    }
+    else if(buffer->full)
+    {
+        /* More than two blocks in flight */
+        FwUpdate_stats.dropped++;
+        FwUpdate_Reply(FWUPDATE_OP_BLOCK_END, FWUPDATE_STATUS_BUSY, FwUpdate_rxBlock);
+    }
+    else if(buffer->length != FwUpdate_BlockLength(block) ||
+            crc != Frame_Crc16(buffer->data, buffer->length, FWUPDATE_CRC_INIT))
+    {
+        FwUpdate_stats.crcErrors++;
+        buffer->length = 0;
+        FwUpdate_Reply(FWUPDATE_OP_BLOCK_END, FWUPDATE_STATUS_CRC_ERROR, FwUpdate_rxBlock);
+    }
+    else
+    {
+        /* The other buffer can still be programmed, the host does not send the next
+         * block before the one programmed is acknowledged */
+        buffer->block = block;
+        buffer->crc = crc;
+        buffer->full = 1;
+        FwUpdate_rxBuffer ^= 1;
+        FwUpdate_rxBlock++;
+    }
+}
+
+/**
+ * @brief Checks the whole image a block each run
+ * 
+ */
+static void FwUpdate_Check(void)
+{
+    uint32_t length = FwUpdate_stats.size - FwUpdate_checkOffset;
+    if(length > FWUPDATE_BLOCK_SIZE)
+    {
+        length = FWUPDATE_BLOCK_SIZE;
+    }
+    FwUpdate_checkCrc = Frame_Crc16((const uint8_t*)(FWUPDATE_DOWNLOAD_ADDRESS + FwUpdate_checkOffset),
+                                    (uint16_t)length, FwUpdate_checkCrc);
+    FwUpdate_checkOffset += length;
+    if(FwUpdate_checkOffset == FwUpdate_stats.size)
+    {
+        if(FwUpdate_checkCrc == FwUpdate_crc)
+        {
+            FwUpdate_step = FWUPDATE_STEP_READY;
+        }
+        else
+        {
+            FwUpdate_stats.crcErrors++;
+            FwUpdate_Reply(FWUPDATE_OP_FINISH, FWUPDATE_STATUS_CRC_ERROR, 0);
+            FwUpdate_Abort();
+        }
+    }
+}
+
+/**
+ * @brief Initializes the firmware update, the link has to be initialized first
+ * 
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+Std_ReturnType FwUpdate_Init(void)
+{
+    FwUpdate_stats.state = FWUPDATE_IDLE;
+    FwUpdate_stats.size = 0;
+    FwUpdate_stats.blocks = 0;
+    FwUpdate_stats.programmed = 0;
+    FwUpdate_stats.chunks = 0;
+    FwUpdate_stats.crcErrors = 0;
+    FwUpdate_stats.flashErrors = 0;
+    FwUpdate_stats.dropped = 0;
+    FwUpdate_ResetBuffers(0);
+    FwUpdate_step = FWUPDATE_STEP_NONE;
+    FwUpdate_stepStarted = 0;
+    FwUpdate_stepDone = 0;
+    FwUpdate_replyHead = 0;
+    FwUpdate_replyCount = 0;
+    FwUpdate_reboot = 0;
+    return E_OK;
+}
+
+/**
+ * @brief Handles a request received from the link
+ * 
+ * @param data the message starting with FWUPDATE_MSG_REQUEST
+ * @param length the length of the message
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the request is handled
+ *                  E_NOT_OK: If the message is not a request
+ */
+Std_ReturnType FwUpdate_Receive(const uint8_t* data, uint16_t length)
+{
+    Std_ReturnType error = E_NOT_OK;
+    const uint8_t* args;
+    uint16_t argLength;
+    uint16_t arg;
+    if(data && length >= FWUPDATE_HEADER_SIZE && data[FWUPDATE_KIND_INDEX] == FWUPDATE_MSG_REQUEST)
+    {
+        args = &data[FWUPDATE_HEADER_SIZE];
+        argLength = length - FWUPDATE_HEADER_SIZE;
+        arg = data[FWUPDATE_ARG_INDEX] | (uint16_t)(data[FWUPDATE_ARG_INDEX + 1] << 8);
+        switch(data[FWUPDATE_OP_INDEX])
+        {
+            case FWUPDATE_OP_START:
+                if(argLength != FWUPDATE_START_ARGS)
+                {
+                    FwUpdate_Reply(FWUPDATE_OP_START, FWUPDATE_STATUS_BAD_ARGS, 0);
+                }
+                else
+                {
+                    FwUpdate_Start(args);
+                }
+            break;
+            case FWUPDATE_OP_DATA:
+                FwUpdate_Data(arg, args, argLength);
+            break;
+            case FWUPDATE_OP_BLOCK_END:
+                if(argLength != FWUPDATE_BLOCK_END_ARGS)
+                {
+                    FwUpdate_Reply(FWUPDATE_OP_BLOCK_END, FWUPDATE_STATUS_BAD_ARGS, FwUpdate_rxBlock);
+                }
+                else
+                {
+                    FwUpdate_BlockEnd(arg, args);
+                }
+            break;
+            case FWUPDATE_OP_FINISH:
+                if(FWUPDATE_READY == FwUpdate_stats.state)
+                {
+                    FwUpdate_Reply(FWUPDATE_OP_FINISH, FWUPDATE_STATUS_OK, FwUpdate_stats.programmed);
+                }
+                else if(FWUPDATE_RECEIVING == FwUpdate_stats.state && FwUpdate_stats.programmed == FwUpdate_stats.blocks)
+                {
+                    /* Answered once the image is checked */
+                    FwUpdate_stats.state = FWUPDATE_CHECKING;
+                    FwUpdate_checkOffset = 0;
+                    FwUpdate_checkCrc = FWUPDATE_CRC_INIT;
+                }
+                else
+                {
+                    FwUpdate_Reply(FWUPDATE_OP_FINISH, FWUPDATE_STATUS_BAD_STATE, FwUpdate_stats.programmed);
+                }
+            break;
+            case FWUPDATE_OP_STATUS:
+                FwUpdate_Reply(FWUPDATE_OP_STATUS, FWUPDATE_STATUS_OK, FwUpdate_stats.programmed);
+            break;
+            case FWUPDATE_OP_REBOOT:
+                if(FWUPDATE_READY == FwUpdate_stats.state)
+                {
+                    FwUpdate_Reply(FWUPDATE_OP_REBOOT, FWUPDATE_STATUS_OK, FwUpdate_stats.programmed);
+                    FwUpdate_reboot = 1;
+                }
+                else
+                {
+                    FwUpdate_Reply(FWUPDATE_OP_REBOOT, FWUPDATE_STATUS_BAD_STATE, FwUpdate_stats.programmed);
+                }
+            break;
+            default:
+                FwUpdate_Reply(data[FWUPDATE_OP_INDEX], FWUPDATE_STATUS_BAD_ARGS, 0);
+            break;
+        }
+        error = E_OK;
+    }
+    return error;
+}
+
+/**
+ * @brief Gets the progress of the update
+ * 
+ * @param stats where to put the progress
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+Std_ReturnType FwUpdate_GetStats(fwUpdateStats_t* stats)
+{
+    Std_ReturnType error = E_NOT_OK;
+    if(stats)
+    {
+        *stats = FwUpdate_stats;
+        error = E_OK;
+    }
+    return error;
+}
+
+/**
+ * @brief The firmware update task, it programs the received blocks, checks the image
+ * and sends the replies
+ * 
+ */
+void FwUpdate_Task(void)
+{
+    uint8_t pending;
+    uint8_t i;
+    if(FwUpdate_stepDone)
+    {
+        FwUpdate_stepDone = 0;
+        FwUpdate_EndStep();
+    }
+    /* The next block is programmed while the other buffer receives */
+    if(FWUPDATE_STEP_NONE == FwUpdate_step)
+    {
+        for(i = 0; i < 2; i++)
+        {
+            if(FwUpdate_buffers[i].full && FwUpdate_buffers[i].block == FwUpdate_stats.programmed)
+            {
+                FwUpdate_program = i;
+                FwUpdate_step = FWUPDATE_STEP_PROGRAM;
+            }
+        }
+        if(FWUPDATE_STEP_NONE == FwUpdate_step && FWUPDATE_CHECKING == FwUpdate_stats.state)
+        {
+            FwUpdate_Check();
+        }
+    }
+    if(FWUPDATE_STEP_NONE != FwUpdate_step && !FwUpdate_stepStarted && E_OK == FwUpdate_StartStep())
+    {
+        FwUpdate_stepStarted = 1;
+    }
+    while(FwUpdate_replyCount && E_OK == Link_Send(FwUpdate_replies[FwUpdate_replyHead], FWUPDATE_REPLY_SIZE))
+    {
+        FwUpdate_replyHead = (FwUpdate_replyHead + 1) % FWUPDATE_REPLY_QUEUE_LENGTH;
+        FwUpdate_replyCount--;
+    }
+    /* The reset waits for the reply to be acknowledged */
+    if(FwUpdate_reboot && 0 == FwUpdate_replyCount && E_OK == Link_GetPending(&pending) && 0 == pending)
+    {
+        NVIC_systemReset();
+    }
+}
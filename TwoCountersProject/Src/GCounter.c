@@ -0,0 +1,437 @@
+/**
+ * @file GCounter.c
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief This is the implementation for the replicated counter
+ * @version 0.1
+ * @date 2020-04-16
+ * 
+ * @copyright Copyright (c) 2020
+ * 
+ */
+#include "Std_Types.h"
+#include "CounterCodec_Cfg.h"
+#include "CounterCodec.h"
+#include "GCounter_Cfg.h"
+#include "GCounter.h"
+
+#define GCOUNTER_SLOT_MASK(node)     ((uint32_t)1 << (node))
+
+static uint32_t GCounter_slots[GCOUNTER_MAX_NODES];
+/* The slots changed since they were last sent */
+static uint32_t GCounter_dirty;
+/* The next slot the anti-entropy message starts from */
+static uint8_t GCounter_syncCursor;
+/* The link has one peer, every slot is sent to it and received from it as its own
+ * delta stream */
+static counterEncoder_t GCounter_encoders[GCOUNTER_MAX_NODES];
+static counterDecoder_t GCounter_decoders[GCOUNTER_MAX_NODES];
+/* The slot values in the last message built, they are committed with it */
+static uint32_t GCounter_built[GCOUNTER_MAX_NODES];
+
+/**
+ * @brief Appends one slot to a message if it fits
+ * 
+ * @param node the node number
+ * @param buffer the message
+ * @param bufferSize the size of the buffer
+ * @param length the length of the message, it is moved past the entry
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the entry was added
+ *                  E_NOT_OK: If the message is full
+ */
+static Std_ReturnType GCounter_PutEntry(uint8_t node, uint8_t* buffer, uint16_t bufferSize, uint16_t* length)
+{
+    Std_ReturnType error = E_NOT_OK;
+    uint8_t entry[GCOUNTER_MAX_ENTRY];
+    uint16_t entryLength;
+    uint16_t i;
+    entry[0] = node;
+    entryLength = 1 + CounterCodec_PutVarint(GCounter_slots[node], &entry[1]);
+    if(*length + entryLength <= bufferSize)
+    {
+        for(i = 0; i < entryLength; i++)
+        {
+            buffer[*length + i] = entry[i];
+        }
+        *length += entryLength;
+        GCounter_built[node] = GCounter_slots[node];
+        error = E_OK;
+    }
+    return error;
+}
+
+/**
+ * @brief Appends one slot to a message as a record of its delta stream if it fits
+ * 
+ * @param node the node number
+ * @param buffer the message
+ * @param bufferSize the size of the buffer
+ * @param length the length of the message, it is moved past the entry
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the entry was added
+ *                  E_NOT_OK: If the message is full
+ */
+static Std_ReturnType GCounter_PutDeltaEntry(uint8_t node, uint8_t* buffer, uint16_t bufferSize, uint16_t* length)
+{
+    Std_ReturnType error = E_NOT_OK;
+    uint16_t recordLength;
+    if(*length + 1 < bufferSize &&
+        E_OK == CounterCodec_Encode(&GCounter_encoders[node], GCounter_slots[node], &buffer[*length + 1],
+                                    bufferSize - *length - 1, &recordLength))
+    {
+        buffer[*length] = node;
+        *length += 1 + recordLength;
+        GCounter_built[node] = GCounter_slots[node];
+        error = E_OK;
+    }
+    return error;
+}
+
+/**
+ * @brief Raises a slot to a value received from another node, a raised slot is
+ * pending so the next delta message relays it to the nodes that did not see it
+ * 
+ * @param node the node number
+ * @param value the value received
+ * @return uint8_t 1 if the slot got larger and 0 if not
+ */
+static uint8_t GCounter_Raise(uint8_t node, uint32_t value)
+{
+    uint8_t changed = 0;
+    if(value > GCounter_slots[node])
+    {
+        /* Our own slot only grows here after a reset, the peers remember it */
+        GCounter_slots[node] = value;
+        GCounter_dirty |= GCOUNTER_SLOT_MASK(node);
+        changed = 1;
+    }
+    return changed;
+}
+
+/**
+ * @brief Merges entries that carry the whole slot values
+ * 
+ * @param data the message
+ * @param length the length of the message
+ * @param changed where to put 1 if a slot got larger and 0 if not
+ * @param resync 1 to restart the delta streams from the values and 0 to leave them
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the message is corrupted, the entries before the
+ *                  corrupted one are merged
+ */
+static Std_ReturnType GCounter_MergeValues(const uint8_t* data, uint16_t length, uint8_t* changed, uint8_t resync)
+{
+    Std_ReturnType error = E_NOT_OK;
+    uint16_t index = 0;
+    uint8_t node;
+    uint32_t value;
+    if(data && changed)
+    {
+        *changed = 0;
+        error = E_OK;
+        while(index < length && error == E_OK)
+        {
+            node = data[index];
+            index++;
+            error = CounterCodec_GetVarint(data, length, &index, &value);
+            if(error == E_OK && node >= GCOUNTER_MAX_NODES)
+            {
+                error = E_NOT_OK;
+            }
+            else if(error == E_OK)
+            {
+                *changed |= GCounter_Raise(node, value);
+                if(resync)
+                {
+                    CounterCodec_Resync(&GCounter_decoders[node], value);
+                }
+            }
+        }
+    }
+    return error;
+}
+
+/**
+ * @brief Initializes the counter with all the slots cleared
+ * 
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+Std_ReturnType GCounter_Init(void)
+{
+    uint8_t node;
+    for(node = 0; node < GCOUNTER_MAX_NODES; node++)
+    {
+        GCounter_slots[node] = 0;
+        GCounter_built[node] = 0;
+        CounterCodec_InitEncoder(&GCounter_encoders[node]);
+        CounterCodec_InitDecoder(&GCounter_decoders[node]);
+    }
+    GCounter_dirty = 0;
+    GCounter_syncCursor = 0;
+    return E_OK;
+}
+
+/**
+ * @brief Increments the slot of this node
+ * 
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+Std_ReturnType GCounter_Increment(void)
+{
+    GCounter_slots[GCOUNTER_NODE_ID]++;
+    GCounter_dirty |= GCOUNTER_SLOT_MASK(GCOUNTER_NODE_ID);
+    return E_OK;
+}
+
+/**
+ * @brief Builds a delta message with the slots a press or a merge changed since they
+ * were last sent, every slot goes as a record of its delta stream and stays pending
+ * until the message is committed, a message has to be committed before the next one
+ * is built
+ * 
+ * @param buffer where to put the message
+ * @param bufferSize the size of the buffer, at least GCOUNTER_MAX_DELTA_ENTRY
+ * @param length where to put the length of the message, 0 if nothing changed
+ * @param sentMask where to put the slots in the message
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+Std_ReturnType GCounter_BuildDelta(uint8_t* buffer, uint16_t bufferSize, uint16_t* length, uint32_t* sentMask)
+{
+    Std_ReturnType error = E_NOT_OK;
+    uint8_t node;
+    if(buffer && length && sentMask && bufferSize >= GCOUNTER_MAX_DELTA_ENTRY)
+    {
+        *length = 0;
+        *sentMask = 0;
+        /* The slots that do not fit go with the next message */
+        for(node = 0; node < GCOUNTER_MAX_NODES; node++)
+        {
+            if((GCounter_dirty & GCOUNTER_SLOT_MASK(node)) &&
+                E_OK == GCounter_PutDeltaEntry(node, buffer, bufferSize, length))
+            {
+                *sentMask |= GCOUNTER_SLOT_MASK(node);
+            }
+        }
+        error = E_OK;
+    }
+    return error;
+}
+
+/**
+ * @brief Marks the slots of a delta message as sent after the link took it, the
+ * next deltas of these slots are taken from the values in the message
+ * 
+ * @param sentMask the slots given by GCounter_BuildDelta
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+Std_ReturnType GCounter_CommitDelta(uint32_t sentMask)
+{
+    uint8_t node;
+    for(node = 0; node < GCOUNTER_MAX_NODES; node++)
+    {
+        if(sentMask & GCOUNTER_SLOT_MASK(node))
+        {
+            CounterCodec_Commit(&GCounter_encoders[node], GCounter_built[node]);
+            /* A slot that moved after the message was built is still pending */
+            if(GCounter_slots[node] == GCounter_built[node])
+            {
+                GCounter_dirty &= ~GCOUNTER_SLOT_MASK(node);
+            }
+        }
+    }
+    return E_OK;
+}
+
+/**
+ * @brief Builds an anti-entropy message with the next slots in turn, sending one
+ * from time to time repairs the slots a node missed or lost in a reset, the slots
+ * go as whole values so a peer that lost a delta stream can take it again
+ * 
+ * @param buffer where to put the message
+ * @param bufferSize the size of the buffer, at least GCOUNTER_MAX_ENTRY
+ * @param length where to put the length of the message, 0 if all the slots are 0
+ * @param sentMask where to put the slots in the message
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+Std_ReturnType GCounter_BuildSync(uint8_t* buffer, uint16_t bufferSize, uint16_t* length, uint32_t* sentMask)
+{
+    Std_ReturnType error = E_NOT_OK;
+    uint8_t checked;
+    if(buffer && length && sentMask && bufferSize >= GCOUNTER_MAX_ENTRY)
+    {
+        *length = 0;
+        *sentMask = 0;
+        /* An empty slot is the same as not sending it */
+        for(checked = 0; checked < GCOUNTER_MAX_NODES; checked++)
+        {
+            if(GCounter_slots[GCounter_syncCursor])
+            {
+                if(E_OK != GCounter_PutEntry(GCounter_syncCursor, buffer, bufferSize, length))
+                {
+                    break;
+                }
+                *sentMask |= GCOUNTER_SLOT_MASK(GCounter_syncCursor);
+            }
+            GCounter_syncCursor = (GCounter_syncCursor + 1) % GCOUNTER_MAX_NODES;
+        }
+        error = E_OK;
+    }
+    return error;
+}
+
+/**
+ * @brief Restarts the delta streams of the slots of an anti-entropy message after
+ * the link took it, the peer takes the values in it as the base of the next deltas
+ * 
+ * @param sentMask the slots given by GCounter_BuildSync
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+Std_ReturnType GCounter_CommitSync(uint32_t sentMask)
+{
+    uint8_t node;
+    for(node = 0; node < GCOUNTER_MAX_NODES; node++)
+    {
+        if(sentMask & GCOUNTER_SLOT_MASK(node))
+        {
+            CounterCodec_Rebase(&GCounter_encoders[node], GCounter_built[node]);
+            if(GCounter_slots[node] == GCounter_built[node])
+            {
+                GCounter_dirty &= ~GCOUNTER_SLOT_MASK(node);
+            }
+        }
+    }
+    return E_OK;
+}
+
+/**
+ * @brief Merges a delta message received from another node, a slot whose stream
+ * has no base yet is skipped until its next snapshot or anti-entropy message
+ * 
+ * @param data the message
+ * @param length the length of the message
+ * @param changed where to put 1 if a slot got larger and 0 if not
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the message is corrupted, the entries before the
+ *                  corrupted one are merged
+ */
+Std_ReturnType GCounter_MergeDelta(const uint8_t* data, uint16_t length, uint8_t* changed)
+{
+    Std_ReturnType error = E_NOT_OK;
+    uint16_t index = 0;
+    uint8_t node;
+    if(data && changed)
+    {
+        *changed = 0;
+        error = E_OK;
+        while(index < length && error == E_OK)
+        {
+            node = data[index];
+            index++;
+            if(node >= GCOUNTER_MAX_NODES)
+            {
+                error = E_NOT_OK;
+            }
+            else
+            {
+                error = CounterCodec_Decode(&GCounter_decoders[node], data, length, &index);
+                if(error == E_OK && GCounter_decoders[node].synced)
+                {
+                    *changed |= GCounter_Raise(node, GCounter_decoders[node].value);
+                }
+            }
+        }
+    }
+    return error;
+}
+
+/**
+ * @brief Merges an anti-entropy message received from another node, the values in
+ * it are the base of the next deltas of their slots
+ * 
+ * @param data the message
+ * @param length the length of the message
+ * @param changed where to put 1 if a slot got larger and 0 if not
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the message is corrupted, the entries before the
+ *                  corrupted one are merged
+ */
+Std_ReturnType GCounter_MergeSync(const uint8_t* data, uint16_t length, uint8_t* changed)
+{
+    return GCounter_MergeValues(data, length, changed, 1);
+}
+
+/**
+ * @brief Merges whole slot values that did not come from the link, like the ones
+ * kept in flash, the delta streams are not touched
+ * 
+ * @param data the slots as node numbers and varints
+ * @param length the length of the data
+ * @param changed where to put 1 if a slot got larger and 0 if not
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the data is corrupted, the entries before the
+ *                  corrupted one are merged
+ */
+Std_ReturnType GCounter_Merge(const uint8_t* data, uint16_t length, uint8_t* changed)
+{
+    return GCounter_MergeValues(data, length, changed, 0);
+}
+
+/**
+ * @brief Gets the sum of all the slots
+ * 
+ * @param total where to put the sum
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+Std_ReturnType GCounter_GetTotal(uint32_t* total)
+{
+    Std_ReturnType error = E_NOT_OK;
+    uint8_t node;
+    if(total)
+    {
+        *total = 0;
+        for(node = 0; node < GCOUNTER_MAX_NODES; node++)
+        {
+            *total += GCounter_slots[node];
+        }
+        error = E_OK;
+    }
+    return error;
+}
+
+/**
+ * @brief Gets the count of one node
+ * 
+ * @param node the node number
+ * @param value where to put the count
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+Std_ReturnType GCounter_GetSlot(uint8_t node, uint32_t* value)
+{
+    Std_ReturnType error = E_NOT_OK;
+    if(node < GCOUNTER_MAX_NODES && value)
+    {
+        *value = GCounter_slots[node];
+        error = E_OK;
+    }
+    return error;
+}
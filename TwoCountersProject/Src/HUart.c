@@ -15,6 +15,7 @@
 #include "NVIC.h"
 #include "RCC.h"
 #include "Gpio.h"
+#include "SYSTICK.h"
 
 /* Protection */
 #ifndef HUART_DEFAULT_MODULE
@@ -23,8 +24,22 @@
 
 #define UART_QUEUE_LENGTH             5
 
+#define HUART_STAGE_BUFFERS           2
+
+#define HUART_POOL_NONE               0xFF
+#define HUART_BLOCK_FREE              0
+#define HUART_BLOCK_CALLER            1
+#define HUART_BLOCK_DRIVER            2
+
 #define UART_NUMBER_OF_MODULES        5
 
+/* Index of the lowest set bit of a module mask that is not zero */
+#ifdef __GNUC__
+#define HUART_LOWEST_MODULE(mask)     ((uint8_t)__builtin_ctz(mask))
+#else
+#define HUART_LOWEST_MODULE(mask)     HUart_LowestModule(mask)
+#endif
+
 #define HUART_NOT_INITIALIZED         1
 #define HUART_INITIALIZED             0
 #define HUART_NOT_CONFIGURED          0
@@ -39,21 +54,74 @@ typedef struct
 
 }hUartConfig_t;
 
+typedef struct
+{
+    uint32_t port;
+    uint32_t ctsPin;
+    uint32_t rtsPin;
+    uint32_t ckPin;
+
+}hUartFlowPins_t;
+
+typedef struct
+{
+    uint32_t port;
+    uint32_t pin;
+    uint32_t charTimeUs;
+    uint32_t drainStart;
+
+}hUartDePin_t;
+
 typedef struct
 {
     uint8_t* data;
     uint16_t len;
+    const hUartSegment_t* segments;
+    uint8_t nSegments;
+    hUartSgDoneCb_t doneCb;
+    uint8_t address;
+    uint16_t totalTimeout;
+    uint16_t interByteTimeout;
+    uint32_t queuedAt;
 
 }hUartPacket_t;
 
+typedef struct
+{
+    uint16_t total;
+    uint16_t interByte;
+    /* The SysTick times the request started and its last byte came */
+    uint32_t startedAt;
+    uint32_t lastByteAt;
+    uint16_t lastCount;
+    uint8_t armed;
+
+}hUartRxTimer_t;
+
 typedef struct
 {
     uint8_t nPackets;
+    uint8_t peak;
     hUartPacket_t packet[UART_QUEUE_LENGTH];
 }hUartQueue_t;
 
+typedef struct
+{
+    uint8_t buffer[HUART_STAGE_BUFFERS][HUART_COALESCE_BUFFER_SIZE];
+    uint16_t length[HUART_STAGE_BUFFERS];
+    uint8_t busy[HUART_STAGE_BUFFERS];
+    uint8_t fill;
+    /* The SysTick time the first byte went into the fill buffer */
+    uint32_t openedAt;
+    /* In milli seconds, 0 when coalescing is off */
+    uint16_t window;
+    uint16_t threshold;
+}hUartStage_t;
+
 static volatile hUartQueue_t HUart_rxQueue[UART_NUMBER_OF_MODULES];
-static volatile hUartQueue_t HUart_txQueue[UART_NUMBER_OF_MODULES];
+static volatile hUartQueue_t HUart_txQueue[UART_NUMBER_OF_MODULES][HUART_TX_LANES];
+static volatile uint8_t HUart_laneDepth[UART_NUMBER_OF_MODULES][HUART_TX_LANES];
+static volatile uint8_t HUart_lanePolicy[UART_NUMBER_OF_MODULES][HUART_TX_LANES];
 
 static volatile hUartConfig_t HUart_config[UART_NUMBER_OF_MODULES];
 
@@ -61,6 +129,103 @@ static volatile uint8_t HUart_module =  HUART_DEFAULT_MODULE;
 static volatile uint8_t isInitialized[UART_NUMBER_OF_MODULES] = {HUART_NOT_INITIALIZED, HUART_NOT_INITIALIZED, HUART_NOT_INITIALIZED, HUART_NOT_INITIALIZED, HUART_NOT_INITIALIZED};
 static volatile uint8_t isConfigured[UART_NUMBER_OF_MODULES] =  {HUART_NOT_CONFIGURED, HUART_NOT_CONFIGURED, HUART_NOT_CONFIGURED, HUART_NOT_CONFIGURED, HUART_NOT_CONFIGURED};
 
+/* The CTS/RTS/CK pins of each module, UART4 and UART5 have none */
+static const hUartFlowPins_t HUart_flowPins[UART_NUMBER_OF_MODULES] = {
+    {GPIO_PORTA, GPIO_PIN_11, GPIO_PIN_12, GPIO_PIN_8},
+    {GPIO_PORTA, GPIO_PIN_0, GPIO_PIN_1, GPIO_PIN_4},
+    {GPIO_PORTB, GPIO_PIN_13, GPIO_PIN_14, GPIO_PIN_12},
+    {0, 0, 0, 0},
+    {0, 0, 0, 0}
+};
+
+static volatile uint32_t HUart_clockMode[UART_NUMBER_OF_MODULES];
+
+static volatile hUartPacket_t HUart_txActive[UART_NUMBER_OF_MODULES];
+static volatile uint8_t HUart_txInFlight[UART_NUMBER_OF_MODULES];
+
+static volatile hUartStats_t HUart_stats[UART_NUMBER_OF_MODULES];
+static volatile uint32_t HUart_statsStart[UART_NUMBER_OF_MODULES];
+
+static volatile uint8_t HUart_address[UART_NUMBER_OF_MODULES] = {HUART_NO_ADDRESS, HUART_NO_ADDRESS, HUART_NO_ADDRESS, HUART_NO_ADDRESS, HUART_NO_ADDRESS};
+
+static volatile hUartStage_t HUart_stage[UART_NUMBER_OF_MODULES];
+
+static volatile hUartNotifyCb_t HUart_txNotify[UART_NUMBER_OF_MODULES];
+static volatile hUartNotifyCb_t HUart_rxNotify[UART_NUMBER_OF_MODULES];
+static volatile hUartRxStatusCb_t HUart_rxStatusCb[UART_NUMBER_OF_MODULES];
+
+static volatile hUartRxTimer_t HUart_rxTimer[UART_NUMBER_OF_MODULES];
+
+static volatile hUartDePin_t HUart_dePin[UART_NUMBER_OF_MODULES];
+
+/* The transmit buffer pool, the free blocks are linked through HUart_poolNext */
+static uint8_t HUart_pool[HUART_POOL_BLOCKS][HUART_POOL_BLOCK_SIZE];
+static volatile uint8_t HUart_poolNext[HUART_POOL_BLOCKS];
+static volatile uint8_t HUart_poolOwner[HUART_POOL_BLOCKS];
+static volatile uint8_t HUart_poolHead = HUART_POOL_NONE;
+static volatile uint8_t HUart_poolReady;
+static volatile hUartPoolStats_t HUart_poolStats;
+
+/* One bit per module that has queued or staged work for the task */
+static volatile uint32_t HUart_activeMask;
+
+#ifndef __GNUC__
+/**
+ * @brief Finds the lowest module that has its bit set in a mask
+ * 
+ * @param mask the module mask, must not be zero
+ * @return uint8_t the module
+ */
+static uint8_t HUart_LowestModule(uint32_t mask)
+{
+    uint8_t i = 0;
+    while(!(mask & 1))
+    {
+        mask >>= 1;
+        i++;
+    }
+    return i;
+}
+#endif
+
+/**
+ * @brief Marks a module as having work for the task
+ * *The mask is also written from interrupt callbacks so it is
+ * changed with the interrupts disabled
+ * 
+ * @param uartModule the module
+ */
+static void HUart_MarkActive(uint8_t uartModule)
+{
+    NVIC_controlAllPeripheral(NVIC_DISABLE);
+    HUart_activeMask |= ((uint32_t)1 << uartModule);
+    NVIC_controlAllPeripheral(NVIC_ENABLE);
+}
+
+/**
+ * @brief Checks if a module has nothing left for the task to do
+ * *A transmission in flight is finished by the interrupt so it
+ * does not keep the module active, a receive with a timeout does
+ * 
+ * @param uartModule the module
+ * @return uint8_t 1 if the module is idle and 0 if not
+ */
+static uint8_t HUart_IsIdle(uint8_t uartModule)
+{
+    uint8_t lane;
+    uint8_t idle = (0 == HUart_rxQueue[uartModule].nPackets)
+                && (0 == HUart_stage[uartModule].length[HUart_stage[uartModule].fill])
+                && !HUart_rxTimer[uartModule].armed;
+    for(lane=0; lane<HUART_TX_LANES; lane++)
+    {
+        if(HUart_txQueue[uartModule][lane].nPackets > 0)
+        {
+            idle = 0;
+        }
+    }
+    return idle;
+}
+
 /**
  * @brief A push request into a queue
  * 
@@ -73,9 +238,12 @@ static Std_ReturnType HUart_QueuePush(volatile hUartQueue_t* queue, hUartPacket_
     Std_ReturnType error = E_NOT_OK;
     if(queue->nPackets < UART_QUEUE_LENGTH)
     {
-        queue->packet[queue->nPackets].data = packet->data;
-        queue->packet[queue->nPackets].len = packet->len;
+        queue->packet[queue->nPackets] = *packet;
         queue->nPackets++;
+        if(queue->nPackets > queue->peak)
+        {
+            queue->peak = queue->nPackets;
+        }
         error = E_OK;
     }
     return error;
@@ -93,8 +261,7 @@ static Std_ReturnType HUart_QueueGet(volatile hUartQueue_t* queue, hUartPacket_t
     Std_ReturnType error = E_NOT_OK;
     if(queue->nPackets > 0)
     {
-        packet->data = queue->packet[0].data;
-        packet->len = queue->packet[0].len;
+        *packet = queue->packet[0];
         error = E_OK;
     }
     return error;
@@ -113,8 +280,7 @@ static Std_ReturnType HUart_QueuePop(volatile hUartQueue_t* queue)
     {
         for(i=0; i<queue->nPackets-1; i++)
         {
-            queue->packet[i].data = queue->packet[i + 1].data;
-            queue->packet[i].len = queue->packet[i + 1].len;
+            queue->packet[i] = queue->packet[i + 1];
         }
         queue->nPackets--;
         error = E_OK;
@@ -123,22 +289,427 @@ static Std_ReturnType HUart_QueuePop(volatile hUartQueue_t* queue)
 }
 
 /**
- * @brief Initializes the UART Module
+ * @brief Links all the blocks of the pool in the free list the first time it is used
+ * 
+ */
+static void HUart_PoolInit(void)
+{
+    uint8_t i;
+    for(i=0; i<HUART_POOL_BLOCKS; i++)
+    {
+        HUart_poolNext[i] = (i + 1 < HUART_POOL_BLOCKS) ? (i + 1) : HUART_POOL_NONE;
+        HUart_poolOwner[i] = HUART_BLOCK_FREE;
+    }
+    HUart_poolHead = 0;
+    HUart_poolStats.freeBlocks = HUART_POOL_BLOCKS;
+    HUart_poolStats.minFreeBlocks = HUART_POOL_BLOCKS;
+    HUart_poolReady = 1;
+}
+
+/**
+ * @brief Finds the pool block an address belongs to
+ * 
+ * @param data the address
+ * @return uint8_t the index of the block or HUART_POOL_NONE if it is not the start of a block
+ */
+static uint8_t HUart_PoolIndex(const uint8_t* data)
+{
+    uint8_t index = HUART_POOL_NONE;
+    uint32_t offset;
+    if(data >= &HUart_pool[0][0] && data < &HUart_pool[0][0] + sizeof(HUart_pool))
+    {
+        offset = (uint32_t)(data - &HUart_pool[0][0]);
+        if(0 == offset % HUART_POOL_BLOCK_SIZE)
+        {
+            index = (uint8_t)(offset / HUART_POOL_BLOCK_SIZE);
+        }
+    }
+    return index;
+}
+
+/**
+ * @brief Puts a block back at the head of the free list if it has the expected owner
+ * 
+ * @param data the block
+ * @param owner the owner the block must have
+ * @return Std_ReturnType 
+ *                  E_OK: If the block is freed
+ *                  E_NOT_OK: If it is not a pool block with that owner
+ */
+static Std_ReturnType HUart_PoolFree(const uint8_t* data, uint8_t owner)
+{
+    Std_ReturnType error = E_NOT_OK;
+    uint8_t index = HUart_PoolIndex(data);
+    if(HUART_POOL_NONE != index)
+    {
+        NVIC_controlAllPeripheral(NVIC_DISABLE);
+        if(owner == HUart_poolOwner[index])
+        {
+            HUart_poolOwner[index] = HUART_BLOCK_FREE;
+            HUart_poolNext[index] = HUart_poolHead;
+            HUart_poolHead = index;
+            HUart_poolStats.freeBlocks++;
+            error = E_OK;
+        }
+        NVIC_controlAllPeripheral(NVIC_ENABLE);
+    }
+    return error;
+}
+
+/**
+ * @brief Gives a transmit packet back once it is sent or dropped, releasing
+ * its staging buffer or pool block or handing the segments back to their owner
+ * 
+ * @param uartModule the module
+ * @param packet the packet
+ */
+static void HUart_TxRelease(uint8_t uartModule, volatile hUartPacket_t* packet)
+{
+    uint8_t i;
+    for(i=0; i<HUART_STAGE_BUFFERS; i++)
+    {
+        if(packet->data == HUart_stage[uartModule].buffer[i])
+        {
+            HUart_stage[uartModule].busy[i] = 0;
+        }
+    }
+    HUart_PoolFree(packet->data, HUART_BLOCK_DRIVER);
+    if(packet->doneCb)
+    {
+        packet->doneCb(uartModule, packet->segments, packet->nSegments);
+    }
+}
+
+/**
+ * @brief Queues a packet for transmission on a lane of a module applying the
+ * depth limit and the drop policy of the lane
+ * 
+ * @param uartModule the module
+ * @param lane the transmit lane
+ * @param packet the packet to queue
+ * @return Std_ReturnType 
+ *                  E_OK: If the packet is queued
+ *                  E_NOT_OK: If the lane is full
+ */
+static Std_ReturnType HUart_TxPush(uint8_t uartModule, uint8_t lane, hUartPacket_t* packet)
+{
+    Std_ReturnType error = E_NOT_OK;
+    volatile hUartQueue_t* queue = &HUart_txQueue[uartModule][lane];
+    uint8_t depth = HUart_laneDepth[uartModule][lane];
+    hUartPacket_t oldest;
+    if(0 == depth)
+    {
+        depth = UART_QUEUE_LENGTH;
+    }
+    if(queue->nPackets >= depth && HUART_DROP_OLDEST == HUart_lanePolicy[uartModule][lane])
+    {
+        if(E_OK == HUart_QueueGet(queue, &oldest))
+        {
+            HUart_QueuePop(queue);
+            HUart_TxRelease(uartModule, &oldest);
+            HUart_stats[uartModule].laneDropped++;
+        }
+    }
+    if(queue->nPackets < depth)
+    {
+        packet->queuedAt = SYSTICK_getMicros();
+        error = HUart_QueuePush(queue, packet);
+    }
+    if(E_OK == error)
+    {
+        HUart_MarkActive(uartModule);
+    }
+    else
+    {
+        HUart_stats[uartModule].queueFull++;
+    }
+    return error;
+}
+
+/**
+ * @brief Queues the staging buffer that is being filled and starts filling
+ * the other one
+ * 
+ * @param uartModule the module
+ * @return Std_ReturnType 
+ *                  E_OK: If the staged data is queued or there is nothing staged
+ *                  E_NOT_OK: If the other buffer is still being sent or the queue is full
+ */
+static Std_ReturnType HUart_StageFlush(uint8_t uartModule)
+{
+    Std_ReturnType error = E_OK;
+    hUartPacket_t pack;
+    volatile hUartStage_t* stage = &HUart_stage[uartModule];
+    uint8_t fill = stage->fill;
+    uint8_t next = (fill + 1) % HUART_STAGE_BUFFERS;
+    if(stage->length[fill] > 0)
+    {
+        error = E_NOT_OK;
+        if(!stage->busy[next])
+        {
+            pack.data = (uint8_t*)stage->buffer[fill];
+            pack.len = stage->length[fill];
+            pack.segments = NULL;
+            pack.nSegments = 0;
+            pack.doneCb = NULL;
+            pack.address = HUART_NO_ADDRESS;
+            pack.totalTimeout = 0;
+            pack.interByteTimeout = 0;
+            stage->busy[fill] = 1;
+            error = HUart_TxPush(uartModule, HUART_LANE_NORMAL, &pack);
+            if(E_OK == error)
+            {
+                stage->length[next] = 0;
+                stage->fill = next;
+                HUart_stats[uartModule].coalescedTransfers++;
+            }
+            else
+            {
+                stage->busy[fill] = 0;
+            }
+        }
+    }
+    return error;
+}
+
+/**
+ * @brief Copies a small send into the staging buffer of a module, flushing it
+ * first if the data does not fit and after if the threshold is reached
+ * 
+ * @param uartModule the module
+ * @param data the data to send
+ * @param length the length of the data
+ * @return Std_ReturnType 
+ *                  E_OK: If the data is staged
+ *                  E_NOT_OK: If there is no room for the data right now
+ */
+static Std_ReturnType HUart_StageSend(uint8_t uartModule, uint8_t* data, uint16_t length)
+{
+    Std_ReturnType error = E_OK;
+    volatile hUartStage_t* stage = &HUart_stage[uartModule];
+    uint16_t i;
+    if(stage->length[stage->fill] + length > HUART_COALESCE_BUFFER_SIZE)
+    {
+        error = HUart_StageFlush(uartModule);
+    }
+    if(E_OK == error)
+    {
+        if(0 == stage->length[stage->fill])
+        {
+            stage->openedAt = SYSTICK_getMicros();
+        }
+        for(i=0; i<length; i++)
+        {
+            stage->buffer[stage->fill][stage->length[stage->fill] + i] = data[i];
+        }
+        stage->length[stage->fill] += length;
+        HUart_stats[uartModule].coalescedSends++;
+        HUart_MarkActive(uartModule);
+        if(stage->length[stage->fill] >= stage->threshold)
+        {
+            /* If the other buffer is still busy the task flushes it later */
+            HUart_StageFlush(uartModule);
+        }
+    }
+    else
+    {
+        HUart_stats[uartModule].queueFull++;
+    }
+    return error;
+}
+
+/**
+ * @brief Called by the UART driver when a transmission is done on a module
+ * 
+ * @param uartModule the module that finished sending
+ * @param length the number of bytes sent
+ */
+static void HUart_TxDone(uint8_t uartModule, uint16_t length)
+{
+    volatile hUartStats_t* stats = &HUart_stats[uartModule];
+    uint32_t latency;
+    stats->txFrames++;
+    if(HUart_txInFlight[uartModule])
+    {
+        latency = SYSTICK_getMicros() - HUart_txActive[uartModule].queuedAt;
+        if(0 == stats->latencySamples || latency < stats->latencyMinUs)
+        {
+            stats->latencyMinUs = latency;
+        }
+        if(latency > stats->latencyMaxUs)
+        {
+            stats->latencyMaxUs = latency;
+        }
+        stats->latencyTotalUs += latency;
+        stats->latencySamples++;
+        HUart_txInFlight[uartModule] = 0;
+        HUart_TxRelease(uartModule, &HUart_txActive[uartModule]);
+    }
+    if(HUart_txNotify[uartModule])
+    {
+        HUart_txNotify[uartModule](uartModule, length);
+    }
+}
+
+/**
+ * @brief Called by the UART driver when the receive ring buffer of a module
+ * crosses a watermark, RTS is active low
+ * 
+ * @param uartModule the module
+ * @param state UART_FLOW_STOP or UART_FLOW_GO
+ */
+static void HUart_RxFlow(uint8_t uartModule, uint8_t state)
+{
+    if(UART_FLOW_STOP == state)
+    {
+        Gpio_WritePin(HUart_flowPins[uartModule].port, HUart_flowPins[uartModule].rtsPin, GPIO_PIN_SET);
+    }
+    else
+    {
+        Gpio_WritePin(HUart_flowPins[uartModule].port, HUart_flowPins[uartModule].rtsPin, GPIO_PIN_RESET);
+    }
+}
+
+/**
+ * @brief Called by the UART driver to drive the DE/RE pin of a half-duplex
+ * module, it also measures the turnaround time
+ * 
+ * @param uartModule the module
+ * @param state UART_DE_ASSERT, UART_DE_DRAIN or UART_DE_RELEASE
+ */
+static void HUart_DriverEnable(uint8_t uartModule, uint8_t state)
+{
+    volatile hUartDePin_t* de = &HUart_dePin[uartModule];
+    volatile hUartStats_t* stats = &HUart_stats[uartModule];
+    uint32_t turnaround;
+    if(UART_DE_ASSERT == state)
+    {
+        Gpio_WritePin(de->port, de->pin, GPIO_PIN_SET);
+    }
+    else if(UART_DE_DRAIN == state)
+    {
+        de->drainStart = SYSTICK_getMicros();
+    }
+    else
+    {
+        Gpio_WritePin(de->port, de->pin, GPIO_PIN_RESET);
+        /* The last character takes one character time to leave the shift register */
+        turnaround = SYSTICK_getMicros() - de->drainStart;
+        turnaround = (turnaround > de->charTimeUs) ? (turnaround - de->charTimeUs) : 0;
+        if(0 == stats->turnarounds || turnaround < stats->turnaroundMinUs)
+        {
+            stats->turnaroundMinUs = turnaround;
+        }
+        if(turnaround > stats->turnaroundMaxUs)
+        {
+            stats->turnaroundMaxUs = turnaround;
+        }
+        stats->turnaroundTotalUs += turnaround;
+        stats->turnarounds++;
+    }
+}
+
+/**
+ * @brief Called by the UART driver when a reception is done on a module
+ * 
+ * @param uartModule the module that finished receiving
+ * @param length the number of bytes received
+ */
+static void HUart_RxDone(uint8_t uartModule, uint16_t length)
+{
+    HUart_stats[uartModule].rxFrames++;
+    if(HUART_NO_ADDRESS != HUart_address[uartModule])
+    {
+        /* Each receive request is one frame, wait for the next address */
+        Uart_Mute(uartModule);
+    }
+    HUart_rxTimer[uartModule].armed = 0;
+    if(HUart_rxNotify[uartModule])
+    {
+        HUart_rxNotify[uartModule](uartModule, length);
+    }
+    if(HUart_rxStatusCb[uartModule])
+    {
+        HUart_rxStatusCb[uartModule](uartModule, length, HUART_RX_COMPLETE);
+    }
+}
+
+/**
+ * @brief Ages the running receive request of a module and ends it early
+ * if one of its timeouts has expired
+ * 
+ * @param uartModule the module
+ */
+static void HUart_RxTimeout(uint8_t uartModule)
+{
+    volatile hUartRxTimer_t* timer = &HUart_rxTimer[uartModule];
+    uint16_t count = 0;
+    uint8_t status = HUART_RX_COMPLETE;
+    uint32_t now = SYSTICK_getMicros();
+    Uart_GetRxCount(&count, uartModule);
+    if(count != timer->lastCount)
+    {
+        timer->lastCount = count;
+        timer->lastByteAt = now;
+    }
+    if(timer->total && now - timer->startedAt >= (uint32_t)timer->total * 1000)
+    {
+        status = HUART_RX_TIMEOUT;
+    }
+    else if(timer->interByte && count > 0 && now - timer->lastByteAt >= (uint32_t)timer->interByte * 1000)
+    {
+        status = HUART_RX_INTERBYTE_TIMEOUT;
+    }
+    /* The abort fails if the last byte completed the request in the meantime */
+    if(HUART_RX_COMPLETE != status && E_OK == Uart_AbortReceive(&count, uartModule))
+    {
+        timer->armed = 0;
+        HUart_stats[uartModule].rxTimeouts++;
+        if(HUART_NO_ADDRESS != HUart_address[uartModule])
+        {
+            Uart_Mute(uartModule);
+        }
+        if(HUart_rxStatusCb[uartModule])
+        {
+            HUart_rxStatusCb[uartModule](uartModule, count, status);
+        }
+    }
+}
+
+/**
+ * @brief Initializes a specific UART Module
+ * 
+ * @param uartModule The UART module
+ *                  HUART_MODULE_1
+ *                  HUART_MODULE_2
+ *                  HUART_MODULE_3
+ *                  HUART_MODULE_4
+ *                  HUART_MODULE_5
  * @return Std_ReturnType A Status
  *                  E_OK: If the function executed successfully
- *                  E_NOT_OK: If the did not execute successfully
+ *                  E_NOT_OK: If the configured baud rate can't be reached from the bus clock
  */
-Std_ReturnType HUart_Init(void)
+Std_ReturnType HUart_InitOn(uint8_t uartModule)
 {
     gpio_t gpio;
-    if(HUART_NOT_CONFIGURED == isConfigured[HUart_module])
+    uint32_t busClk;
+    uint32_t actualBaud;
+    sint32_t errorPpm;
+    uint32_t frameBits;
+    uint32_t flowControl;
+    Std_ReturnType error;
+    if(uartModule >= UART_NUMBER_OF_MODULES)
+    {
+        return E_NOT_OK;
+    }
+    if(HUART_NOT_CONFIGURED == isConfigured[uartModule])
     {
-        HUart_config[HUart_module].baudRate = HUART_DEFAULT_BAUDRATE;
-        HUart_config[HUart_module].stopBits = HUART_DEFAULT_STOP_BITS;
-        HUart_config[HUart_module].parity = HUART_DEFAULT_PARITY;
-        HUart_config[HUart_module].flowControl = HUART_FLOW_CONTROL_DIS;
+        HUart_config[uartModule].baudRate = HUART_DEFAULT_BAUDRATE;
+        HUart_config[uartModule].stopBits = HUART_DEFAULT_STOP_BITS;
+        HUart_config[uartModule].parity = HUART_DEFAULT_PARITY;
+        HUart_config[uartModule].flowControl = HUART_DEFAULT_FLOW_CONTROL;
     }
-    switch(HUart_module)
+    switch(uartModule)
     {
         case HUART_MODULE_1:
             RCC_controlAPB2Peripheral(RCC_GPIOA, ENABLE);
@@ -188,23 +759,182 @@ Std_ReturnType HUart_Init(void)
             NVIC_controlInterrupt(NVIC_IRQNUM_UART5, NVIC_ENABLE);
             break;
     }
-    Uart_Init(HUart_config[HUart_module].baudRate, HUart_config[HUart_module].stopBits, HUart_config[HUart_module].parity, HUart_config[HUart_module].flowControl, HUART_SYSTEM_CLK, HUart_module);
-    isInitialized[HUart_module] = HUART_INITIALIZED;
-    return E_OK;
-}
-/**
- * @brief Sets configurations for the UART module
- * *The UART must be initialized after setting configurations to apply the changes
- * 
- * @param baudRate the baud rate of the UART (uint32_t)
- * @param stopBits The number of the stop bits
- *                 HUART_ONE_STOP_BIT
- *                 HUART_TWO_STOP_BITS
- * @param parity The parity of the transmission
- *                 HUART_ODD_PARITY
- *                 HUART_EVEN_PARITY
+    flowControl = HUart_config[uartModule].flowControl;
+    if(HUART_FLOW_CONTROL_DIS != flowControl)
+    {
+        if(0 == HUart_flowPins[uartModule].port)
+        {
+            return E_NOT_OK;
+        }
+        gpio.port = HUart_flowPins[uartModule].port;
+        gpio.speed = GPIO_SPEED_50_MHZ;
+        if(flowControl & HUART_FLOW_CONTROL_CTS)
+        {
+            gpio.pins = HUart_flowPins[uartModule].ctsPin;
+            gpio.mode = GPIO_MODE_INPUT_PULL_UP;
+            Gpio_InitPins(&gpio);
+        }
+        if(flowControl & HUART_FLOW_CONTROL_RTS)
+        {
+            /* RTS is driven from the receive ring buffer fill level rather than by the
+               peripheral, which would only hold it off for the single byte in DR */
+            gpio.pins = HUart_flowPins[uartModule].rtsPin;
+            gpio.mode = GPIO_MODE_GP_OUTPUT_PP;
+            Gpio_InitPins(&gpio);
+            Gpio_WritePin(gpio.port, gpio.pins, GPIO_PIN_RESET);
+            Uart_SetRxFlowCb(HUart_RxFlow, uartModule);
+        }
+        else
+        {
+            Uart_SetRxFlowCb(NULL, uartModule);
+        }
+    }
+    else
+    {
+        Uart_SetRxFlowCb(NULL, uartModule);
+    }
+    if(HUART_CLOCK_DIS != HUart_clockMode[uartModule])
+    {
+        if(0 == HUart_flowPins[uartModule].port)
+        {
+            return E_NOT_OK;
+        }
+        gpio.port = HUart_flowPins[uartModule].port;
+        gpio.pins = HUart_flowPins[uartModule].ckPin;
+        gpio.mode = GPIO_MODE_AF_OUTPUT_PP;
+        gpio.speed = GPIO_SPEED_50_MHZ;
+        Gpio_InitPins(&gpio);
+    }
+    if(HUart_dePin[uartModule].port)
+    {
+        gpio.port = HUart_dePin[uartModule].port;
+        gpio.pins = HUart_dePin[uartModule].pin;
+        gpio.mode = GPIO_MODE_GP_OUTPUT_PP;
+        gpio.speed = GPIO_SPEED_50_MHZ;
+        Gpio_InitPins(&gpio);
+        Gpio_WritePin(gpio.port, gpio.pins, GPIO_PIN_RESET);
+        Uart_SetDriverEnableCb(HUart_DriverEnable, uartModule);
+    }
+    else
+    {
+        Uart_SetDriverEnableCb(NULL, uartModule);
+    }
+    if(HUART_MODULE_1 == uartModule)
+    {
+        busClk = RCC_getBusClock(RCC_APB2_PRESCALER, HUART_SYSTEM_CLK);
+    }
+    else
+    {
+        busClk = RCC_getBusClock(RCC_APB1_PRESCALER, HUART_SYSTEM_CLK);
+    }
+    Uart_SetTxDoneCb(HUart_TxDone, uartModule);
+    Uart_SetRxDoneCb(HUart_RxDone, uartModule);
+    /* Only CTS is handed to the peripheral, RTS is left out on purpose because it is
+       driven in software from the receive ring buffer watermarks (HUart_RxFlow) */
+    if(flowControl & HUART_FLOW_CONTROL_CTS)
+    {
+        flowControl = UART_FLOW_CONTROL_CTS;
+    }
+    else
+    {
+        flowControl = UART_FLOW_CONTROL_DIS;
+    }
+    error = Uart_Init(HUart_config[uartModule].baudRate, HUart_config[uartModule].stopBits, HUart_config[uartModule].parity, flowControl, busClk, uartModule);
+    if(E_OK == error && HUart_flowPins[uartModule].port)
+    {
+        error = Uart_SetClockMode(HUart_clockMode[uartModule], uartModule);
+    }
+    if(E_OK == error && HUART_NO_ADDRESS != HUart_address[uartModule])
+    {
+        error = Uart_SetAddress(HUart_address[uartModule], uartModule);
+    }
+    if(E_OK == error)
+    {
+        /* Start bit, 8 data bits, the parity bit and the stop bits */
+        Uart_GetBaudRate(&actualBaud, &errorPpm, uartModule);
+        frameBits = 10;
+        if(HUART_NO_PARITY != HUart_config[uartModule].parity)
+        {
+            frameBits++;
+        }
+        if(HUART_STOP_TWO_BITS == HUart_config[uartModule].stopBits)
+        {
+            frameBits++;
+        }
+        HUart_dePin[uartModule].charTimeUs = (frameBits * 1000000UL) / actualBaud;
+    }
+    if(E_OK == error)
+    {
+        isInitialized[uartModule] = HUART_INITIALIZED;
+    }
+    return error;
+}
+/**
+ * @brief Initializes the UART Module
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+Std_ReturnType HUart_Init(void)
+{
+    return HUart_InitOn(HUart_module);
+}
+/**
+ * @brief Sets configurations for a specific UART module
+ * *The UART must be initialized after setting configurations to apply the changes
+ * 
+ * @param uartModule The UART module
+ *                  HUART_MODULE_1
+ *                  HUART_MODULE_2
+ *                  HUART_MODULE_3
+ *                  HUART_MODULE_4
+ *                  HUART_MODULE_5
+ * @param baudRate the baud rate of the UART (uint32_t)
+ * @param stopBits The number of the stop bits
+ *                 HUART_ONE_STOP_BIT
+ *                 HUART_TWO_STOP_BITS
+ * @param parity The parity of the transmission
+ *                 HUART_ODD_PARITY
+ *                 HUART_EVEN_PARITY
+ *                 HUART_NO_PARITY
+ * @param flowControl the flow control (only UART1 to UART3 have the pins for it)
+ *                 HUART_FLOW_CONTROL_RTS
+ *                 HUART_FLOW_CONTROL_CTS
+ *                 HUART_FLOW_CONTROL_EN
+ *                 HUART_FLOW_CONTROL_DIS
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+Std_ReturnType HUart_ConfigOn(uint8_t uartModule, uint32_t baudRate, uint32_t stopBits, uint32_t parity, uint32_t flowControl)
+{
+    Std_ReturnType error = E_NOT_OK;
+    if(uartModule < UART_NUMBER_OF_MODULES)
+    {
+        HUart_config[uartModule].baudRate = baudRate;
+        HUart_config[uartModule].stopBits = stopBits;
+        HUart_config[uartModule].parity = parity;
+        HUart_config[uartModule].flowControl = flowControl;
+        isConfigured[uartModule] = HUART_CONFIGURED;
+        error = E_OK;
+    }
+    return error;
+}
+/**
+ * @brief Sets configurations for the UART module
+ * *The UART must be initialized after setting configurations to apply the changes
+ * 
+ * @param baudRate the baud rate of the UART (uint32_t)
+ * @param stopBits The number of the stop bits
+ *                 HUART_ONE_STOP_BIT
+ *                 HUART_TWO_STOP_BITS
+ * @param parity The parity of the transmission
+ *                 HUART_ODD_PARITY
+ *                 HUART_EVEN_PARITY
  *                 HUART_NO_PARITY
- * @param flowControl the flow control
+ * @param flowControl the flow control (only UART1 to UART3 have the pins for it)
+ *                 HUART_FLOW_CONTROL_RTS
+ *                 HUART_FLOW_CONTROL_CTS
  *                 HUART_FLOW_CONTROL_EN
  *                 HUART_FLOW_CONTROL_DIS
  * @return Std_ReturnType A Status
@@ -213,12 +943,31 @@ Std_ReturnType HUart_Init(void)
  */
 Std_ReturnType HUart_Config(uint32_t baudRate, uint32_t stopBits, uint32_t parity, uint32_t flowControl)
 {
-    HUart_config[HUart_module].baudRate = baudRate;
-    HUart_config[HUart_module].stopBits = stopBits;
-    HUart_config[HUart_module].parity = parity;
-    HUart_config[HUart_module].flowControl = flowControl;
-    isConfigured[HUart_module] = HUART_CONFIGURED;
-    return E_OK;
+    return HUart_ConfigOn(HUart_module, baudRate, stopBits, parity, flowControl);
+}
+/**
+ * @brief Gets the baud rate achieved on a specific UART module
+ *
+ * @param uartModule The UART module
+ *                  HUART_MODULE_1
+ *                  HUART_MODULE_2
+ *                  HUART_MODULE_3
+ *                  HUART_MODULE_4
+ *                  HUART_MODULE_5
+ * @param actualBaud the baud rate generated from the bus clock
+ * @param errorPpm the difference from the configured baud rate in ppm
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the module is not initialized
+ */
+Std_ReturnType HUart_GetBaudRateOn(uint8_t uartModule, uint32_t* actualBaud, sint32_t* errorPpm)
+{
+    Std_ReturnType error = E_NOT_OK;
+    if(uartModule < UART_NUMBER_OF_MODULES && HUART_INITIALIZED == isInitialized[uartModule])
+    {
+        error = Uart_GetBaudRate(actualBaud, errorPpm, uartModule);
+    }
+    return error;
 }
 /**
  * @brief Sets the module that you will be using
@@ -235,103 +984,911 @@ Std_ReturnType HUart_Config(uint32_t baudRate, uint32_t stopBits, uint32_t parit
  */
 Std_ReturnType HUart_SetModule(uint8_t uartModule)
 {
-    HUart_module = uartModule;
-    return E_OK;
+    Std_ReturnType error = E_NOT_OK;
+    if(uartModule < UART_NUMBER_OF_MODULES)
+    {
+        HUart_module = uartModule;
+        error = E_OK;
+    }
+    return error;
 }
 /**
- * @brief Sends data through the UART
+ * @brief Sends data through a specific UART module
+ * *With coalescing enabled small sends are copied, so the buffer can be reused on return
  *
+ * @param uartModule The UART module
+ *                  HUART_MODULE_1
+ *                  HUART_MODULE_2
+ *                  HUART_MODULE_3
+ *                  HUART_MODULE_4
+ *                  HUART_MODULE_5
  * @param data The data to send
  * @param length the length of the data in bytes
  * @return Std_ReturnType A Status
  *                  E_OK: If the driver is ready to send
  *                  E_NOT_OK: If the driver can't send data right now
  */
-Std_ReturnType HUart_Send(uint8_t *data, uint16_t length)
+Std_ReturnType HUart_SendOn(uint8_t uartModule, uint8_t *data, uint16_t length)
 {
     Std_ReturnType error = E_NOT_OK;
     hUartPacket_t pack;
-    if(HUART_INITIALIZED == isInitialized[HUart_module])
+    if(uartModule < UART_NUMBER_OF_MODULES && HUART_INITIALIZED == isInitialized[uartModule])
     {
-        pack.data = data;
-        pack.len = length;
-        error = HUart_QueuePush(&HUart_txQueue[HUart_module], &pack);
+        if(HUart_stage[uartModule].window > 0 && length <= HUART_COALESCE_BUFFER_SIZE)
+        {
+            error = HUart_StageSend(uartModule, data, length);
+        }
+        else if(E_OK == HUart_StageFlush(uartModule))
+        {
+            pack.data = data;
+            pack.len = length;
+            pack.segments = NULL;
+            pack.nSegments = 0;
+            pack.doneCb = NULL;
+            pack.address = HUART_NO_ADDRESS;
+            pack.totalTimeout = 0;
+            pack.interByteTimeout = 0;
+            error = HUart_TxPush(uartModule, HUART_LANE_NORMAL, &pack);
+        }
     }
     return error;
 }
 /**
- * @brief Receives data through the UART
+ * @brief Sends data through a specific UART module on a priority lane
+ * *Queued packets of the high lane always go out before the ones of the normal lane
  *
- * @param data The buffer to receive data in
+ * @param uartModule The UART module
+ *                  HUART_MODULE_1
+ *                  HUART_MODULE_2
+ *                  HUART_MODULE_3
+ *                  HUART_MODULE_4
+ *                  HUART_MODULE_5
+ * @param lane The transmit lane
+ *                  HUART_LANE_HIGH
+ *                  HUART_LANE_NORMAL
+ * @param data The data to send
  * @param length the length of the data in bytes
  * @return Std_ReturnType A Status
- *                  E_OK: If the driver is ready to receive
- *                  E_NOT_OK: If the driver can't receive data right now
+ *                  E_OK: If the driver is ready to send
+ *                  E_NOT_OK: If the driver can't send data right now
  */
-Std_ReturnType HUart_Receive(uint8_t *data, uint16_t length)
+Std_ReturnType HUart_SendPriorityOn(uint8_t uartModule, uint8_t lane, uint8_t *data, uint16_t length)
 {
     Std_ReturnType error = E_NOT_OK;
     hUartPacket_t pack;
-    if(HUART_INITIALIZED == isInitialized[HUart_module])
+    if(HUART_LANE_NORMAL == lane)
+    {
+        error = HUart_SendOn(uartModule, data, length);
+    }
+    else if(uartModule < UART_NUMBER_OF_MODULES && lane < HUART_TX_LANES && HUART_INITIALIZED == isInitialized[uartModule])
     {
         pack.data = data;
         pack.len = length;
-        error = HUart_QueuePush(&HUart_rxQueue[HUart_module], &pack);
+        pack.segments = NULL;
+        pack.nSegments = 0;
+        pack.doneCb = NULL;
+        pack.address = HUART_NO_ADDRESS;
+        pack.totalTimeout = 0;
+        pack.interByteTimeout = 0;
+        error = HUart_TxPush(uartModule, lane, &pack);
     }
     return error;
 }
 /**
- * @brief Sets the callback function that will be called when receive is
- * completed
+ * @brief Sets the depth limit and the drop policy of a transmit lane
+ * *Lanes using HUART_DROP_OLDEST must be fed from task level
  *
- * @param func the callback function
+ * @param uartModule The UART module
+ *                  HUART_MODULE_1
+ *                  HUART_MODULE_2
+ *                  HUART_MODULE_3
+ *                  HUART_MODULE_4
+ *                  HUART_MODULE_5
+ * @param lane The transmit lane
+ *                  HUART_LANE_HIGH
+ *                  HUART_LANE_NORMAL
+ * @param depth The maximum number of queued packets (1 to 5)
+ * @param policy What happens to a send when the lane is full
+ *                  HUART_DROP_REJECT: The new packet is rejected
+ *                  HUART_DROP_OLDEST: The oldest queued packet is dropped
  * @return Std_ReturnType A Status
  *                  E_OK: If the function executed successfully
  *                  E_NOT_OK: If the did not execute successfully
  */
-Std_ReturnType HUart_SetRxCb(hUartRxCb_t func)
+Std_ReturnType HUart_SetLanePolicyOn(uint8_t uartModule, uint8_t lane, uint8_t depth, uint8_t policy)
 {
-    Uart_SetRxCb(func, HUart_module);
-    return E_OK;
+    Std_ReturnType error = E_NOT_OK;
+    if(uartModule < UART_NUMBER_OF_MODULES && lane < HUART_TX_LANES && depth > 0 && depth <= UART_QUEUE_LENGTH
+        && (HUART_DROP_REJECT == policy || HUART_DROP_OLDEST == policy))
+    {
+        HUart_laneDepth[uartModule][lane] = depth;
+        HUart_lanePolicy[uartModule][lane] = policy;
+        error = E_OK;
+    }
+    return error;
 }
 /**
- * @brief Sets the callback function that will be called when transmission is
- * completed
+ * @brief Sends data to one node on a multi-drop bus through a specific UART module
+ * *Only the node with this address wakes up to receive it
  *
- * @param func the callback function
+ * @param uartModule The UART module
+ *                  HUART_MODULE_1
+ *                  HUART_MODULE_2
+ *                  HUART_MODULE_3
+ *                  HUART_MODULE_4
+ *                  HUART_MODULE_5
+ * @param address The address of the receiving node (0 to 15)
+ * @param data The data to send
+ * @param length the length of the data in bytes
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the driver is ready to send
+ *                  E_NOT_OK: If the driver can't send data right now
+ */
+Std_ReturnType HUart_SendToOn(uint8_t uartModule, uint8_t address, uint8_t *data, uint16_t length)
+{
+    Std_ReturnType error = E_NOT_OK;
+    hUartPacket_t pack;
+    if(uartModule < UART_NUMBER_OF_MODULES && HUART_INITIALIZED == isInitialized[uartModule]
+        && HUART_NO_ADDRESS != HUart_address[uartModule] && address <= HUART_MAX_ADDRESS)
+    {
+        if(E_OK == HUart_StageFlush(uartModule))
+        {
+            pack.data = data;
+            pack.len = length;
+            pack.segments = NULL;
+            pack.nSegments = 0;
+            pack.doneCb = NULL;
+            pack.address = address;
+            pack.totalTimeout = 0;
+            pack.interByteTimeout = 0;
+            error = HUart_TxPush(uartModule, HUART_LANE_NORMAL, &pack);
+        }
+    }
+    return error;
+}
+/**
+ * @brief Puts a specific module in half-duplex (RS-485) mode with a GPIO driving
+ * the DE/RE pins of the transceiver, the pin is high while transmitting
+ * *The pin is asserted before the first byte and released on the transmission
+ * complete interrupt once the last stop bit is out
+ *
+ * @param uartModule The UART module
+ *                  HUART_MODULE_1
+ *                  HUART_MODULE_2
+ *                  HUART_MODULE_3
+ *                  HUART_MODULE_4
+ *                  HUART_MODULE_5
+ * @param port the port of the DE/RE pin or 0 to go back to full-duplex
+ * @param pin the DE/RE pin
  * @return Std_ReturnType A Status
  *                  E_OK: If the function executed successfully
  *                  E_NOT_OK: If the did not execute successfully
  */
-Std_ReturnType HUart_SetTxCb(hUartTxCb_t func)
+Std_ReturnType HUart_SetDriverEnablePinOn(uint8_t uartModule, uint32_t port, uint32_t pin)
 {
-    Uart_SetTxCb(func, HUart_module);
-    return E_OK;
+    Std_ReturnType error = E_NOT_OK;
+    if(uartModule < UART_NUMBER_OF_MODULES)
+    {
+        HUart_dePin[uartModule].port = port;
+        HUart_dePin[uartModule].pin = pin;
+        error = E_OK;
+        if(HUART_INITIALIZED == isInitialized[uartModule])
+        {
+            /* Re-initializing applies the new mode */
+            error = HUart_InitOn(uartModule);
+        }
+    }
+    return error;
 }
-
 /**
- * @brief The HUart Running task to handle the UART Requests
- * 
+ * @brief Puts a specific module in synchronous mode, the module drives the
+ * clock on its CK pin so the link can run faster than in asynchronous mode
+ * *The module is always the clock master, the other board has to take the
+ * clock in as a slave
+ *
+ * @param uartModule The UART module
+ *                  HUART_MODULE_1
+ *                  HUART_MODULE_2
+ *                  HUART_MODULE_3
+ * @param clockMode HUART_CLOCK_DIS to go back to asynchronous mode or HUART_CLOCK_EN combined with
+ *                  HUART_CLOCK_CPOL_HIGH: CK is high when idle
+ *                  HUART_CLOCK_CPHA_SECOND: Data is captured on the second clock edge
+ *                  HUART_CLOCK_LAST_BIT: A clock pulse is given for the last data bit
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the module has no CK pin (HUART_MODULE_4 and HUART_MODULE_5)
  */
-void HUart_Task(void)
+Std_ReturnType HUart_SetClockModeOn(uint8_t uartModule, uint32_t clockMode)
 {
-    uint8_t i;
-    hUartPacket_t packet;
-    for(i=0; i<UART_NUMBER_OF_MODULES; i++)
+    Std_ReturnType error = E_NOT_OK;
+    if(uartModule < UART_NUMBER_OF_MODULES && (HUART_CLOCK_DIS == clockMode || HUart_flowPins[uartModule].port))
     {
-        if(E_OK == HUart_QueueGet(&HUart_rxQueue[i], &packet))
+        HUart_clockMode[uartModule] = clockMode;
+        error = E_OK;
+        if(HUART_INITIALIZED == isInitialized[uartModule])
         {
-            if(E_OK == Uart_Receive(packet.data, packet.len, i))
-            {
-                HUart_QueuePop(&HUart_rxQueue[i]);
+            /* Re-initializing applies the new mode */
+            error = HUart_InitOn(uartModule);
+        }
+    }
+    return error;
+}
+/**
+ * @brief Sets the address of this node for the multi-drop mode of a specific module
+ * *The receiver is muted in hardware between frames and only wakes up for its own
+ * address, each receive request is taken as one frame
+ * *Multi-drop needs the module to be configured without parity
+ *
+ * @param uartModule The UART module
+ *                  HUART_MODULE_1
+ *                  HUART_MODULE_2
+ *                  HUART_MODULE_3
+ *                  HUART_MODULE_4
+ *                  HUART_MODULE_5
+ * @param address The address of this node (0 to 15) or HUART_NO_ADDRESS to leave multi-drop mode
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+Std_ReturnType HUart_SetNodeAddressOn(uint8_t uartModule, uint8_t address)
+{
+    Std_ReturnType error = E_NOT_OK;
+    if(uartModule < UART_NUMBER_OF_MODULES && (address <= HUART_MAX_ADDRESS || HUART_NO_ADDRESS == address))
+    {
+        HUart_address[uartModule] = address;
+        error = E_OK;
+        if(HUART_INITIALIZED == isInitialized[uartModule])
+        {
+            /* Re-initializing applies the new mode */
+            error = HUart_InitOn(uartModule);
+        }
+    }
+    return error;
+}
+/**
+ * @brief Sends a list of segments back to back through a specific UART module
+ * without copying them into one buffer
+ * *The segments list and the buffers it points to are owned by the driver until
+ * the done callback is called
+ *
+ * @param uartModule The UART module
+ *                  HUART_MODULE_1
+ *                  HUART_MODULE_2
+ *                  HUART_MODULE_3
+ *                  HUART_MODULE_4
+ *                  HUART_MODULE_5
+ * @param segments The segments to send
+ * @param nSegments The number of segments
+ * @param doneCb The function called when the last segment is sent to give back the buffers (can be NULL)
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the driver is ready to send
+ *                  E_NOT_OK: If the driver can't send data right now
+ */
+Std_ReturnType HUart_SendSegmentsOn(uint8_t uartModule, const hUartSegment_t* segments, uint8_t nSegments, hUartSgDoneCb_t doneCb)
+{
+    Std_ReturnType error = E_NOT_OK;
+    hUartPacket_t pack;
+    if(uartModule < UART_NUMBER_OF_MODULES && HUART_INITIALIZED == isInitialized[uartModule] && segments && nSegments > 0)
+    {
+        pack.data = NULL;
+        pack.len = 0;
+        pack.segments = segments;
+        pack.nSegments = nSegments;
+        pack.doneCb = doneCb;
+        pack.address = HUART_NO_ADDRESS;
+        pack.totalTimeout = 0;
+        pack.interByteTimeout = 0;
+        if(E_OK == HUart_StageFlush(uartModule))
+        {
+            error = HUart_TxPush(uartModule, HUART_LANE_NORMAL, &pack);
+        }
+    }
+    return error;
+}
+/**
+ * @brief Sends data through the UART
+ *
+ * @param data The data to send
+ * @param length the length of the data in bytes
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the driver is ready to send
+ *                  E_NOT_OK: If the driver can't send data right now
+ */
+Std_ReturnType HUart_Send(uint8_t *data, uint16_t length)
+{
+    return HUart_SendOn(HUart_module, data, length);
+}
+/**
+ * @brief Receives data through a specific UART module with timeouts
+ * *When a timeout expires the request ends early and the bytes received so far
+ * are reported through the receive status callback
+ *
+ * @param uartModule The UART module
+ *                  HUART_MODULE_1
+ *                  HUART_MODULE_2
+ *                  HUART_MODULE_3
+ *                  HUART_MODULE_4
+ *                  HUART_MODULE_5
+ * @param data The buffer to receive data in
+ * @param length the length of the data in bytes
+ * @param totalTimeout the time in milliseconds allowed for the whole request or 0 to wait forever
+ * @param interByteTimeout the time in milliseconds allowed between two bytes once the
+ * first byte is received or 0 for no limit
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the driver is ready to receive
+ *                  E_NOT_OK: If the driver can't receive data right now
+ */
+Std_ReturnType HUart_ReceiveTimeoutOn(uint8_t uartModule, uint8_t *data, uint16_t length, uint16_t totalTimeout, uint16_t interByteTimeout)
+{
+    Std_ReturnType error = E_NOT_OK;
+    hUartPacket_t pack;
+    if(uartModule < UART_NUMBER_OF_MODULES && HUART_INITIALIZED == isInitialized[uartModule])
+    {
+        pack.data = data;
+        pack.len = length;
+        pack.segments = NULL;
+        pack.nSegments = 0;
+        pack.doneCb = NULL;
+        pack.address = HUART_NO_ADDRESS;
+        pack.totalTimeout = totalTimeout;
+        pack.interByteTimeout = interByteTimeout;
+        error = HUart_QueuePush(&HUart_rxQueue[uartModule], &pack);
+        if(E_OK == error)
+        {
+            HUart_MarkActive(uartModule);
+        }
+        else
+        {
+            HUart_stats[uartModule].queueFull++;
+        }
+    }
+    return error;
+}
+/**
+ * @brief Receives data through a specific UART module
+ *
+ * @param uartModule The UART module
+ *                  HUART_MODULE_1
+ *                  HUART_MODULE_2
+ *                  HUART_MODULE_3
+ *                  HUART_MODULE_4
+ *                  HUART_MODULE_5
+ * @param data The buffer to receive data in
+ * @param length the length of the data in bytes
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the driver is ready to receive
+ *                  E_NOT_OK: If the driver can't receive data right now
+ */
+Std_ReturnType HUart_ReceiveOn(uint8_t uartModule, uint8_t *data, uint16_t length)
+{
+    return HUart_ReceiveTimeoutOn(uartModule, data, length, 0, 0);
+}
+/**
+ * @brief Reads the bytes that arrived on a specific UART module while no receive
+ * request was waiting, it does not wait for more so it suits byte stream decoders
+ *
+ * @param uartModule The UART module
+ *                  HUART_MODULE_1
+ *                  HUART_MODULE_2
+ *                  HUART_MODULE_3
+ *                  HUART_MODULE_4
+ *                  HUART_MODULE_5
+ * @param data The buffer to read into
+ * @param maxLength the size of the buffer in bytes
+ * @param count the number of bytes read
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+Std_ReturnType HUart_ReadOn(uint8_t uartModule, uint8_t *data, uint16_t maxLength, uint16_t *count)
+{
+    Std_ReturnType error = E_NOT_OK;
+    if(uartModule < UART_NUMBER_OF_MODULES && HUART_INITIALIZED == isInitialized[uartModule])
+    {
+        error = Uart_Read(data, maxLength, count, uartModule);
+    }
+    return error;
+}
+/**
+ * @brief Receives data through the UART
+ *
+ * @param data The buffer to receive data in
+ * @param length the length of the data in bytes
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the driver is ready to receive
+ *                  E_NOT_OK: If the driver can't receive data right now
+ */
+Std_ReturnType HUart_Receive(uint8_t *data, uint16_t length)
+{
+    return HUart_ReceiveOn(HUart_module, data, length);
+}
+/**
+ * @brief Sets the callback function that will be called when receive is
+ * completed
+ *
+ * @param func the callback function
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+Std_ReturnType HUart_SetRxCb(hUartRxCb_t func)
+{
+    Uart_SetRxCb(func, HUart_module);
+    return E_OK;
+}
+/**
+ * @brief Sets the callback function that will be called when transmission is
+ * completed
+ *
+ * @param func the callback function
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+Std_ReturnType HUart_SetTxCb(hUartTxCb_t func)
+{
+    Uart_SetTxCb(func, HUart_module);
+    return E_OK;
+}
+/**
+ * @brief Sets the callback function that will be called when a receive request
+ * on a specific module is completed
+ *
+ * @param uartModule The UART module
+ *                  HUART_MODULE_1
+ *                  HUART_MODULE_2
+ *                  HUART_MODULE_3
+ *                  HUART_MODULE_4
+ *                  HUART_MODULE_5
+ * @param func the callback function, it receives the module and the number of bytes received
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+Std_ReturnType HUart_SetRxNotifyOn(uint8_t uartModule, hUartNotifyCb_t func)
+{
+    Std_ReturnType error = E_NOT_OK;
+    if(uartModule < UART_NUMBER_OF_MODULES)
+    {
+        HUart_rxNotify[uartModule] = func;
+        error = E_OK;
+    }
+    return error;
+}
+/**
+ * @brief Sets the callback function that will be called when a receive request
+ * on a specific module ends, either completed or timed out
+ *
+ * @param uartModule The UART module
+ *                  HUART_MODULE_1
+ *                  HUART_MODULE_2
+ *                  HUART_MODULE_3
+ *                  HUART_MODULE_4
+ *                  HUART_MODULE_5
+ * @param func the callback function, it receives the module, the number of bytes
+ * received and the status
+ *                  HUART_RX_COMPLETE
+ *                  HUART_RX_TIMEOUT
+ *                  HUART_RX_INTERBYTE_TIMEOUT
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+Std_ReturnType HUart_SetRxStatusCbOn(uint8_t uartModule, hUartRxStatusCb_t func)
+{
+    Std_ReturnType error = E_NOT_OK;
+    if(uartModule < UART_NUMBER_OF_MODULES)
+    {
+        HUart_rxStatusCb[uartModule] = func;
+        error = E_OK;
+    }
+    return error;
+}
+/**
+ * @brief Sets the callback function that will be called when a transmission
+ * on a specific module is completed
+ *
+ * @param uartModule The UART module
+ *                  HUART_MODULE_1
+ *                  HUART_MODULE_2
+ *                  HUART_MODULE_3
+ *                  HUART_MODULE_4
+ *                  HUART_MODULE_5
+ * @param func the callback function, it receives the module and the number of bytes sent
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+Std_ReturnType HUart_SetTxNotifyOn(uint8_t uartModule, hUartNotifyCb_t func)
+{
+    Std_ReturnType error = E_NOT_OK;
+    if(uartModule < UART_NUMBER_OF_MODULES)
+    {
+        HUart_txNotify[uartModule] = func;
+        error = E_OK;
+    }
+    return error;
+}
+
+/**
+ * @brief Enables or disables the coalescing of small sends on a specific module
+ * *Sends that fit in HUART_COALESCE_BUFFER_SIZE are copied into a staging buffer
+ * that goes out as one transfer when the window elapses or the threshold is reached
+ * *Coalesced sends must be issued from task level
+ *
+ * @param uartModule The UART module
+ *                  HUART_MODULE_1
+ *                  HUART_MODULE_2
+ *                  HUART_MODULE_3
+ *                  HUART_MODULE_4
+ *                  HUART_MODULE_5
+ * @param windowMs The longest time data waits in the staging buffer, 0 disables coalescing
+ * @param threshold The number of staged bytes that triggers the transfer right away
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+Std_ReturnType HUart_SetCoalescingOn(uint8_t uartModule, uint16_t windowMs, uint16_t threshold)
+{
+    Std_ReturnType error = E_NOT_OK;
+    if(uartModule < UART_NUMBER_OF_MODULES && threshold <= HUART_COALESCE_BUFFER_SIZE)
+    {
+        if(0 == windowMs)
+        {
+            error = HUart_StageFlush(uartModule);
+        }
+        else
+        {
+            error = E_OK;
+        }
+        if(E_OK == error)
+        {
+            HUart_stage[uartModule].threshold = threshold;
+            HUart_stage[uartModule].window = windowMs;
+        }
+    }
+    return error;
+}
+/**
+ * @brief Sends whatever is in the staging buffer of a specific module now
+ *
+ * @param uartModule The UART module
+ *                  HUART_MODULE_1
+ *                  HUART_MODULE_2
+ *                  HUART_MODULE_3
+ *                  HUART_MODULE_4
+ *                  HUART_MODULE_5
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the staged data is queued or nothing is staged
+ *                  E_NOT_OK: If the previous transfer is still going, try again later
+ */
+Std_ReturnType HUart_FlushOn(uint8_t uartModule)
+{
+    Std_ReturnType error = E_NOT_OK;
+    if(uartModule < UART_NUMBER_OF_MODULES)
+    {
+        error = HUart_StageFlush(uartModule);
+    }
+    return error;
+}
+/**
+ * @brief Takes a block from the transmit buffer pool, the caller owns it until
+ * it is sent with HUart_SendBlockOn or given back with HUart_FreeBlock
+ *
+ * @param block where to put the address of the block, it holds HUART_POOL_BLOCK_SIZE bytes
+ * @return Std_ReturnType A Status
+ *                  E_OK: If a block is allocated
+ *                  E_NOT_OK: If the pool is empty
+ */
+Std_ReturnType HUart_AllocBlock(uint8_t** block)
+{
+    Std_ReturnType error = E_NOT_OK;
+    uint8_t index;
+    if(block)
+    {
+        NVIC_controlAllPeripheral(NVIC_DISABLE);
+        if(!HUart_poolReady)
+        {
+            HUart_PoolInit();
+        }
+        HUart_poolStats.allocs++;
+        index = HUart_poolHead;
+        if(HUART_POOL_NONE != index)
+        {
+            HUart_poolHead = HUart_poolNext[index];
+            HUart_poolOwner[index] = HUART_BLOCK_CALLER;
+            HUart_poolStats.freeBlocks--;
+            if(HUart_poolStats.freeBlocks < HUart_poolStats.minFreeBlocks)
+            {
+                HUart_poolStats.minFreeBlocks = HUart_poolStats.freeBlocks;
+            }
+            *block = HUart_pool[index];
+            error = E_OK;
+        }
+        else
+        {
+            HUart_poolStats.exhausted++;
+        }
+        NVIC_controlAllPeripheral(NVIC_ENABLE);
+    }
+    return error;
+}
+/**
+ * @brief Gives a block that will not be sent back to the transmit buffer pool
+ *
+ * @param block the block
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the block is freed
+ *                  E_NOT_OK: If it is not a pool block owned by the caller
+ */
+Std_ReturnType HUart_FreeBlock(uint8_t* block)
+{
+    return HUart_PoolFree(block, HUART_BLOCK_CALLER);
+}
+/**
+ * @brief Sends a pool block through a specific UART module, the driver owns
+ * the block from now on and frees it once it is sent or dropped
+ * *The block is freed as well if it can't be queued
+ *
+ * @param uartModule The UART module
+ *                  HUART_MODULE_1
+ *                  HUART_MODULE_2
+ *                  HUART_MODULE_3
+ *                  HUART_MODULE_4
+ *                  HUART_MODULE_5
+ * @param block the block taken with HUart_AllocBlock
+ * @param length the number of bytes to send from the block
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the block is queued
+ *                  E_NOT_OK: If the block is not owned by the caller or can't be queued
+ */
+Std_ReturnType HUart_SendBlockOn(uint8_t uartModule, uint8_t* block, uint16_t length)
+{
+    Std_ReturnType error = E_NOT_OK;
+    hUartPacket_t pack;
+    uint8_t index = HUart_PoolIndex(block);
+    if(HUART_POOL_NONE != index && HUART_BLOCK_CALLER == HUart_poolOwner[index])
+    {
+        HUart_poolOwner[index] = HUART_BLOCK_DRIVER;
+        if(uartModule < UART_NUMBER_OF_MODULES && HUART_INITIALIZED == isInitialized[uartModule]
+            && length > 0 && length <= HUART_POOL_BLOCK_SIZE && E_OK == HUart_StageFlush(uartModule))
+        {
+            pack.data = block;
+            pack.len = length;
+            pack.segments = NULL;
+            pack.nSegments = 0;
+            pack.doneCb = NULL;
+            pack.address = HUART_NO_ADDRESS;
+            pack.totalTimeout = 0;
+            pack.interByteTimeout = 0;
+            error = HUart_TxPush(uartModule, HUART_LANE_NORMAL, &pack);
+        }
+        if(E_NOT_OK == error)
+        {
+            HUart_PoolFree(block, HUART_BLOCK_DRIVER);
+        }
+    }
+    return error;
+}
+/**
+ * @brief Gets the statistics of the transmit buffer pool
+ *
+ * @param stats where to copy the statistics
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+Std_ReturnType HUart_GetPoolStats(hUartPoolStats_t* stats)
+{
+    Std_ReturnType error = E_NOT_OK;
+    if(stats)
+    {
+        NVIC_controlAllPeripheral(NVIC_DISABLE);
+        if(!HUart_poolReady)
+        {
+            HUart_PoolInit();
+        }
+        stats->allocs = HUart_poolStats.allocs;
+        stats->exhausted = HUart_poolStats.exhausted;
+        stats->freeBlocks = HUart_poolStats.freeBlocks;
+        stats->minFreeBlocks = HUart_poolStats.minFreeBlocks;
+        NVIC_controlAllPeripheral(NVIC_ENABLE);
+        error = E_OK;
+    }
+    return error;
+}
+/**
+ * @brief Gets the statistics of a specific UART module
+ *
+ * @param uartModule The UART module
+ *                  HUART_MODULE_1
+ *                  HUART_MODULE_2
+ *                  HUART_MODULE_3
+ *                  HUART_MODULE_4
+ *                  HUART_MODULE_5
+ * @param stats where to copy the statistics
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+Std_ReturnType HUart_GetStatsOn(uint8_t uartModule, hUartStats_t* stats)
+{
+    Std_ReturnType error = E_NOT_OK;
+    uartStats_t uartStats;
+    uint8_t lane;
+    if(uartModule < UART_NUMBER_OF_MODULES && stats)
+    {
+        Uart_GetStats(&uartStats, uartModule);
+        stats->txBytes = uartStats.txBytes;
+        stats->rxBytes = uartStats.rxBytes;
+        stats->txFrames = HUart_stats[uartModule].txFrames;
+        stats->rxFrames = HUart_stats[uartModule].rxFrames;
+        stats->overruns = uartStats.overruns;
+        stats->framingErrors = uartStats.framingErrors;
+        stats->noiseErrors = uartStats.noiseErrors;
+        stats->parityErrors = uartStats.parityErrors;
+        stats->rxDropped = uartStats.rxDropped;
+        stats->queueFull = HUart_stats[uartModule].queueFull;
+        stats->coalescedSends = HUart_stats[uartModule].coalescedSends;
+        stats->coalescedTransfers = HUart_stats[uartModule].coalescedTransfers;
+        stats->laneDropped = HUart_stats[uartModule].laneDropped;
+        stats->rxTimeouts = HUart_stats[uartModule].rxTimeouts;
+        stats->turnarounds = HUart_stats[uartModule].turnarounds;
+        stats->turnaroundMinUs = HUart_stats[uartModule].turnaroundMinUs;
+        stats->turnaroundMaxUs = HUart_stats[uartModule].turnaroundMaxUs;
+        stats->turnaroundTotalUs = HUart_stats[uartModule].turnaroundTotalUs;
+        stats->latencySamples = HUart_stats[uartModule].latencySamples;
+        stats->latencyMinUs = HUart_stats[uartModule].latencyMinUs;
+        stats->latencyMaxUs = HUart_stats[uartModule].latencyMaxUs;
+        stats->latencyTotalUs = HUart_stats[uartModule].latencyTotalUs;
+        stats->elapsedUs = SYSTICK_getMicros() - HUart_statsStart[uartModule];
+        stats->isrCalls = uartStats.isrCalls;
+        stats->isrCycles = uartStats.isrCycles;
+        stats->peakTxQueue = 0;
+        for(lane=0; lane<HUART_TX_LANES; lane++)
+        {
+            if(HUart_txQueue[uartModule][lane].peak > stats->peakTxQueue)
+            {
+                stats->peakTxQueue = HUart_txQueue[uartModule][lane].peak;
+            }
+        }
+        stats->peakRxQueue = HUart_rxQueue[uartModule].peak;
+        error = E_OK;
+    }
+    return error;
+}
+/**
+ * @brief Clears the statistics of a specific UART module
+ *
+ * @param uartModule The UART module
+ *                  HUART_MODULE_1
+ *                  HUART_MODULE_2
+ *                  HUART_MODULE_3
+ *                  HUART_MODULE_4
+ *                  HUART_MODULE_5
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+Std_ReturnType HUart_ResetStatsOn(uint8_t uartModule)
+{
+    Std_ReturnType error = E_NOT_OK;
+    uint8_t lane;
+    if(uartModule < UART_NUMBER_OF_MODULES)
+    {
+        Uart_ResetStats(uartModule);
+        HUart_stats[uartModule].txFrames = 0;
+        HUart_stats[uartModule].rxFrames = 0;
+        HUart_stats[uartModule].queueFull = 0;
+        HUart_stats[uartModule].coalescedSends = 0;
+        HUart_stats[uartModule].coalescedTransfers = 0;
+        HUart_stats[uartModule].laneDropped = 0;
+        HUart_stats[uartModule].rxTimeouts = 0;
+        HUart_stats[uartModule].turnarounds = 0;
+        HUart_stats[uartModule].turnaroundMinUs = 0;
+        HUart_stats[uartModule].turnaroundMaxUs = 0;
+        HUart_stats[uartModule].turnaroundTotalUs = 0;
+        HUart_stats[uartModule].latencySamples = 0;
+        HUart_stats[uartModule].latencyMinUs = 0;
+        HUart_stats[uartModule].latencyMaxUs = 0;
+        HUart_stats[uartModule].latencyTotalUs = 0;
+        HUart_statsStart[uartModule] = SYSTICK_getMicros();
+        for(lane=0; lane<HUART_TX_LANES; lane++)
+        {
+            HUart_txQueue[uartModule][lane].peak = HUart_txQueue[uartModule][lane].nPackets;
+        }
+        HUart_rxQueue[uartModule].peak = HUart_rxQueue[uartModule].nPackets;
+        error = E_OK;
+    }
+    return error;
+}
+
+/**
+ * @brief The HUart Running task to handle the UART Requests
+ * *Only the modules that have queued or staged work are visited
+ * 
+ */
+void HUart_Task(void)
+{
+    uint8_t i;
+    uint8_t lane;
+    Std_ReturnType error;
+    hUartPacket_t packet;
+    uint32_t pending = HUart_activeMask;
+    while(pending)
+    {
+        i = HUART_LOWEST_MODULE(pending);
+        pending &= pending - 1;
+        if(HUart_stage[i].length[HUart_stage[i].fill] > 0 &&
+            SYSTICK_getMicros() - HUart_stage[i].openedAt >= (uint32_t)HUart_stage[i].window * 1000)
+        {
+            HUart_StageFlush(i);
+        }
+        if(HUart_rxTimer[i].armed)
+        {
+            HUart_RxTimeout(i);
+        }
+        if(!HUart_rxTimer[i].armed && E_OK == HUart_QueueGet(&HUart_rxQueue[i], &packet))
+        {
+            /* Armed before the request starts as buffered bytes may complete it at once */
+            HUart_rxTimer[i].total = packet.totalTimeout;
+            HUart_rxTimer[i].interByte = packet.interByteTimeout;
+            HUart_rxTimer[i].startedAt = SYSTICK_getMicros();
+            HUart_rxTimer[i].lastByteAt = HUart_rxTimer[i].startedAt;
+            HUart_rxTimer[i].lastCount = 0;
+            HUart_rxTimer[i].armed = (packet.totalTimeout || packet.interByteTimeout);
+            if(E_OK == Uart_Receive(packet.data, packet.len, i))
+            {
+                HUart_QueuePop(&HUart_rxQueue[i]);
+            }
+            else
+            {
+                HUart_rxTimer[i].armed = 0;
+            }
+        }
+        /* The high lane is always drained first, one packet at a time */
+        for(lane=0; lane<HUART_TX_LANES; lane++)
+        {
+            if(HUart_txQueue[i][lane].nPackets > 0)
+            {
+                break;
+            }
+        }
+        if(!HUart_txInFlight[i] && lane < HUART_TX_LANES && E_OK == HUart_QueueGet(&HUart_txQueue[i][lane], &packet))
+        {
+            HUart_txActive[i] = packet;
+            HUart_txInFlight[i] = 1;
+            if(HUART_NO_ADDRESS != packet.address)
+            {
+                error = Uart_SendTo(packet.data, packet.len, packet.address, i);
+            }
+            else if(packet.segments)
+            {
+                /* hUartSegment_t has the same layout as uartSegment_t so the list is handed down as is */
+                error = Uart_SendSegments((const uartSegment_t*)packet.segments, packet.nSegments, i);
+            }
+            else
+            {
+                error = Uart_Send(packet.data, packet.len, i);
+            }
+            if(E_OK == error)
+            {
+                HUart_QueuePop(&HUart_txQueue[i][lane]);
+            }
+            else
+            {
+                HUart_txInFlight[i] = 0;
             }
         }
-        if(E_OK == HUart_QueueGet(&HUart_txQueue[i], &packet))
+        if(HUart_IsIdle(i))
         {
-            if(E_OK == Uart_Send(packet.data, packet.len, i))
+            /* Checked again with the interrupts disabled so a send from a callback is not lost */
+            NVIC_controlAllPeripheral(NVIC_DISABLE);
+            if(HUart_IsIdle(i))
             {
-                HUart_QueuePop(&HUart_txQueue[i]);
+                HUart_activeMask &= ~((uint32_t)1 << i);
             }
+            NVIC_controlAllPeripheral(NVIC_ENABLE);
         }
     }
 }
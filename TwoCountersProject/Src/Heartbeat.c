@@ -0,0 +1,341 @@
+/**
+ * @file Heartbeat.c
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief This is the implementation for the link heartbeat
+ * @version 0.1
+ * @date 2020-04-17
+ * 
+ * @copyright Copyright (c) 2020
+ * 
+ */
+#include "Std_Types.h"
+#include "SYSTICK.h"
+#include "Link_Cfg.h"
+#include "Link.h"
+#include "Heartbeat_Cfg.h"
+#include "Heartbeat.h"
+
+#define HEARTBEAT_PING               0x01
+#define HEARTBEAT_PONG               0x02
+
+/* kind, sequence number and the time of the sender in micro seconds, for a pong
+ * it is the time the peer answered at */
+#define HEARTBEAT_MESSAGE_SIZE       6
+#define HEARTBEAT_KIND_INDEX         0
+#define HEARTBEAT_SEQ_INDEX          1
+#define HEARTBEAT_TIME_INDEX         2
+
+#define HEARTBEAT_HISTORY_MASK       0xFFFFFFFF
+
+/* The heartbeat time in milli seconds taken from the SysTick, the micro seconds
+ * past the last whole milli second are kept for the next run */
+static uint32_t Heartbeat_now;
+static uint32_t Heartbeat_nowMicros;
+static uint32_t Heartbeat_nextPingAt;
+static uint32_t Heartbeat_lastHeard;
+static uint32_t Heartbeat_lastFrames;
+
+static uint8_t Heartbeat_seq;
+static uint8_t Heartbeat_awaiting;
+static uint32_t Heartbeat_pingSentAt;
+static heartbeatSampleCb_t Heartbeat_sampleCb;
+/* A bit for each of the last pings, 1 if it was answered */
+static uint32_t Heartbeat_history;
+static uint8_t Heartbeat_historyLength;
+static uint32_t Heartbeat_rttTotalUs;
+
+static heartbeatStats_t Heartbeat_stats;
+
+/**
+ * @brief Writes a heartbeat message, the time is little endian
+ * 
+ * @param kind HEARTBEAT_PING or HEARTBEAT_PONG
+ * @param seq the sequence number of the ping
+ * @param time the time of the sender
+ * @param message where to write it
+ */
+static void Heartbeat_Put(uint8_t kind, uint8_t seq, uint32_t time, uint8_t* message)
+{
+    uint8_t i;
+    message[HEARTBEAT_KIND_INDEX] = kind;
+    message[HEARTBEAT_SEQ_INDEX] = seq;
+    for(i = 0; i < 4; i++)
+    {
+        message[HEARTBEAT_TIME_INDEX + i] = (uint8_t)(time >> (8 * i));
+    }
+}
+
+/**
+ * @brief Records whether the last ping was answered
+ * 
+ * @param answered 1 if a pong came back and 0 if not
+ */
+static void Heartbeat_Record(uint8_t answered)
+{
+    uint8_t lost = 0;
+    uint32_t history;
+    Heartbeat_history = (Heartbeat_history << 1) | answered;
+    if(Heartbeat_historyLength < HEARTBEAT_LOSS_WINDOW)
+    {
+        Heartbeat_historyLength++;
+    }
+    history = ~Heartbeat_history & (HEARTBEAT_HISTORY_MASK >> (HEARTBEAT_LOSS_WINDOW - Heartbeat_historyLength));
+    while(history)
+    {
+        /* Clears the lowest set bit */
+        history &= history - 1;
+        lost++;
+    }
+    Heartbeat_stats.lossPercent = (uint8_t)((uint16_t)lost * 100 / Heartbeat_historyLength);
+}
+
+/**
+ * @brief Takes the RTT of an answered ping
+ * 
+ * @param rtt the round trip time in micro seconds
+ */
+static void Heartbeat_RttSample(uint32_t rtt)
+{
+    uint8_t bin = 0;
+    if(Heartbeat_stats.rttSamples == 0 || rtt < Heartbeat_stats.rttMinUs)
+    {
+        Heartbeat_stats.rttMinUs = rtt;
+    }
+    if(rtt > Heartbeat_stats.rttMaxUs)
+    {
+        Heartbeat_stats.rttMaxUs = rtt;
+    }
+    Heartbeat_stats.rttSamples++;
+    Heartbeat_rttTotalUs += rtt;
+    Heartbeat_stats.rttAvgUs = Heartbeat_rttTotalUs / Heartbeat_stats.rttSamples;
+    while(bin < HEARTBEAT_HIST_BINS - 1 && rtt >= HEARTBEAT_BIN_LIMIT_US(bin))
+    {
+        bin++;
+    }
+    Heartbeat_stats.histogram[bin]++;
+}
+
+/**
+ * @brief Handles a datagram from the peer, a ping is answered right away
+ * 
+ * @param data the datagram
+ * @param length the length of the datagram
+ */
+static void Heartbeat_Receive(const uint8_t* data, uint16_t length)
+{
+    uint8_t message[HEARTBEAT_MESSAGE_SIZE];
+    uint32_t time = 0;
+    uint32_t now = SYSTICK_getMicros();
+    uint8_t i;
+    if(length == HEARTBEAT_MESSAGE_SIZE)
+    {
+        for(i = 0; i < 4; i++)
+        {
+            time |= (uint32_t)data[HEARTBEAT_TIME_INDEX + i] << (8 * i);
+        }
+        if(data[HEARTBEAT_KIND_INDEX] == HEARTBEAT_PING)
+        {
+            /* A pong that can't be sent is a lost ping for the peer, it is sent
+             * right away so the time it carries is also the time the ping came */
+            Heartbeat_Put(HEARTBEAT_PONG, data[HEARTBEAT_SEQ_INDEX], now, message);
+            Link_SendDatagram(message, HEARTBEAT_MESSAGE_SIZE);
+        }
+        else if(data[HEARTBEAT_KIND_INDEX] == HEARTBEAT_PONG)
+        {
+            if(Heartbeat_awaiting && data[HEARTBEAT_SEQ_INDEX] == Heartbeat_seq)
+            {
+                Heartbeat_awaiting = 0;
+                Heartbeat_stats.pongsReceived++;
+                Heartbeat_RttSample(now - Heartbeat_pingSentAt);
+                Heartbeat_Record(1);
+                if(Heartbeat_sampleCb)
+                {
+                    Heartbeat_sampleCb(Heartbeat_pingSentAt, time, now);
+                }
+                /* A steady peer needs fewer pings */
+                Heartbeat_stats.periodMs = Heartbeat_stats.periodMs * 2 > HEARTBEAT_MAX_PERIOD_MS ?
+                                            HEARTBEAT_MAX_PERIOD_MS : Heartbeat_stats.periodMs * 2;
+            }
+            else
+            {
+                Heartbeat_stats.pongsLate++;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Initializes the heartbeat, the link has to be initialized first
+ * 
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+Std_ReturnType Heartbeat_Init(void)
+{
+    heartbeatStats_t emptyStats = {0};
+    Heartbeat_now = 0;
+    Heartbeat_nowMicros = SYSTICK_getMicros();
+    Heartbeat_nextPingAt = 0;
+    Heartbeat_lastHeard = 0;
+    Heartbeat_lastFrames = 0;
+    Heartbeat_seq = 0;
+    Heartbeat_awaiting = 0;
+    Heartbeat_history = 0;
+    Heartbeat_historyLength = 0;
+    Heartbeat_rttTotalUs = 0;
+    Heartbeat_stats = emptyStats;
+    Heartbeat_stats.periodMs = HEARTBEAT_MIN_PERIOD_MS;
+    return Link_SetDatagramCb(Heartbeat_Receive);
+}
+
+/**
+ * @brief Sets the callback function that will be called with the times of every
+ * answered ping
+ * 
+ * @param func the callback function
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+Std_ReturnType Heartbeat_SetSampleCb(heartbeatSampleCb_t func)
+{
+    Std_ReturnType error = E_OK;
+    if(func)
+    {
+        Heartbeat_sampleCb = func;
+    }
+    else
+    {
+        error = E_NOT_OK;
+    }
+    return error;
+}
+
+/**
+ * @brief Checks if the peer was heard in the last HEARTBEAT_PEER_TIMEOUT_MS
+ * 
+ * @param alive where to put 1 if the peer is alive and 0 if not
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+Std_ReturnType Heartbeat_IsPeerAlive(uint8_t* alive)
+{
+    Std_ReturnType error = E_NOT_OK;
+    if(alive)
+    {
+        *alive = Heartbeat_stats.peerAlive;
+        error = E_OK;
+    }
+    return error;
+}
+
+/**
+ * @brief Gets an RTT percentile from the histogram, the result is the upper limit
+ * of the bin it falls in
+ * 
+ * @param percent the percentile from 1 to 100
+ * @param rttUs where to put the RTT in micro seconds
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If there is no RTT sample yet or the percent is wrong
+ */
+Std_ReturnType Heartbeat_GetRttPercentile(uint8_t percent, uint32_t* rttUs)
+{
+    Std_ReturnType error = E_NOT_OK;
+    uint32_t rank;
+    uint32_t count = 0;
+    uint8_t bin;
+    if(rttUs && percent && percent <= 100 && Heartbeat_stats.rttSamples)
+    {
+        /* The rank of the sample rounded up */
+        rank = (Heartbeat_stats.rttSamples * percent + 99) / 100;
+        for(bin = 0; bin < HEARTBEAT_HIST_BINS; bin++)
+        {
+            count += Heartbeat_stats.histogram[bin];
+            if(count >= rank)
+            {
+                break;
+            }
+        }
+        /* The last bin has no limit, the largest RTT bounds it */
+        *rttUs = bin < HEARTBEAT_HIST_BINS - 1 ? HEARTBEAT_BIN_LIMIT_US(bin) : Heartbeat_stats.rttMaxUs;
+        if(*rttUs > Heartbeat_stats.rttMaxUs)
+        {
+            *rttUs = Heartbeat_stats.rttMaxUs;
+        }
+        error = E_OK;
+    }
+    return error;
+}
+
+/**
+ * @brief Gets the statistics of the heartbeat
+ * 
+ * @param stats where to copy the statistics
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+Std_ReturnType Heartbeat_GetStats(heartbeatStats_t* stats)
+{
+    Std_ReturnType error = E_NOT_OK;
+    if(stats)
+    {
+        *stats = Heartbeat_stats;
+        error = E_OK;
+    }
+    return error;
+}
+
+/**
+ * @brief The heartbeat task, it sends the pings and watches the peer, it comes
+ * every HEARTBEAT_TASK_PERIOD_MS
+ * 
+ */
+void Heartbeat_Task(void)
+{
+    uint8_t message[HEARTBEAT_MESSAGE_SIZE];
+    linkStats_t linkStats;
+    uint32_t sentAt;
+    uint32_t elapsedMs = (SYSTICK_getMicros() - Heartbeat_nowMicros) / 1000;
+    Heartbeat_nowMicros += elapsedMs * 1000;
+    Heartbeat_now += elapsedMs;
+
+    /* Any frame from the peer shows it is alive, not only the pongs */
+    Link_GetStats(&linkStats);
+    if(linkStats.framesReceived != Heartbeat_lastFrames)
+    {
+        Heartbeat_lastFrames = linkStats.framesReceived;
+        Heartbeat_lastHeard = Heartbeat_now;
+        Heartbeat_stats.peerAlive = 1;
+    }
+    else if(Heartbeat_stats.peerAlive && Heartbeat_now - Heartbeat_lastHeard >= HEARTBEAT_PEER_TIMEOUT_MS)
+    {
+        Heartbeat_stats.peerAlive = 0;
+        Heartbeat_stats.peerLosses++;
+    }
+
+    if((sint32_t)(Heartbeat_now - Heartbeat_nextPingAt) >= 0)
+    {
+        if(Heartbeat_awaiting)
+        {
+            /* Probe faster to find out soon if the peer is gone */
+            Heartbeat_awaiting = 0;
+            Heartbeat_Record(0);
+            Heartbeat_stats.periodMs = HEARTBEAT_MIN_PERIOD_MS;
+        }
+        sentAt = SYSTICK_getMicros();
+        Heartbeat_Put(HEARTBEAT_PING, (uint8_t)(Heartbeat_seq + 1), sentAt, message);
+        /* A busy transport is tried again with the next run */
+        if(E_OK == Link_SendDatagram(message, HEARTBEAT_MESSAGE_SIZE))
+        {
+            Heartbeat_seq++;
+            Heartbeat_pingSentAt = sentAt;
+            Heartbeat_awaiting = 1;
+            Heartbeat_stats.pingsSent++;
+            Heartbeat_nextPingAt = Heartbeat_now + Heartbeat_stats.periodMs;
+        }
+    }
+}
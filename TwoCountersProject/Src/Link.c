@@ -0,0 +1,569 @@
+/**
+ * @file Link.c
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief This is the implementation for the reliable link layer, every message carries
+ * a sequence number and every frame carries the cumulative ack of the sender, up to
+ * LINK_WINDOW_SIZE messages are on the wire at once and on a timeout all of them are
+ * sent again (Go-Back-N)
+ * *Both sides number from 0 after Link_Init, a side that starts again sets SYN on its
+ * frames until the peer answers with SYNACK, the peer starts its session again on the
+ * first SYN and no data moves until both flags are gone
+ * @version 0.1
+ * @date 2020-04-14
+ * 
+ * @copyright Copyright (c) 2020
+ * 
+ */
+#include "Std_Types.h"
+#include "Transport.h"
+#include "SYSTICK.h"
+#include "Frame_Cfg.h"
+#include "Frame.h"
+#include "Link_Cfg.h"
+#include "Link.h"
+
+#define LINK_TYPE_DATA               0x01
+#define LINK_TYPE_ACK                0x02
+/* Not numbered and not acked, for messages that are useless when late */
+#define LINK_TYPE_DATAGRAM           0x03
+#define LINK_TYPE_MASK               0x3F
+
+/* The sender started again and waits for the peer to start its session again */
+#define LINK_FLAG_SYN                0x80
+/* The sender started its session again for the peer and waits for a frame without SYN */
+#define LINK_FLAG_SYNACK             0x40
+
+/* type, sequence number and cumulative ack */
+#define LINK_HEADER_SIZE             3
+#define LINK_TYPE_INDEX              0
+#define LINK_SEQ_INDEX               1
+#define LINK_ACK_INDEX               2
+
+#define LINK_FRAME_SIZE              FRAME_ENCODED_SIZE(LINK_HEADER_SIZE + LINK_MAX_PAYLOAD)
+
+/* The window slot of a sequence number */
+#define LINK_SLOT(seq)               ((uint8_t)(seq) % LINK_WINDOW_SIZE)
+
+typedef struct
+{
+    uint8_t data[LINK_MAX_PAYLOAD];
+    uint8_t length;
+    /* Cleared when the message has to go on the wire (again) */
+    uint8_t sent;
+    /* A retransmitted message gives no RTT sample (Karn's rule) */
+    uint8_t retransmitted;
+    uint32_t sentAt;
+}linkSlot_t;
+
+static linkSlot_t Link_window[LINK_WINDOW_SIZE];
+/* The oldest message not acknowledged and the number given to the next one */
+static uint8_t Link_base;
+static uint8_t Link_nextSeq;
+/* The next sequence number expected from the peer, it is the ack we send */
+static uint8_t Link_expectedSeq;
+static uint8_t Link_ackPending;
+
+/* Set until the peer started its session again for us */
+static uint8_t Link_syn;
+/* Set from the session start until the peer sends a frame without SYN */
+static uint8_t Link_peerFresh;
+/* When the last frame that carries the flags was sent while they are set */
+static uint32_t Link_syncSentAt;
+
+/* The link time in milli seconds, it follows the SysTick so the timeouts hold
+ * whatever the task period is, the micro seconds past the last whole milli second
+ * are kept in Link_nowMicros for the next run */
+static uint32_t Link_now;
+static uint32_t Link_nowMicros;
+/* The smoothed RTT times 8 and the RTT variation times 4 (Jacobson) */
+static uint32_t Link_srtt8;
+static uint32_t Link_rttvar4;
+static uint32_t Link_rto;
+
+static frameDecoder_t Link_decoder;
+static linkRxCb_t Link_rxCb;
+static linkRxCb_t Link_datagramCb;
+static linkStats_t Link_stats;
+
+/**
+ * @brief Encodes and sends one link frame
+ * 
+ * @param type LINK_TYPE_DATA or LINK_TYPE_ACK
+ * @param seq the sequence number of the message
+ * @param data the message, ignored for an ack
+ * @param length the length of the message
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the transport accepted the frame
+ *                  E_NOT_OK: If the transport is busy
+ */
+static Std_ReturnType Link_SendFrame(uint8_t type, uint8_t seq, const uint8_t* data, uint8_t length)
+{
+    Std_ReturnType error = E_NOT_OK;
+    uint8_t payload[LINK_HEADER_SIZE + LINK_MAX_PAYLOAD];
+    uint8_t frame[LINK_FRAME_SIZE];
+    uint16_t frameLength;
+    uint8_t i;
+    payload[LINK_TYPE_INDEX] = type;
+    if(Link_syn)
+    {
+        payload[LINK_TYPE_INDEX] |= LINK_FLAG_SYN;
+    }
+    if(Link_peerFresh)
+    {
+        payload[LINK_TYPE_INDEX] |= LINK_FLAG_SYNACK;
+    }
+    payload[LINK_SEQ_INDEX] = seq;
+    payload[LINK_ACK_INDEX] = Link_expectedSeq;
+    for(i = 0; i < length; i++)
+    {
+        payload[LINK_HEADER_SIZE + i] = data[i];
+    }
+    if(E_OK == Frame_Encode(payload, LINK_HEADER_SIZE + length, frame, sizeof(frame), &frameLength))
+    {
+        error = Transport_Send(frame, frameLength);
+    }
+    if(error == E_OK)
+    {
+        /* Every frame carries the ack so a separate one is no longer needed */
+        Link_ackPending = 0;
+        Link_syncSentAt = Link_now;
+    }
+    return error;
+}
+
+/**
+ * @brief Starts the session again for a peer that started again, the messages not
+ * acknowledged were meant for the peer before it started and are dropped
+ * 
+ */
+static void Link_Restart(void)
+{
+    Link_base = 0;
+    Link_nextSeq = 0;
+    Link_expectedSeq = 0;
+    Link_ackPending = 1;
+    Link_stats.restarts++;
+}
+
+/**
+ * @brief Takes an RTT sample and updates the retransmission timeout (RFC 6298)
+ * 
+ * @param rtt the round trip time in milli seconds
+ */
+static void Link_RttSample(uint32_t rtt)
+{
+    uint32_t deviation;
+    if(Link_stats.rttSamples == 0)
+    {
+        Link_srtt8 = rtt << 3;
+        Link_rttvar4 = rtt << 1;
+        Link_stats.rttMinMs = (uint16_t)rtt;
+        Link_stats.rttMaxMs = (uint16_t)rtt;
+    }
+    else
+    {
+        deviation = (Link_srtt8 >> 3) > rtt ? (Link_srtt8 >> 3) - rtt : rtt - (Link_srtt8 >> 3);
+        /* rttvar = 3/4 rttvar + 1/4 |srtt - rtt|, srtt = 7/8 srtt + 1/8 rtt */
+        Link_rttvar4 += deviation - (Link_rttvar4 >> 2);
+        Link_srtt8 += rtt - (Link_srtt8 >> 3);
+        if(rtt < Link_stats.rttMinMs)
+        {
+            Link_stats.rttMinMs = (uint16_t)rtt;
+        }
+        if(rtt > Link_stats.rttMaxMs)
+        {
+            Link_stats.rttMaxMs = (uint16_t)rtt;
+        }
+    }
+    Link_stats.rttSamples++;
+    Link_rto = (Link_srtt8 >> 3) + Link_rttvar4;
+    if(Link_rto < LINK_MIN_RTO_MS)
+    {
+        Link_rto = LINK_MIN_RTO_MS;
+    }
+    else if(Link_rto > LINK_MAX_RTO_MS)
+    {
+        Link_rto = LINK_MAX_RTO_MS;
+    }
+    Link_stats.srttMs = (uint16_t)(Link_srtt8 >> 3);
+    Link_stats.rtoMs = (uint16_t)Link_rto;
+}
+
+/**
+ * @brief Releases the messages covered by a cumulative ack
+ * 
+ * @param ack the next sequence number the peer expects
+ */
+static void Link_HandleAck(uint8_t ack)
+{
+    uint8_t acked = (uint8_t)(ack - Link_base);
+    linkSlot_t* slot;
+    /* An ack outside the window is old or corrupted */
+    if(acked <= (uint8_t)(Link_nextSeq - Link_base))
+    {
+        while(Link_base != ack)
+        {
+            slot = &Link_window[LINK_SLOT(Link_base)];
+            if(slot->sent && !slot->retransmitted)
+            {
+                Link_RttSample(Link_now - slot->sentAt);
+            }
+            Link_base++;
+        }
+    }
+}
+
+/**
+ * @brief Handles a frame received from the peer
+ * 
+ * @param data the decoded frame
+ * @param length the length of the frame
+ */
+static void Link_HandleFrame(const uint8_t* data, uint16_t length)
+{
+    uint8_t type;
+    if(length >= LINK_HEADER_SIZE && length <= LINK_HEADER_SIZE + LINK_MAX_PAYLOAD)
+    {
+        Link_stats.framesReceived++;
+        type = data[LINK_TYPE_INDEX] & LINK_TYPE_MASK;
+        if(data[LINK_TYPE_INDEX] & LINK_FLAG_SYN)
+        {
+            /* Only the first SYN of a start, the session did not move since */
+            if(!Link_peerFresh)
+            {
+                Link_Restart();
+                Link_peerFresh = 1;
+            }
+            Link_ackPending = 1;
+        }
+        else
+        {
+            Link_peerFresh = 0;
+        }
+        if(data[LINK_TYPE_INDEX] & LINK_FLAG_SYNACK)
+        {
+            /* The peer waits for a frame without SYN, this one may be the last it gets */
+            Link_syn = 0;
+            Link_ackPending = 1;
+        }
+        /* The acks and messages of a peer that did not hear we started again are
+         * numbered for the session before */
+        if(!Link_syn)
+        {
+            Link_HandleAck(data[LINK_ACK_INDEX]);
+        }
+        if(type == LINK_TYPE_DATAGRAM)
+        {
+            if(Link_datagramCb)
+            {
+                Link_datagramCb(&data[LINK_HEADER_SIZE], length - LINK_HEADER_SIZE);
+            }
+        }
+        else if(type == LINK_TYPE_DATA && !Link_syn)
+        {
+            if(data[LINK_SEQ_INDEX] == Link_expectedSeq)
+            {
+                Link_expectedSeq++;
+                Link_stats.delivered++;
+                if(Link_rxCb)
+                {
+                    Link_rxCb(&data[LINK_HEADER_SIZE], length - LINK_HEADER_SIZE);
+                }
+            }
+            else if((uint8_t)(Link_expectedSeq - data[LINK_SEQ_INDEX]) <= LINK_WINDOW_SIZE)
+            {
+                /* Our ack was lost and the peer sent the message again */
+                Link_stats.duplicates++;
+            }
+            else
+            {
+                /* A message before it was lost, the peer will go back to it */
+                Link_stats.outOfOrder++;
+            }
+            /* Every data frame is acked so the peer learns about a loss early */
+            Link_ackPending = 1;
+        }
+    }
+}
+
+/**
+ * @brief Decodes the bytes received since the last call
+ * 
+ */
+static void Link_ReceivePoll(void)
+{
+    uint8_t buffer[LINK_READ_CHUNK];
+    uint16_t count;
+    uint16_t i;
+    do
+    {
+        count = 0;
+        Transport_Read(buffer, LINK_READ_CHUNK, &count);
+        for(i = 0; i < count; i++)
+        {
+            if(FRAME_RECEIVED == Frame_DecodeByte(&Link_decoder, buffer[i]))
+            {
+                Link_HandleFrame(Link_decoder.data, Link_decoder.length);
+            }
+        }
+    } while(count == LINK_READ_CHUNK);
+}
+
+/**
+ * @brief Sends the messages in the window that are not on the wire, in order
+ * 
+ */
+static void Link_TransmitPoll(void)
+{
+    uint8_t seq;
+    linkSlot_t* slot;
+    /* The messages wait for the session, the flags go on the acks until it is back */
+    if(Link_syn || Link_peerFresh)
+    {
+        seq = Link_nextSeq;
+        if(Link_now - Link_syncSentAt >= LINK_INITIAL_RTO_MS)
+        {
+            Link_ackPending = 1;
+        }
+    }
+    else
+    {
+        seq = Link_base;
+    }
+    for(; seq != Link_nextSeq; seq++)
+    {
+        slot = &Link_window[LINK_SLOT(seq)];
+        if(!slot->sent)
+        {
+            if(E_OK != Link_SendFrame(LINK_TYPE_DATA, seq, slot->data, slot->length))
+            {
+                /* The transport is full, the rest waits for the next run */
+                break;
+            }
+            slot->sent = 1;
+            slot->sentAt = Link_now;
+            if(slot->retransmitted)
+            {
+                Link_stats.retransmits++;
+            }
+            else
+            {
+                Link_stats.sent++;
+            }
+        }
+    }
+    if(Link_ackPending && E_OK == Link_SendFrame(LINK_TYPE_ACK, Link_nextSeq, NULL, 0))
+    {
+        Link_stats.acksSent++;
+    }
+}
+
+/**
+ * @brief Goes back to the oldest message when it is not acknowledged in time
+ * 
+ */
+static void Link_RetransmitPoll(void)
+{
+    uint8_t seq;
+    linkSlot_t* slot = &Link_window[LINK_SLOT(Link_base)];
+    if(Link_base != Link_nextSeq && slot->sent && Link_now - slot->sentAt >= Link_rto)
+    {
+        for(seq = Link_base; seq != Link_nextSeq; seq++)
+        {
+            slot = &Link_window[LINK_SLOT(seq)];
+            slot->sent = 0;
+            slot->retransmitted = 1;
+        }
+        /* Back off until a new RTT sample is taken */
+        Link_rto <<= 1;
+        if(Link_rto > LINK_MAX_RTO_MS)
+        {
+            Link_rto = LINK_MAX_RTO_MS;
+        }
+        Link_stats.rtoMs = (uint16_t)Link_rto;
+        Link_stats.timeouts++;
+    }
+}
+
+/**
+ * @brief Initializes the link, the transport has to be initialized first
+ * 
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+Std_ReturnType Link_Init(void)
+{
+    linkStats_t emptyStats = {0};
+    Link_base = 0;
+    Link_nextSeq = 0;
+    Link_expectedSeq = 0;
+    Link_ackPending = 1;
+    Link_syn = 1;
+    Link_peerFresh = 1;
+    Link_now = 0;
+    Link_nowMicros = SYSTICK_getMicros();
+    Link_syncSentAt = 0;
+    Link_rto = LINK_INITIAL_RTO_MS;
+    Link_stats = emptyStats;
+    Link_stats.rtoMs = LINK_INITIAL_RTO_MS;
+    return Frame_InitDecoder(&Link_decoder);
+}
+
+/**
+ * @brief Sends a message, it is copied and kept until the peer acknowledges it
+ * 
+ * @param data the message
+ * @param length the length of the message in bytes, at most LINK_MAX_PAYLOAD
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the message is accepted
+ *                  E_NOT_OK: If the message is too long or the window is full
+ */
+Std_ReturnType Link_Send(const uint8_t* data, uint16_t length)
+{
+    Std_ReturnType error = E_OK;
+    linkSlot_t* slot;
+    uint8_t i;
+    if(data == NULL || length > LINK_MAX_PAYLOAD || (uint8_t)(Link_nextSeq - Link_base) >= LINK_WINDOW_SIZE)
+    {
+        error = E_NOT_OK;
+    }
+    else
+    {
+        slot = &Link_window[LINK_SLOT(Link_nextSeq)];
+        for(i = 0; i < length; i++)
+        {
+            slot->data[i] = data[i];
+        }
+        slot->length = (uint8_t)length;
+        slot->sent = 0;
+        slot->retransmitted = 0;
+        Link_nextSeq++;
+        /* Put it on the wire now instead of waiting for the task */
+        Link_TransmitPoll();
+    }
+    return error;
+}
+
+/**
+ * @brief Sends a datagram right away, it is not numbered, acked or sent again
+ * 
+ * @param data the datagram
+ * @param length the length of the datagram in bytes, at most LINK_MAX_PAYLOAD
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the transport accepted the datagram
+ *                  E_NOT_OK: If the datagram is too long or the transport is busy
+ */
+Std_ReturnType Link_SendDatagram(const uint8_t* data, uint16_t length)
+{
+    Std_ReturnType error = E_NOT_OK;
+    if(data && length <= LINK_MAX_PAYLOAD)
+    {
+        error = Link_SendFrame(LINK_TYPE_DATAGRAM, Link_nextSeq, data, (uint8_t)length);
+    }
+    return error;
+}
+
+/**
+ * @brief Gets the number of messages sent and not yet acknowledged
+ * 
+ * @param pending where to put the number of messages
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+Std_ReturnType Link_GetPending(uint8_t* pending)
+{
+    Std_ReturnType error = E_OK;
+    if(pending)
+    {
+        *pending = (uint8_t)(Link_nextSeq - Link_base);
+    }
+    else
+    {
+        error = E_NOT_OK;
+    }
+    return error;
+}
+
+/**
+ * @brief Sets the callback function that will be called with every message
+ * received in order
+ * 
+ * @param func the callback function
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+Std_ReturnType Link_SetRxCb(linkRxCb_t func)
+{
+    Std_ReturnType error = E_OK;
+    if(func)
+    {
+        Link_rxCb = func;
+    }
+    else
+    {
+        error = E_NOT_OK;
+    }
+    return error;
+}
+
+/**
+ * @brief Sets the callback function that will be called with every datagram received
+ * 
+ * @param func the callback function
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+Std_ReturnType Link_SetDatagramCb(linkRxCb_t func)
+{
+    Std_ReturnType error = E_OK;
+    if(func)
+    {
+        Link_datagramCb = func;
+    }
+    else
+    {
+        error = E_NOT_OK;
+    }
+    return error;
+}
+
+/**
+ * @brief Gets the statistics of the link
+ * 
+ * @param stats where to copy the statistics
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+Std_ReturnType Link_GetStats(linkStats_t* stats)
+{
+    Std_ReturnType error = E_OK;
+    if(stats)
+    {
+        *stats = Link_stats;
+    }
+    else
+    {
+        error = E_NOT_OK;
+    }
+    return error;
+}
+
+/**
+ * @brief The link task, it decodes the received frames, sends the messages and acks
+ * and retransmits on timeout, it comes every LINK_TASK_PERIOD_MS
+ * 
+ */
+void Link_Task(void)
+{
+    uint32_t elapsedMs = (SYSTICK_getMicros() - Link_nowMicros) / 1000;
+    Link_nowMicros += elapsedMs * 1000;
+    Link_now += elapsedMs;
+    Link_ReceivePoll();
+    Link_RetransmitPoll();
+    Link_TransmitPoll();
+}
@@ -33,6 +33,10 @@ u32 IPR[21];
 /* IPR set mask */
 #define NVIC_IPR_SETMASK    0x000000ff
 
+/* Application interrupt and reset control register, the key and the reset request */
+#define NVIC_AIRCR          (*(volatile u32 *) 0xE000ED0C)
+#define NVIC_AIRCR_RESET    0x05FA0004
+
 /**
  * @brief Sets and resets the interrupts
  * 
@@ -179,3 +183,14 @@ void NVIC_filterInterrupts(u8 priority)
       : "=r" (priority));
   asm("MSR BASEPRI, R0");
 }
+/**
+ * @brief Resets the whole system, it does not return
+ * 
+ */
+void NVIC_systemReset(void)
+{
+  asm("DSB");
+  NVIC_AIRCR = NVIC_AIRCR_RESET;
+  asm("DSB");
+  while(1);
+}
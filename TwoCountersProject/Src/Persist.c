@@ -0,0 +1,386 @@
+/**
+ * @file Persist.c
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief This is the implementation for the counter persistence
+ * @version 0.1
+ * @date 2020-04-21
+ * 
+ * @copyright Copyright (c) 2020
+ * 
+ */
+#include "Std_Types.h"
+#include "Frame_Cfg.h"
+#include "Frame.h"
+#include "CounterCodec.h"
+#include "GCounter_Cfg.h"
+#include "GCounter.h"
+#include "Flash_Cfg.h"
+#include "Flash.h"
+#include "SYSTICK.h"
+#include "Persist_Cfg.h"
+#include "Persist.h"
+
+/* A page starts with its sequence number and the magic, in half words, the magic is
+ * written last so a page with the magic has its whole sequence number */
+#define PERSIST_MAGIC                0x5350
+#define PERSIST_SEQUENCE_INDEX       0
+#define PERSIST_MAGIC_INDEX          2
+#define PERSIST_HEADER_SIZE          8
+
+/* A record is the length of the slots, its complement, the slots as GCounter entries,
+ * a padding byte to an even length and the CRC of all that */
+#define PERSIST_RECORD_HEADER        2
+#define PERSIST_RECORD_CRC           2
+#define PERSIST_MAX_DATA             (GCOUNTER_MAX_NODES * GCOUNTER_MAX_ENTRY)
+#define PERSIST_RECORD_SIZE(length)  (((PERSIST_RECORD_HEADER + (length) + 1) & ~1) + PERSIST_RECORD_CRC)
+
+#define PERSIST_ERASED               0xFF
+#define PERSIST_CRC_INIT             0xFFFF
+#define PERSIST_INTERVAL_US          ((uint32_t)PERSIST_MIN_INTERVAL_MS * 1000)
+
+#define PERSIST_PAGE_ADDRESS(page)   (PERSIST_FIRST_PAGE + (uint32_t)(page) * FLASH_PAGE_SIZE)
+
+#define PERSIST_STEP_NONE            0
+#define PERSIST_STEP_ERASE           1
+#define PERSIST_STEP_HEADER          2
+#define PERSIST_STEP_RECORD          3
+
+static persistStats_t Persist_stats;
+
+/* The page written now and where the next record goes in it */
+static uint8_t Persist_page;
+static uint16_t Persist_offset;
+
+static uint16_t Persist_header[PERSIST_HEADER_SIZE / 2];
+static uint8_t Persist_record[PERSIST_RECORD_SIZE(PERSIST_MAX_DATA)];
+static uint16_t Persist_recordSize;
+
+/* The slots in the last record written and in the one being written */
+static uint32_t Persist_saved[GCOUNTER_MAX_NODES];
+static uint32_t Persist_pending[GCOUNTER_MAX_NODES];
+
+/* Set from the last record until the interval is over, the SysTick time it started
+ * at is only looked at while it is set so the time wrapping around does not matter */
+static uint8_t Persist_resting;
+static uint32_t Persist_restStart;
+
+static uint8_t Persist_step;
+static uint8_t Persist_stepStarted;
+static uint8_t Persist_stepDone;
+static Std_ReturnType Persist_stepResult;
+
+/**
+ * @brief Reads the header of a page
+ * 
+ * @param page the page
+ * @param sequence where to put the sequence number of the page
+ * @return uint8_t 1 if the page holds a log and 0 if not
+ */
+static uint8_t Persist_ReadHeader(uint8_t page, uint32_t* sequence)
+{
+    const volatile uint16_t* header = (const volatile uint16_t*)PERSIST_PAGE_ADDRESS(page);
+    *sequence = header[PERSIST_SEQUENCE_INDEX] | ((uint32_t)header[PERSIST_SEQUENCE_INDEX + 1] << 16);
+    return PERSIST_MAGIC == header[PERSIST_MAGIC_INDEX];
+}
+
+/**
+ * @brief Walks the records of a page, a record cut by a reset fails its CRC and is
+ * stepped over
+ * 
+ * @param page the page
+ * @param last where to put the offset of the last good record, 0 if there is none
+ * @return uint16_t the offset after the last record, FLASH_PAGE_SIZE if the page
+ * cannot take more records
+ */
+static uint16_t Persist_Walk(uint8_t page, uint16_t* last)
+{
+    const uint8_t* data = (const uint8_t*)PERSIST_PAGE_ADDRESS(page);
+    uint16_t offset = PERSIST_HEADER_SIZE;
+    uint16_t size;
+    uint8_t length;
+    uint8_t check;
+    *last = 0;
+    while(offset < FLASH_PAGE_SIZE && PERSIST_ERASED != data[offset + 1])
+    {
+        length = data[offset];
+        check = (uint8_t)~length;
+        size = PERSIST_RECORD_SIZE(length);
+        if(check != data[offset + 1] || 0 == length || length > PERSIST_MAX_DATA ||
+            offset + size > FLASH_PAGE_SIZE)
+        {
+            /* Nothing after a broken length can be trusted */
+            offset = FLASH_PAGE_SIZE;
+        }
+        else
+        {
+            if((data[offset + size - 2] | (uint16_t)(data[offset + size - 1] << 8)) ==
+                Frame_Crc16(&data[offset], size - PERSIST_RECORD_CRC, PERSIST_CRC_INIT))
+            {
+                *last = offset;
+            }
+            offset += size;
+        }
+    }
+    return offset;
+}
+
+/**
+ * @brief Finds the page written last from the page headers and merges the last good
+ * record into the counter, going back to the older pages if it has none
+ * 
+ */
+static void Persist_Restore(void)
+{
+    const uint8_t* data;
+    uint32_t sequence;
+    uint32_t bestSequence = 0;
+    uint8_t tried = 0;
+    uint8_t best;
+    uint8_t page;
+    uint16_t end;
+    uint16_t last = 0;
+    uint8_t changed;
+    /* Without any log the first record starts page 0 */
+    Persist_page = PERSIST_PAGES - 1;
+    Persist_offset = FLASH_PAGE_SIZE;
+    Persist_stats.sequence = 0;
+    do
+    {
+        best = PERSIST_PAGES;
+        for(page = 0; page < PERSIST_PAGES; page++)
+        {
+            if(!(tried & (1 << page)) && Persist_ReadHeader(page, &sequence) &&
+                (PERSIST_PAGES == best || sequence > bestSequence))
+            {
+                best = page;
+                bestSequence = sequence;
+            }
+        }
+        if(best < PERSIST_PAGES)
+        {
+            end = Persist_Walk(best, &last);
+            /* The newest page is the one written on */
+            if(0 == tried)
+            {
+                Persist_page = best;
+                Persist_offset = end;
+                Persist_stats.sequence = bestSequence;
+            }
+            tried |= 1 << best;
+        }
+    }while(best < PERSIST_PAGES && 0 == last);
+    if(last)
+    {
+        data = (const uint8_t*)PERSIST_PAGE_ADDRESS(best);
+        GCounter_Merge(&data[last + PERSIST_RECORD_HEADER], data[last], &changed);
+        Persist_stats.restored = 1;
+    }
+}
+
+/**
+ * @brief Builds a record with the slots of the counter
+ * 
+ * @return uint8_t 1 if the counter changed since the last record and 0 if not
+ */
+static uint8_t Persist_Build(void)
+{
+    uint8_t changed = 0;
+    uint16_t length = 0;
+    uint16_t crc;
+    uint8_t node;
+    for(node = 0; node < GCOUNTER_MAX_NODES; node++)
+    {
+        GCounter_GetSlot(node, &Persist_pending[node]);
+        if(Persist_pending[node] != Persist_saved[node])
+        {
+            changed = 1;
+        }
+        /* An empty slot is the same as not writing it */
+        if(Persist_pending[node])
+        {
+            Persist_record[PERSIST_RECORD_HEADER + length] = node;
+            length += 1 + CounterCodec_PutVarint(Persist_pending[node], &Persist_record[PERSIST_RECORD_HEADER + length + 1]);
+        }
+    }
+    Persist_recordSize = PERSIST_RECORD_SIZE(length);
+    Persist_record[0] = (uint8_t)length;
+    Persist_record[1] = (uint8_t)~length;
+    if(length & 1)
+    {
+        Persist_record[PERSIST_RECORD_HEADER + length] = PERSIST_ERASED;
+    }
+    crc = Frame_Crc16(Persist_record, Persist_recordSize - PERSIST_RECORD_CRC, PERSIST_CRC_INIT);
+    Persist_record[Persist_recordSize - 2] = (uint8_t)crc;
+    Persist_record[Persist_recordSize - 1] = (uint8_t)(crc >> 8);
+    return changed && length;
+}
+
+/**
+ * @brief Called by the flash driver when a job ends
+ * 
+ * @param result the result of the job
+ */
+static void Persist_FlashDone(Std_ReturnType result)
+{
+    Persist_stepResult = result;
+    Persist_stepDone = 1;
+}
+
+/**
+ * @brief Starts the flash job of the current step
+ * 
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the job started
+ *                  E_NOT_OK: If the flash is busy
+ */
+static Std_ReturnType Persist_StartStep(void)
+{
+    Std_ReturnType error = E_NOT_OK;
+    switch(Persist_step)
+    {
+        case PERSIST_STEP_ERASE:
+            error = Flash_Erase(PERSIST_PAGE_ADDRESS(Persist_page), 1, Persist_FlashDone);
+        break;
+        case PERSIST_STEP_HEADER:
+            error = Flash_Write(PERSIST_PAGE_ADDRESS(Persist_page), (const uint8_t*)Persist_header,
+                                sizeof(Persist_header), Persist_FlashDone);
+        break;
+        case PERSIST_STEP_RECORD:
+            error = Flash_Write(PERSIST_PAGE_ADDRESS(Persist_page) + Persist_offset, Persist_record,
+                                Persist_recordSize, Persist_FlashDone);
+        break;
+    }
+    return error;
+}
+
+/**
+ * @brief Moves to the next step once a flash job ends
+ * 
+ */
+static void Persist_EndStep(void)
+{
+    uint8_t node;
+    uint8_t step = Persist_step;
+    Persist_step = PERSIST_STEP_NONE;
+    Persist_stepStarted = 0;
+    if(E_OK != Persist_stepResult)
+    {
+        /* The next record starts a new page after the interval */
+        Persist_stats.errors++;
+        Persist_offset = FLASH_PAGE_SIZE;
+        Persist_resting = 1;
+        Persist_restStart = SYSTICK_getMicros();
+    }
+    else if(PERSIST_STEP_ERASE == step)
+    {
+        Persist_stats.erases++;
+        Persist_step = PERSIST_STEP_HEADER;
+    }
+    else if(PERSIST_STEP_HEADER == step)
+    {
+        Persist_offset = PERSIST_HEADER_SIZE;
+        Persist_step = PERSIST_STEP_RECORD;
+    }
+    else
+    {
+        Persist_offset += Persist_recordSize;
+        Persist_stats.records++;
+        Persist_resting = 1;
+        Persist_restStart = SYSTICK_getMicros();
+        for(node = 0; node < GCOUNTER_MAX_NODES; node++)
+        {
+            Persist_saved[node] = Persist_pending[node];
+        }
+    }
+}
+
+/**
+ * @brief Initializes the persistence and merges the last record into the counter,
+ * the counter has to be initialized first
+ * 
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+Std_ReturnType Persist_Init(void)
+{
+    uint8_t node;
+    Persist_stats.records = 0;
+    Persist_stats.erases = 0;
+    Persist_stats.errors = 0;
+    Persist_stats.restored = 0;
+    Persist_step = PERSIST_STEP_NONE;
+    Persist_stepStarted = 0;
+    Persist_stepDone = 0;
+    Persist_resting = 1;
+    Persist_restStart = SYSTICK_getMicros();
+    Persist_Restore();
+    /* The restored slots are already in the log */
+    for(node = 0; node < GCOUNTER_MAX_NODES; node++)
+    {
+        GCounter_GetSlot(node, &Persist_saved[node]);
+    }
+    return E_OK;
+}
+
+/**
+ * @brief Gets the statistics of the log
+ * 
+ * @param stats where to put the statistics
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+Std_ReturnType Persist_GetStats(persistStats_t* stats)
+{
+    Std_ReturnType error = E_NOT_OK;
+    if(stats)
+    {
+        *stats = Persist_stats;
+        error = E_OK;
+    }
+    return error;
+}
+
+/**
+ * @brief The persistence task, it appends a record when the counter changed and
+ * the last record is old enough
+ * 
+ */
+void Persist_Task(void)
+{
+    if(Persist_stepDone)
+    {
+        Persist_stepDone = 0;
+        Persist_EndStep();
+    }
+    if(PERSIST_STEP_NONE == Persist_step)
+    {
+        if(Persist_resting)
+        {
+            Persist_resting = (SYSTICK_getMicros() - Persist_restStart < PERSIST_INTERVAL_US);
+        }
+        else if(Persist_Build())
+        {
+            if(Persist_offset + Persist_recordSize > FLASH_PAGE_SIZE)
+            {
+                /* The pages are used in turn so they wear the same */
+                Persist_page = (Persist_page + 1) % PERSIST_PAGES;
+                Persist_stats.sequence++;
+                Persist_header[PERSIST_SEQUENCE_INDEX] = (uint16_t)Persist_stats.sequence;
+                Persist_header[PERSIST_SEQUENCE_INDEX + 1] = (uint16_t)(Persist_stats.sequence >> 16);
+                Persist_header[PERSIST_MAGIC_INDEX] = PERSIST_MAGIC;
+                Persist_header[PERSIST_MAGIC_INDEX + 1] = FLASH_ERASED;
+                Persist_step = PERSIST_STEP_ERASE;
+            }
+            else
+            {
+                Persist_step = PERSIST_STEP_RECORD;
+            }
+        }
+    }
+    if(PERSIST_STEP_NONE != Persist_step && !Persist_stepStarted && E_OK == Persist_StartStep())
+    {
+        Persist_stepStarted = 1;
+    }
+}
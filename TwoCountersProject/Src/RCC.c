@@ -36,6 +36,14 @@ typedef struct
 /* Masks used by RCC_configureMCO() function */
 #define RCC_MCO_CONFIG 0x07000000
 
+
+/* Masks used by RCC_getBusClock() function */
+#define RCC_AHB_SHIFT        4
+#define RCC_APB1_SHIFT       8
+#define RCC_APB2_SHIFT       11
+#define RCC_HPRE_DIVIDED     0x8
+#define RCC_PPRE_DIVIDED     0x4
+
 /* 
 * Function Name: RCC_controlAHBPeripheral
 * Function Arguments: 
@@ -297,3 +305,52 @@ void RCC_configureMCO(u32 clkNum)
   (RCC_peripheral->RCC_CFGR) &= ~RCC_MCO_CONFIG;
   (RCC_peripheral->RCC_CFGR) |= clkNum;
 }
+
+
+/**
+* Function Name: RCC_getBusClock
+* Usage: get the current clock of a bus from the configured prescalers
+* Function Arguments:
+* u32 target - takes one of these values
+*   RCC_AHB_PRESCALER 
+*   RCC_APB2_PRESCALER
+*   RCC_APB1_PRESCALER
+
+* u32 sysClk - the system clock in Hz
+* Return: the clock of the bus in Hz
+*/
+u32 RCC_getBusClock(u32 target, u32 sysClk)
+{
+  u32 RCC_CFGR_TEMP = RCC_peripheral->RCC_CFGR;
+  u32 prescalerVal = (RCC_CFGR_TEMP & RCC_AHB_PRESCALER) >> RCC_AHB_SHIFT;
+  u32 clock = sysClk;
+  if (prescalerVal & RCC_HPRE_DIVIDED)
+  {
+    /* 1000 -> /2 ... 1011 -> /16, 1100 -> /64 ... 1111 -> /512 */
+    prescalerVal = (prescalerVal & 0x7) + 1;
+    if (prescalerVal > 4)
+    {
+      prescalerVal++;
+    }
+    clock >>= prescalerVal;
+  }
+  switch(target)
+  {
+    case RCC_APB1_PRESCALER:
+      prescalerVal = (RCC_CFGR_TEMP & RCC_APB1_PRESCALER) >> RCC_APB1_SHIFT;
+    break;
+
+    case RCC_APB2_PRESCALER:
+      prescalerVal = (RCC_CFGR_TEMP & RCC_APB2_PRESCALER) >> RCC_APB2_SHIFT;
+    break;
+
+    default:
+      prescalerVal = 0;
+    break;
+  }
+  if (prescalerVal & RCC_PPRE_DIVIDED)
+  {
+    clock >>= (prescalerVal & 0x3) + 1;
+  }
+  return clock;
+}
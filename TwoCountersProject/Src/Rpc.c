@@ -0,0 +1,137 @@
+/**
+ * @file Rpc.c
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief This is the implementation for the command channel
+ * @version 0.1
+ * @date 2020-04-19
+ * 
+ * @copyright Copyright (c) 2020
+ * 
+ */
+#include "Std_Types.h"
+#include "Link_Cfg.h"
+#include "Link.h"
+#include "Rpc_Cfg.h"
+#include "Rpc.h"
+
+#define RPC_KIND_INDEX               0
+#define RPC_TAG_INDEX                1
+#define RPC_COMMAND_INDEX            2
+#define RPC_STATUS_INDEX             2
+
+typedef struct
+{
+    uint8_t tag;
+    uint8_t command;
+    uint8_t args[RPC_MAX_DATA];
+    uint8_t argLength;
+}rpcRequest_t;
+
+extern const rpcCommand_t Rpc_commands[RPC_COMMAND_COUNT];
+
+static rpcRequest_t Rpc_queue[RPC_QUEUE_LENGTH];
+static uint8_t Rpc_queueHead;
+static uint8_t Rpc_queueCount;
+
+/* A response the link refused, it is sent again before the next request runs */
+static uint8_t Rpc_response[LINK_MAX_PAYLOAD];
+static uint8_t Rpc_responseLength;
+
+/**
+ * @brief Runs a request and builds its response
+ * 
+ * @param request the request
+ */
+static void Rpc_Run(const rpcRequest_t* request)
+{
+    uint8_t status = RPC_STATUS_UNKNOWN;
+    uint8_t replyLength = 0;
+    const rpcCommand_t* command;
+    /* The command is the index in the table */
+    if(request->command < RPC_COMMAND_COUNT && Rpc_commands[request->command].handler)
+    {
+        command = &Rpc_commands[request->command];
+        if(command->argLength != RPC_ANY_LENGTH && command->argLength != request->argLength)
+        {
+            status = RPC_STATUS_BAD_ARGS;
+        }
+        else
+        {
+            status = command->handler(request->args, request->argLength, &Rpc_response[RPC_HEADER_SIZE], &replyLength);
+            if(replyLength > RPC_MAX_DATA)
+            {
+                replyLength = 0;
+                status = RPC_STATUS_FAILED;
+            }
+        }
+    }
+    Rpc_response[RPC_KIND_INDEX] = RPC_MSG_RESPONSE;
+    Rpc_response[RPC_TAG_INDEX] = request->tag;
+    Rpc_response[RPC_STATUS_INDEX] = status;
+    Rpc_responseLength = RPC_HEADER_SIZE + replyLength;
+}
+
+/**
+ * @brief Initializes the command channel, the link has to be initialized first
+ * 
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+Std_ReturnType Rpc_Init(void)
+{
+    Rpc_queueHead = 0;
+    Rpc_queueCount = 0;
+    Rpc_responseLength = 0;
+    return E_OK;
+}
+
+/**
+ * @brief Queues a request received from the link, it is run by Rpc_Task
+ * 
+ * @param data the message starting with RPC_MSG_REQUEST
+ * @param length the length of the message
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the request is queued
+ *                  E_NOT_OK: If the message is not a request or the queue is full
+ */
+Std_ReturnType Rpc_Receive(const uint8_t* data, uint16_t length)
+{
+    Std_ReturnType error = E_NOT_OK;
+    rpcRequest_t* request;
+    uint8_t i;
+    /* A dropped request is not answered, the client asks again */
+    if(data && length >= RPC_HEADER_SIZE && length <= LINK_MAX_PAYLOAD &&
+        data[RPC_KIND_INDEX] == RPC_MSG_REQUEST && Rpc_queueCount < RPC_QUEUE_LENGTH)
+    {
+        request = &Rpc_queue[(Rpc_queueHead + Rpc_queueCount) % RPC_QUEUE_LENGTH];
+        request->tag = data[RPC_TAG_INDEX];
+        request->command = data[RPC_COMMAND_INDEX];
+        request->argLength = (uint8_t)(length - RPC_HEADER_SIZE);
+        for(i = 0; i < request->argLength; i++)
+        {
+            request->args[i] = data[RPC_HEADER_SIZE + i];
+        }
+        Rpc_queueCount++;
+        error = E_OK;
+    }
+    return error;
+}
+
+/**
+ * @brief The command task, it runs the queued requests and sends the responses
+ * 
+ */
+void Rpc_Task(void)
+{
+    if(Rpc_responseLength == 0 && Rpc_queueCount)
+    {
+        Rpc_Run(&Rpc_queue[Rpc_queueHead]);
+        Rpc_queueHead = (Rpc_queueHead + 1) % RPC_QUEUE_LENGTH;
+        Rpc_queueCount--;
+    }
+    if(Rpc_responseLength && E_OK == Link_Send(Rpc_response, Rpc_responseLength))
+    {
+        Rpc_responseLength = 0;
+    }
+}
@@ -0,0 +1,214 @@
+/**
+ * @file Rpc_Cfg.c
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief These are the commands of the command channel, the numbers in the
+ * replies are little endian
+ * @version 0.1
+ * @date 2020-04-19
+ * 
+ * @copyright Copyright (c) 2020
+ * 
+ */
+#include "Std_Types.h"
+#include "SCHED1.h"
+#include "SCHED_CONF.h"
+#include "HUart_Cfg.h"
+#include "HUart.h"
+#include "Transport.h"
+#include "Transport_Cfg.h"
+#include "CLcd.h"
+#include "Link_Cfg.h"
+#include "Link.h"
+#include "Rpc_Cfg.h"
+#include "Rpc.h"
+
+#define RPC_SATURATE_16(value)       ((value) > 0xFFFF ? 0xFFFF : (uint16_t)(value))
+
+/**
+ * @brief Writes a 16 bit number
+ * 
+ * @param value the number
+ * @param reply where to write it
+ * @param replyLength the length of the reply, it is moved past the number
+ */
+static void Rpc_Put16(uint16_t value, uint8_t* reply, uint8_t* replyLength)
+{
+    reply[(*replyLength)++] = (uint8_t)value;
+    reply[(*replyLength)++] = (uint8_t)(value >> 8);
+}
+
+/**
+ * @brief Writes a 32 bit number
+ * 
+ * @param value the number
+ * @param reply where to write it
+ * @param replyLength the length of the reply, it is moved past the number
+ */
+static void Rpc_Put32(uint32_t value, uint8_t* reply, uint8_t* replyLength)
+{
+    Rpc_Put16((uint16_t)value, reply, replyLength);
+    Rpc_Put16((uint16_t)(value >> 16), reply, replyLength);
+}
+
+/**
+ * @brief Sends the arguments back
+ * 
+ */
+static uint8_t Rpc_Ping(const uint8_t* args, uint8_t argLength, uint8_t* reply, uint8_t* replyLength)
+{
+    uint8_t i;
+    for(i = 0; i < argLength; i++)
+    {
+        reply[i] = args[i];
+    }
+    *replyLength = argLength;
+    return RPC_STATUS_OK;
+}
+
+/**
+ * @brief Replies with the scheduler load in per mille, the longest tick in micro
+ * seconds and the number of lost ticks
+ * 
+ */
+static uint8_t Rpc_SchedStats(const uint8_t* args, uint8_t argLength, uint8_t* reply, uint8_t* replyLength)
+{
+    SchedStats stats;
+    uint32_t load = 0;
+    (void)args;
+    (void)argLength;
+    SCHED_getStats(&stats);
+    if(stats.ticks)
+    {
+        load = (uint32_t)((uint64_t)stats.busyUs * 1000 / ((uint64_t)stats.ticks * SCHED_TICK_TIME_US));
+    }
+    Rpc_Put16(RPC_SATURATE_16(load), reply, replyLength);
+    Rpc_Put16(RPC_SATURATE_16(stats.maxTickUs), reply, replyLength);
+    Rpc_Put32(stats.overruns, reply, replyLength);
+    return RPC_STATUS_OK;
+}
+
+/**
+ * @brief Replies with the frames sent and received on the link UART
+ * 
+ */
+static uint8_t Rpc_UartTraffic(const uint8_t* args, uint8_t argLength, uint8_t* reply, uint8_t* replyLength)
+{
+    uint8_t status = RPC_STATUS_FAILED;
+    hUartStats_t stats;
+    (void)args;
+    (void)argLength;
+    if(E_OK == HUart_GetStatsOn(TRANSPORT_HUART_MODULE, &stats))
+    {
+        Rpc_Put32(stats.txFrames, reply, replyLength);
+        Rpc_Put32(stats.rxFrames, reply, replyLength);
+        status = RPC_STATUS_OK;
+    }
+    return status;
+}
+
+/**
+ * @brief Replies with the overrun, framing, noise and parity errors of the link UART
+ * 
+ */
+static uint8_t Rpc_UartErrors(const uint8_t* args, uint8_t argLength, uint8_t* reply, uint8_t* replyLength)
+{
+    uint8_t status = RPC_STATUS_FAILED;
+    hUartStats_t stats;
+    (void)args;
+    (void)argLength;
+    if(E_OK == HUart_GetStatsOn(TRANSPORT_HUART_MODULE, &stats))
+    {
+        Rpc_Put16(RPC_SATURATE_16(stats.overruns), reply, replyLength);
+        Rpc_Put16(RPC_SATURATE_16(stats.framingErrors), reply, replyLength);
+        Rpc_Put16(RPC_SATURATE_16(stats.noiseErrors), reply, replyLength);
+        Rpc_Put16(RPC_SATURATE_16(stats.parityErrors), reply, replyLength);
+        status = RPC_STATUS_OK;
+    }
+    return status;
+}
+
+/**
+ * @brief Replies with the LCD busy flag and the number of requests it turned away
+ * 
+ */
+static uint8_t Rpc_LcdStatus(const uint8_t* args, uint8_t argLength, uint8_t* reply, uint8_t* replyLength)
+{
+    clcdStatus_t status;
+    (void)args;
+    (void)argLength;
+    CLcd_GetStatus(&status);
+    reply[(*replyLength)++] = status.busy;
+    Rpc_Put32(status.rejected, reply, replyLength);
+    return RPC_STATUS_OK;
+}
+
+/**
+ * @brief Replies with the retransmissions, the smoothed RTT and the RTO of the link
+ * 
+ */
+static uint8_t Rpc_LinkStats(const uint8_t* args, uint8_t argLength, uint8_t* reply, uint8_t* replyLength)
+{
+    linkStats_t stats;
+    (void)args;
+    (void)argLength;
+    Link_GetStats(&stats);
+    Rpc_Put32(stats.retransmits, reply, replyLength);
+    Rpc_Put16(stats.srttMs, reply, replyLength);
+    Rpc_Put16(stats.rtoMs, reply, replyLength);
+    return RPC_STATUS_OK;
+}
+
+/**
+ * @brief Changes the period of a task created with SCHED_TASK_TUNABLE, the arguments
+ * are the task priority and the period in milli seconds
+ * 
+ */
+static uint8_t Rpc_SetPeriod(const uint8_t* args, uint8_t argLength, uint8_t* reply, uint8_t* replyLength)
+{
+    uint8_t status = RPC_STATUS_BAD_ARGS;
+    uint32_t period = (uint32_t)args[1] | ((uint32_t)args[2] << 8);
+    (void)argLength;
+    (void)reply;
+    (void)replyLength;
+    /* The scheduler refuses the tasks that count their runs as time */
+    if(E_OK == SCHED_setPeriod(args[0], period * 1000))
+    {
+        status = RPC_STATUS_OK;
+    }
+    return status;
+}
+
+/**
+ * @brief Clears the statistics selected by the RPC_RESET_ mask in the argument
+ * 
+ */
+static uint8_t Rpc_ResetStats(const uint8_t* args, uint8_t argLength, uint8_t* reply, uint8_t* replyLength)
+{
+    (void)argLength;
+    (void)reply;
+    (void)replyLength;
+    if(args[0] & RPC_RESET_SCHED)
+    {
+        SCHED_resetStats();
+    }
+    if(args[0] & RPC_RESET_UART)
+    {
+        HUart_ResetStatsOn(TRANSPORT_HUART_MODULE);
+    }
+    if(args[0] & RPC_RESET_LCD)
+    {
+        CLcd_ResetStatus();
+    }
+    return RPC_STATUS_OK;
+}
+
+const rpcCommand_t Rpc_commands[RPC_COMMAND_COUNT] = {
+    [RPC_CMD_PING]          = {Rpc_Ping, RPC_ANY_LENGTH},
+    [RPC_CMD_SCHED_STATS]   = {Rpc_SchedStats, 0},
+    [RPC_CMD_UART_TRAFFIC]  = {Rpc_UartTraffic, 0},
+    [RPC_CMD_UART_ERRORS]   = {Rpc_UartErrors, 0},
+    [RPC_CMD_LCD_STATUS]    = {Rpc_LcdStatus, 0},
+    [RPC_CMD_LINK_STATS]    = {Rpc_LinkStats, 0},
+    [RPC_CMD_SET_PERIOD]    = {Rpc_SetPeriod, 3},
+    [RPC_CMD_RESET_STATS]   = {Rpc_ResetStats, 1}
+};
@@ -25,6 +25,7 @@ typedef struct
 
 static SysTask sysTasks[SCHED_MAX_TASK_NUM];
 static volatile u8 OS_FLAG = 0;
+static volatile SchedStats schedStats;
 
 /**
  * @brief The scheduler
@@ -33,6 +34,8 @@ static volatile u8 OS_FLAG = 0;
 static void SCHED_schedule(void)
 {
   u32 currentTask = 0;
+  u32 startTime = SYSTICK_getMicros();
+  u32 busyTime;
   for (currentTask = 0; currentTask < SCHED_MAX_TASK_NUM; currentTask++)
   {
     if((sysTasks[currentTask].RemainToExec) == 0)
@@ -42,6 +45,13 @@ static void SCHED_schedule(void)
     }
     sysTasks[currentTask].RemainToExec--;
   }
+  busyTime = SYSTICK_getMicros() - startTime;
+  schedStats.ticks++;
+  schedStats.busyUs += busyTime;
+  if (busyTime > schedStats.maxTickUs)
+  {
+    schedStats.maxTickUs = busyTime;
+  }
 }
 
 /**
@@ -50,6 +60,11 @@ static void SCHED_schedule(void)
  */
 static void SCHED_setFlag(void)
 {
+  /* The tasks of the last tick are still running, this tick is lost */
+  if (OS_FLAG)
+  {
+    schedStats.overruns++;
+  }
   OS_FLAG = 1;
 }
 
@@ -115,3 +130,58 @@ void SCHED_start(void)
     }
   }
 }
+/**
+ * @brief Changes the period of a task created with SCHED_TASK_TUNABLE, such a task
+ * times itself on the SysTick so its timeouts stay the same, only how often they
+ * are checked changes
+ * 
+ * @param priority The priority of the task
+ * @param periodicTime The new period in micro seconds, at least one tick
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If there is no such task, its period is fixed or the period is too short
+ */
+Std_ReturnType SCHED_setPeriod(u32 priority, u32 periodicTime)
+{
+  Std_ReturnType error = E_NOT_OK;
+  if (priority < SCHED_MAX_TASK_NUM && sysTasks[priority].appTask &&
+      (sysTasks[priority].appTask->flags & SCHED_TASK_TUNABLE) && periodicTime >= SCHED_TICK_TIME_US)
+  {
+    sysTasks[priority].appTask->periodicTime = periodicTime;
+    sysTasks[priority].periodicTimeTicks = periodicTime / SCHED_TICK_TIME_US;
+    /* A shorter period takes effect now instead of after the old one */
+    if (sysTasks[priority].RemainToExec > sysTasks[priority].periodicTimeTicks)
+    {
+      sysTasks[priority].RemainToExec = sysTasks[priority].periodicTimeTicks;
+    }
+    error = E_OK;
+  }
+  return error;
+}
+/**
+ * @brief Gets the load statistics of the scheduler
+ * 
+ * @param stats where to copy the statistics
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+Std_ReturnType SCHED_getStats(SchedStats *stats)
+{
+  Std_ReturnType error = E_NOT_OK;
+  if (stats)
+  {
+    *stats = schedStats;
+    error = E_OK;
+  }
+  return error;
+}
+/**
+ * @brief Clears the load statistics of the scheduler
+ * 
+ */
+void SCHED_resetStats(void)
+{
+  SchedStats emptyStats = {0};
+  schedStats = emptyStats;
+}
@@ -24,6 +24,10 @@ typedef struct
 #define SYSTICK_BASE_ADDRESS 0xE000E010
 #define SYSTICK_peripheral ((volatile SYSTICK_regMap *) SYSTICK_BASE_ADDRESS)
 
+/* Interrupt control and state register, the SysTick pending bit */
+#define SYSTICK_ICSR            (*(volatile u32 *) 0xE000ED04)
+#define SYSTICK_PENDSTSET_MASK  0x04000000
+
 
 #define SYSTICK_ENABLE_SETMASK  0x00000001
 #define SYSTICK_TICKINT_SETMASK 0x00000002
@@ -32,6 +36,10 @@ typedef struct
 
 static SYSTICK_cbF AppCbF;
 
+static volatile u32 SYSTICK_ticks;
+static u32 SYSTICK_periodUs;
+static u32 SYSTICK_cyclesPerUs = 1;
+
 /**
  * @brief The initialization of the SysTick
  * 
@@ -75,6 +83,12 @@ void SYSTICK_setTime(u32 time, u32 AHB_clockHz)
   f32 countFloat = time * (clock/1000000.0);
   u32 count = (u32)countFloat & 0x00FFFFFF;
   (SYSTICK_peripheral->LOAD) = count;
+  SYSTICK_periodUs = time;
+  SYSTICK_cyclesPerUs = clock / 1000000;
+  if (SYSTICK_cyclesPerUs == 0)
+  {
+    SYSTICK_cyclesPerUs = 1;
+  }
 }
 /**
  * @brief Sets the callback function
@@ -88,12 +102,36 @@ void SYSTICK_setCallbackFcn(SYSTICK_cbF cbF)
     AppCbF = cbF;
   }
 }
+/**
+ * @brief Gets the time since the SysTick was started
+ * *It can be called from an interrupt that blocks the SysTick handler
+ * 
+ * @return u32 the time in micro seconds, it wraps around after about 71 minutes
+ */
+u32 SYSTICK_getMicros(void)
+{
+  u32 ticks;
+  u32 count;
+  do
+  {
+    ticks = SYSTICK_ticks;
+    count = SYSTICK_peripheral->VAL;
+  } while (ticks != SYSTICK_ticks);
+  if (SYSTICK_ICSR & SYSTICK_PENDSTSET_MASK)
+  {
+    /* The counter wrapped but the handler could not run yet */
+    count = SYSTICK_peripheral->VAL;
+    ticks++;
+  }
+  return (ticks * SYSTICK_periodUs) + ((SYSTICK_peripheral->LOAD - count) / SYSTICK_cyclesPerUs);
+}
 /**
  * @brief The SysTick Handler
  * 
  */
 void SysTick_Handler(void)
 {
+  SYSTICK_ticks++;
   if(AppCbF)
   {
     AppCbF();
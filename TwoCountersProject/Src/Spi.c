@@ -0,0 +1,206 @@
+/**
+ * @file Spi.c
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief This is the implementation for the SPI driver
+ * @version 0.1
+ * @date 2020-04-10
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include "Std_Types.h"
+#include "Spi_Cfg.h"
+#include "Spi.h"
+
+#define SPI_NUMBER_OF_MODULES        2
+
+typedef struct 
+{
+  uint32_t CR1;
+  uint32_t CR2;
+  uint32_t SR;
+  uint32_t DR;
+  uint32_t CRCPR;
+  uint32_t RXCRCR;
+  uint32_t TXCRCR;
+  uint32_t I2SCFGR;
+  uint32_t I2SPR;
+} spi_t;
+
+typedef struct 
+{
+  const uint8_t *tx;
+  uint8_t *rx;
+  uint16_t pos;
+  uint16_t size;
+  uint8_t state;
+} transfer_t;
+
+#define SPI_TRANSFER_IDLE 0
+#define SPI_TRANSFER_BUSY 1
+
+/*SPI enable*/
+#define SPI_SPE_SET 0x00000040
+/*RX buffer not empty interrupt enable*/
+#define SPI_RXNEIE_SET 0x00000040
+#define SPI_RXNEIE_CLR 0xFFFFFFBF
+
+/*Receive buffer not empty*/
+#define SPI_RXNE_GET 0x00000001
+
+const uint32_t Spi_Address[SPI_NUMBER_OF_MODULES] = {
+  0x40013000,
+  0x40003800
+};
+
+static volatile transfer_t Spi_transfer[SPI_NUMBER_OF_MODULES];
+
+static volatile spiDoneCb_t appDone[SPI_NUMBER_OF_MODULES];
+/**
+ * @brief The Interrupt Handler for the SPI driver, the next byte is only
+ * written once the previous one is received
+ * 
+ * @param spiModule the module number of the SPI
+ *                 SPI1
+ *                 SPI2
+ */
+static void SPI_IRQHandler(uint8_t spiModule)
+{
+  volatile spi_t* Spi = (volatile spi_t*)Spi_Address[spiModule];
+  volatile transfer_t* transfer = &Spi_transfer[spiModule];
+  uint8_t data;
+  uint16_t length;
+  if (SPI_RXNE_GET & Spi->SR) 
+  {
+    data = (uint8_t)Spi->DR;
+    if (SPI_TRANSFER_BUSY == transfer->state) 
+    {
+      if (transfer->rx) 
+      {
+        transfer->rx[transfer->pos] = data;
+      }
+      transfer->pos++;
+      if (transfer->pos < transfer->size) 
+      {
+        Spi->DR = transfer->tx ? transfer->tx[transfer->pos] : SPI_DUMMY_BYTE;
+      } 
+      else 
+      {
+        Spi->CR2 &= SPI_RXNEIE_CLR;
+        length = transfer->size;
+        transfer->tx = NULL;
+        transfer->rx = NULL;
+        transfer->state = SPI_TRANSFER_IDLE;
+        if (appDone[spiModule]) 
+        {
+          appDone[spiModule](spiModule, length);
+        }
+      }
+    }
+  }
+}
+/**
+ * @brief The SPI 1 Handler
+ * 
+ */
+void SPI1_IRQHandler(void)
+{
+  SPI_IRQHandler(SPI1);
+}
+/**
+ * @brief The SPI 2 Handler
+ * 
+ */
+void SPI2_IRQHandler(void)
+{
+  SPI_IRQHandler(SPI2);
+}
+/**
+ * @brief Initializes the SPI, the GPIO pins, the clock and the interrupt of the
+ * module have to be set up by the user
+ *
+ * @param role the role of the module
+ *                 SPI_MASTER
+ *                 SPI_SLAVE
+ * @param mode the clock polarity and phase
+ *                 SPI_MODE_0
+ *                 SPI_MODE_1
+ *                 SPI_MODE_2
+ *                 SPI_MODE_3
+ * @param baudDiv the division of the bus clock for the master
+ *                 SPI_BAUD_DIV_2 to SPI_BAUD_DIV_256
+ * @param spiModule the module number of the SPI
+ *                 SPI1
+ *                 SPI2
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+Std_ReturnType Spi_Init(uint32_t role, uint32_t mode, uint32_t baudDiv, uint8_t spiModule) 
+{
+  Std_ReturnType error = E_NOT_OK;
+  volatile spi_t* Spi;
+  if (spiModule < SPI_NUMBER_OF_MODULES) 
+  {
+    Spi = (volatile spi_t*)Spi_Address[spiModule];
+    Spi->CR1 = 0;
+    Spi->CR2 = 0;
+    Spi_transfer[spiModule].state = SPI_TRANSFER_IDLE;
+    /* 8-bit frames, MSB first */
+    Spi->CR1 = role | mode | baudDiv;
+    Spi->CR1 |= SPI_SPE_SET;
+    error = E_OK;
+  }
+  return error;
+}
+/**
+ * @brief Exchanges data through the SPI, one byte is received for every byte sent
+ * *A slave only moves when the master gives the clock
+ *
+ * @param txData the data to send or NULL to send SPI_DUMMY_BYTE
+ * @param rxData the buffer to receive in or NULL to drop the received bytes
+ * @param length the number of bytes to exchange
+ * @param spiModule the module number of the SPI
+ *                 SPI1
+ *                 SPI2
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the driver started the transfer
+ *                  E_NOT_OK: If the driver is busy with another transfer
+ */
+Std_ReturnType Spi_Transfer(const uint8_t *txData, uint8_t *rxData, uint16_t length, uint8_t spiModule) 
+{
+  Std_ReturnType error = E_NOT_OK;
+  volatile spi_t* Spi = (volatile spi_t*)Spi_Address[spiModule];
+  volatile transfer_t* transfer = &Spi_transfer[spiModule];
+  if (length > 0 && SPI_TRANSFER_IDLE == transfer->state) 
+  {
+    transfer->state = SPI_TRANSFER_BUSY;
+    transfer->tx = txData;
+    transfer->rx = rxData;
+    transfer->pos = 0;
+    transfer->size = length;
+    /* A byte left over from before the transfer is dropped */
+    (void)Spi->DR;
+    Spi->DR = txData ? txData[0] : SPI_DUMMY_BYTE;
+    Spi->CR2 |= SPI_RXNEIE_SET;
+    error = E_OK;
+  }
+  return error;
+}
+/**
+ * @brief Sets the callback function that will be called when a transfer is
+ * completed
+ *
+ * @param func the callback function
+ * @param spiModule the module number of the SPI
+ *                 SPI1
+ *                 SPI2
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+Std_ReturnType Spi_SetDoneCb(spiDoneCb_t func, uint8_t spiModule) 
+{
+  appDone[spiModule] = func;
+  return E_OK;
+}
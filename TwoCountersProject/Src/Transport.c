@@ -0,0 +1,719 @@
+/**
+ * @file Transport.c
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief This is the implementation for the transport layer and its HUart,
+ * SPI and loopback backends
+ * @version 0.1
+ * @date 2020-04-10
+ * 
+ * @copyright Copyright (c) 2020
+ * 
+ */
+#include "Std_Types.h"
+#include "HUart_Cfg.h"
+#include "HUart.h"
+#include "Spi_Cfg.h"
+#include "Spi.h"
+#include "RCC.h"
+#include "Gpio.h"
+#include "NVIC.h"
+#include "Transport.h"
+#include "Transport_Cfg.h"
+
+#define TRANSPORT_NUMBER_OF_BACKENDS  3
+
+typedef struct
+{
+    uint8_t tx[TRANSPORT_SPI_MAX_FRAME];
+    uint16_t txLength;
+    uint8_t* rx;
+    uint16_t rxLength;
+    uint8_t busy;
+    uint8_t txInTransfer;
+    uint8_t rxInTransfer;
+    /* The bytes of the transfers no receive was armed for, read with Transport_Read */
+    uint8_t streamRx[TRANSPORT_SPI_MAX_FRAME];
+    uint8_t streamInTransfer;
+    uint8_t stream[TRANSPORT_SPI_STREAM_SIZE];
+    uint16_t streamHead;
+    uint16_t streamLevel;
+
+}transportSpi_t;
+
+typedef struct
+{
+    uint8_t data[TRANSPORT_LOOPBACK_SIZE];
+    uint16_t head;
+    uint16_t level;
+    uint8_t* rx;
+    uint16_t rxLength;
+    uint16_t rxPos;
+
+}transportLoopback_t;
+
+static Std_ReturnType Transport_HUartInit(void);
+static Std_ReturnType Transport_HUartSend(const uint8_t* data, uint16_t length);
+static Std_ReturnType Transport_HUartReceive(uint8_t* data, uint16_t length, uint16_t interByteTimeout);
+static Std_ReturnType Transport_HUartRead(uint8_t* data, uint16_t maxLength, uint16_t* count);
+static Std_ReturnType Transport_HUartGetCaps(transportCaps_t* caps);
+static Std_ReturnType Transport_SpiInit(void);
+static Std_ReturnType Transport_SpiSend(const uint8_t* data, uint16_t length);
+static Std_ReturnType Transport_SpiReceive(uint8_t* data, uint16_t length, uint16_t interByteTimeout);
+static Std_ReturnType Transport_SpiRead(uint8_t* data, uint16_t maxLength, uint16_t* count);
+static Std_ReturnType Transport_SpiGetCaps(transportCaps_t* caps);
+static Std_ReturnType Transport_LoopbackInit(void);
+static Std_ReturnType Transport_LoopbackSend(const uint8_t* data, uint16_t length);
+static Std_ReturnType Transport_LoopbackReceive(uint8_t* data, uint16_t length, uint16_t interByteTimeout);
+static Std_ReturnType Transport_LoopbackRead(uint8_t* data, uint16_t maxLength, uint16_t* count);
+static Std_ReturnType Transport_LoopbackGetCaps(transportCaps_t* caps);
+
+static const transport_t Transport_backends[TRANSPORT_NUMBER_OF_BACKENDS] = {
+    {Transport_HUartInit, Transport_HUartSend, Transport_HUartReceive, Transport_HUartRead, Transport_HUartGetCaps},
+    {Transport_SpiInit, Transport_SpiSend, Transport_SpiReceive, Transport_SpiRead, Transport_SpiGetCaps},
+    {Transport_LoopbackInit, Transport_LoopbackSend, Transport_LoopbackReceive, Transport_LoopbackRead, Transport_LoopbackGetCaps}
+};
+
+static const transport_t* Transport_current;
+
+static volatile transportTxCb_t Transport_txCb;
+static volatile transportRxCb_t Transport_rxCb;
+
+static volatile transportSpi_t Transport_spi;
+static volatile transportLoopback_t Transport_loopback;
+
+/**
+ * @brief Tells the user a frame is sent
+ * 
+ * @param length the length of the frame
+ */
+static void Transport_TxDone(uint16_t length)
+{
+    if(Transport_txCb)
+    {
+        Transport_txCb(length);
+    }
+}
+
+/**
+ * @brief Tells the user a receive ended
+ * 
+ * @param length the number of bytes received
+ * @param status TRANSPORT_RX_COMPLETE or TRANSPORT_RX_TIMEOUT
+ */
+static void Transport_RxDone(uint16_t length, uint8_t status)
+{
+    if(Transport_rxCb)
+    {
+        Transport_rxCb(length, status);
+    }
+}
+
+/**
+ * @brief Called by HUart when a transmission is done
+ * 
+ * @param uartModule the module
+ * @param length the number of bytes sent
+ */
+static void Transport_HUartTxNotify(uint8_t uartModule, uint16_t length)
+{
+    (void)uartModule;
+    Transport_TxDone(length);
+}
+
+/**
+ * @brief Called by HUart when a receive request ends
+ * 
+ * @param uartModule the module
+ * @param length the number of bytes received
+ * @param status the receive status
+ */
+static void Transport_HUartRxStatus(uint8_t uartModule, uint16_t length, uint8_t status)
+{
+    (void)uartModule;
+    Transport_RxDone(length, (HUART_RX_COMPLETE == status) ? TRANSPORT_RX_COMPLETE : TRANSPORT_RX_TIMEOUT);
+}
+
+/**
+ * @brief Initializes the HUart backend
+ * 
+ * @return Std_ReturnType 
+ */
+static Std_ReturnType Transport_HUartInit(void)
+{
+    Std_ReturnType error = HUart_InitOn(TRANSPORT_HUART_MODULE);
+    error |= HUart_SetTxNotifyOn(TRANSPORT_HUART_MODULE, Transport_HUartTxNotify);
+    error |= HUart_SetRxStatusCbOn(TRANSPORT_HUART_MODULE, Transport_HUartRxStatus);
+    return error;
+}
+
+/**
+ * @brief Sends a frame through HUart from a pool block
+ * 
+ * @param data the frame
+ * @param length the length of the frame
+ * @return Std_ReturnType 
+ */
+static Std_ReturnType Transport_HUartSend(const uint8_t* data, uint16_t length)
+{
+    Std_ReturnType error = E_NOT_OK;
+    uint8_t* block;
+    uint16_t i;
+    if(length <= HUART_POOL_BLOCK_SIZE && E_OK == HUart_AllocBlock(&block))
+    {
+        for(i=0; i<length; i++)
+        {
+            block[i] = data[i];
+        }
+        error = HUart_SendBlockOn(TRANSPORT_HUART_MODULE, block, length);
+    }
+    return error;
+}
+
+/**
+ * @brief Receives a frame through HUart
+ * 
+ * @param data the buffer
+ * @param length the length of the frame
+ * @param interByteTimeout the inter-byte timeout
+ * @return Std_ReturnType 
+ */
+static Std_ReturnType Transport_HUartReceive(uint8_t* data, uint16_t length, uint16_t interByteTimeout)
+{
+    return HUart_ReceiveTimeoutOn(TRANSPORT_HUART_MODULE, data, length, 0, interByteTimeout);
+}
+
+/**
+ * @brief Reads the bytes HUart received while no receive was armed
+ * 
+ * @param data the buffer
+ * @param maxLength the size of the buffer
+ * @param count the number of bytes read
+ * @return Std_ReturnType 
+ */
+static Std_ReturnType Transport_HUartRead(uint8_t* data, uint16_t maxLength, uint16_t* count)
+{
+    return HUart_ReadOn(TRANSPORT_HUART_MODULE, data, maxLength, count);
+}
+
+/**
+ * @brief Gets the capabilities of the HUart backend
+ * 
+ * @param caps where to copy the capabilities
+ * @return Std_ReturnType 
+ */
+static Std_ReturnType Transport_HUartGetCaps(transportCaps_t* caps)
+{
+    sint32_t errorPpm;
+    caps->flags = TRANSPORT_CAP_RX_TIMEOUT | TRANSPORT_CAP_TX_ANYTIME | TRANSPORT_CAP_RX_ANYTIME | TRANSPORT_CAP_HARDWARE | TRANSPORT_CAP_STREAM;
+    caps->maxFrame = HUART_POOL_BLOCK_SIZE;
+    return HUart_GetBaudRateOn(TRANSPORT_HUART_MODULE, &caps->bitRate, &errorPpm);
+}
+
+/**
+ * @brief Starts the next SPI transfer if the driver is free, a pending frame is
+ * sent and an armed receive takes the bytes coming back while it is sent, without
+ * an armed receive they go to the stream
+ * *A slave also starts a transfer for a receive alone and waits for the clock, with
+ * nothing armed it takes the stream a byte at a time
+ * 
+ */
+static void Transport_SpiKick(void)
+{
+    volatile transportSpi_t* spi = &Transport_spi;
+    uint16_t length = 0;
+    uint8_t useTx = 0;
+    uint8_t useRx = 0;
+    uint8_t* rx = NULL;
+    NVIC_controlAllPeripheral(NVIC_DISABLE);
+    if(!spi->busy)
+    {
+        if(spi->txLength)
+        {
+            length = spi->txLength;
+            useTx = 1;
+            useRx = (spi->rx && spi->rxLength == spi->txLength);
+        }
+        else if(spi->rx && SPI_SLAVE == TRANSPORT_SPI_ROLE)
+        {
+            length = spi->rxLength;
+            useRx = 1;
+        }
+        else if(SPI_SLAVE == TRANSPORT_SPI_ROLE)
+        {
+            length = 1;
+        }
+        if(useRx)
+        {
+            rx = spi->rx;
+        }
+        else if(NULL == spi->rx)
+        {
+            rx = (uint8_t*)spi->streamRx;
+        }
+        if(length && E_OK == Spi_Transfer(useTx ? (const uint8_t*)spi->tx : NULL, rx, length, TRANSPORT_SPI_MODULE))
+        {
+            spi->busy = 1;
+            spi->txInTransfer = useTx;
+            spi->rxInTransfer = useRx;
+            spi->streamInTransfer = (rx && !useRx);
+        }
+    }
+    NVIC_controlAllPeripheral(NVIC_ENABLE);
+}
+
+/**
+ * @brief Called by the SPI driver when a transfer is done
+ * 
+ * @param spiModule the module
+ * @param length the number of bytes exchanged
+ */
+static void Transport_SpiDone(uint8_t spiModule, uint16_t length)
+{
+    volatile transportSpi_t* spi = &Transport_spi;
+    uint16_t i;
+    (void)spiModule;
+    spi->busy = 0;
+    if(spi->txInTransfer)
+    {
+        spi->txInTransfer = 0;
+        spi->txLength = 0;
+        Transport_TxDone(length);
+    }
+    if(spi->rxInTransfer)
+    {
+        spi->rxInTransfer = 0;
+        spi->rx = NULL;
+        Transport_RxDone(length, TRANSPORT_RX_COMPLETE);
+    }
+    if(spi->streamInTransfer)
+    {
+        spi->streamInTransfer = 0;
+        /* The bytes that do not fit are dropped, the framing above finds its way back */
+        for(i=0; i<length && spi->streamLevel < TRANSPORT_SPI_STREAM_SIZE; i++)
+        {
+            spi->stream[(spi->streamHead + spi->streamLevel) % TRANSPORT_SPI_STREAM_SIZE] = spi->streamRx[i];
+            spi->streamLevel++;
+        }
+    }
+    Transport_SpiKick();
+}
+
+/**
+ * @brief Initializes the SPI backend with its pins, clock and interrupt
+ * 
+ * @return Std_ReturnType 
+ */
+static Std_ReturnType Transport_SpiInit(void)
+{
+    gpio_t gpio;
+    uint32_t sckPin;
+    uint32_t misoPin;
+    uint32_t mosiPin;
+    if(SPI1 == TRANSPORT_SPI_MODULE)
+    {
+        RCC_controlAPB2Peripheral(RCC_GPIOA, ENABLE);
+        RCC_controlAPB2Peripheral(RCC_SPI1, ENABLE);
+        gpio.port = GPIO_PORTA;
+        sckPin = GPIO_PIN_5;
+        misoPin = GPIO_PIN_6;
+        mosiPin = GPIO_PIN_7;
+    }
+    else
+    {
+        RCC_controlAPB2Peripheral(RCC_GPIOB, ENABLE);
+        RCC_controlAPB1Peripheral(RCC_SPI2_I2S, ENABLE);
+        gpio.port = GPIO_PORTB;
+        sckPin = GPIO_PIN_13;
+        misoPin = GPIO_PIN_14;
+        mosiPin = GPIO_PIN_15;
+    }
+    gpio.speed = GPIO_SPEED_50_MHZ;
+    if(SPI_MASTER == TRANSPORT_SPI_ROLE)
+    {
+        gpio.pins = sckPin | mosiPin;
+        gpio.mode = GPIO_MODE_AF_OUTPUT_PP;
+        Gpio_InitPins(&gpio);
+        gpio.pins = misoPin;
+        gpio.mode = GPIO_MODE_INPUT_FLOATING;
+        Gpio_InitPins(&gpio);
+    }
+    else
+    {
+        gpio.pins = sckPin | mosiPin;
+        gpio.mode = GPIO_MODE_INPUT_FLOATING;
+        Gpio_InitPins(&gpio);
+        gpio.pins = misoPin;
+        gpio.mode = GPIO_MODE_AF_OUTPUT_PP;
+        Gpio_InitPins(&gpio);
+    }
+    Std_ReturnType error;
+    Transport_spi.txLength = 0;
+    Transport_spi.rx = NULL;
+    Transport_spi.busy = 0;
+    Transport_spi.streamInTransfer = 0;
+    Transport_spi.streamHead = 0;
+    Transport_spi.streamLevel = 0;
+    Spi_SetDoneCb(Transport_SpiDone, TRANSPORT_SPI_MODULE);
+    NVIC_controlInterrupt((SPI1 == TRANSPORT_SPI_MODULE) ? NVIC_IRQNUM_SPI1 : NVIC_IRQNUM_SPI2, NVIC_ENABLE);
+    error = Spi_Init(TRANSPORT_SPI_ROLE, TRANSPORT_SPI_MODE, TRANSPORT_SPI_BAUD_DIV, TRANSPORT_SPI_MODULE);
+    /* A slave listens for the stream right away */
+    Transport_SpiKick();
+    return error;
+}
+
+/**
+ * @brief Copies a frame to be sent through the SPI
+ * 
+ * @param data the frame
+ * @param length the length of the frame
+ * @return Std_ReturnType 
+ */
+static Std_ReturnType Transport_SpiSend(const uint8_t* data, uint16_t length)
+{
+    Std_ReturnType error = E_NOT_OK;
+    uint16_t i;
+    if(length > 0 && length <= TRANSPORT_SPI_MAX_FRAME && 0 == Transport_spi.txLength)
+    {
+        for(i=0; i<length; i++)
+        {
+            Transport_spi.tx[i] = data[i];
+        }
+        Transport_spi.txLength = length;
+        Transport_SpiKick();
+        error = E_OK;
+    }
+    return error;
+}
+
+/**
+ * @brief Arms a receive on the SPI, a master receives while it sends
+ * 
+ * @param data the buffer
+ * @param length the length of the frame
+ * @param interByteTimeout not supported
+ * @return Std_ReturnType 
+ */
+static Std_ReturnType Transport_SpiReceive(uint8_t* data, uint16_t length, uint16_t interByteTimeout)
+{
+    Std_ReturnType error = E_NOT_OK;
+    (void)interByteTimeout;
+    if(data && length > 0 && NULL == Transport_spi.rx)
+    {
+        Transport_spi.rxLength = length;
+        Transport_spi.rx = data;
+        Transport_SpiKick();
+        error = E_OK;
+    }
+    return error;
+}
+
+/**
+ * @brief Reads the bytes of the transfers no receive was armed for, a master only
+ * receives while it sends so the peer's bytes come in with its own frames and acks
+ * 
+ * @param data the buffer
+ * @param maxLength the size of the buffer
+ * @param count the number of bytes read
+ * @return Std_ReturnType 
+ */
+static Std_ReturnType Transport_SpiRead(uint8_t* data, uint16_t maxLength, uint16_t* count)
+{
+    volatile transportSpi_t* spi = &Transport_spi;
+    uint16_t pos = 0;
+    NVIC_controlAllPeripheral(NVIC_DISABLE);
+    while(pos < maxLength && spi->streamLevel > 0)
+    {
+        data[pos] = spi->stream[spi->streamHead];
+        spi->streamHead = (spi->streamHead + 1) % TRANSPORT_SPI_STREAM_SIZE;
+        spi->streamLevel--;
+        pos++;
+    }
+    NVIC_controlAllPeripheral(NVIC_ENABLE);
+    *count = pos;
+    return E_OK;
+}
+
+/**
+ * @brief Gets the capabilities of the SPI backend
+ * 
+ * @param caps where to copy the capabilities
+ * @return Std_ReturnType 
+ */
+static Std_ReturnType Transport_SpiGetCaps(transportCaps_t* caps)
+{
+    uint32_t busClk;
+    if(SPI1 == TRANSPORT_SPI_MODULE)
+    {
+        busClk = RCC_getBusClock(RCC_APB2_PRESCALER, TRANSPORT_SYSTEM_CLK);
+    }
+    else
+    {
+        busClk = RCC_getBusClock(RCC_APB1_PRESCALER, TRANSPORT_SYSTEM_CLK);
+    }
+    caps->flags = TRANSPORT_CAP_HARDWARE | TRANSPORT_CAP_STREAM;
+    caps->flags |= (SPI_MASTER == TRANSPORT_SPI_ROLE) ? TRANSPORT_CAP_TX_ANYTIME : TRANSPORT_CAP_RX_ANYTIME;
+    caps->maxFrame = TRANSPORT_SPI_MAX_FRAME;
+    caps->bitRate = busClk >> ((TRANSPORT_SPI_BAUD_DIV >> 3) + 1);
+    return E_OK;
+}
+
+/**
+ * @brief Moves looped back bytes into the armed receive, completing it if it is full
+ * 
+ */
+static void Transport_LoopbackDeliver(void)
+{
+    volatile transportLoopback_t* loop = &Transport_loopback;
+    uint16_t length;
+    while(loop->rx && loop->level > 0)
+    {
+        loop->rx[loop->rxPos] = loop->data[loop->head];
+        loop->head = (loop->head + 1) % TRANSPORT_LOOPBACK_SIZE;
+        loop->level--;
+        loop->rxPos++;
+        if(loop->rxPos == loop->rxLength)
+        {
+            /* Cleared first as the callback may arm the next receive */
+            length = loop->rxLength;
+            loop->rx = NULL;
+            Transport_RxDone(length, TRANSPORT_RX_COMPLETE);
+        }
+    }
+}
+
+/**
+ * @brief Initializes the loopback backend
+ * 
+ * @return Std_ReturnType 
+ */
+static Std_ReturnType Transport_LoopbackInit(void)
+{
+    Transport_loopback.head = 0;
+    Transport_loopback.level = 0;
+    Transport_loopback.rx = NULL;
+    return E_OK;
+}
+
+/**
+ * @brief Loops a frame back to the receive side
+ * 
+ * @param data the frame
+ * @param length the length of the frame
+ * @return Std_ReturnType 
+ */
+static Std_ReturnType Transport_LoopbackSend(const uint8_t* data, uint16_t length)
+{
+    Std_ReturnType error = E_NOT_OK;
+    volatile transportLoopback_t* loop = &Transport_loopback;
+    uint16_t i;
+    if(length > 0 && length <= TRANSPORT_LOOPBACK_SIZE - loop->level)
+    {
+        for(i=0; i<length; i++)
+        {
+            loop->data[(loop->head + loop->level) % TRANSPORT_LOOPBACK_SIZE] = data[i];
+            loop->level++;
+        }
+        Transport_TxDone(length);
+        Transport_LoopbackDeliver();
+        error = E_OK;
+    }
+    return error;
+}
+
+/**
+ * @brief Arms a receive on the loopback
+ * 
+ * @param data the buffer
+ * @param length the length of the frame
+ * @param interByteTimeout not needed, a frame is always looped back whole
+ * @return Std_ReturnType 
+ */
+static Std_ReturnType Transport_LoopbackReceive(uint8_t* data, uint16_t length, uint16_t interByteTimeout)
+{
+    Std_ReturnType error = E_NOT_OK;
+    (void)interByteTimeout;
+    if(data && length > 0 && NULL == Transport_loopback.rx)
+    {
+        Transport_loopback.rxLength = length;
+        Transport_loopback.rxPos = 0;
+        Transport_loopback.rx = data;
+        Transport_LoopbackDeliver();
+        error = E_OK;
+    }
+    return error;
+}
+
+/**
+ * @brief Reads the looped back bytes while no receive is armed
+ * 
+ * @param data the buffer
+ * @param maxLength the size of the buffer
+ * @param count the number of bytes read
+ * @return Std_ReturnType 
+ */
+static Std_ReturnType Transport_LoopbackRead(uint8_t* data, uint16_t maxLength, uint16_t* count)
+{
+    volatile transportLoopback_t* loop = &Transport_loopback;
+    uint16_t pos = 0;
+    while(pos < maxLength && loop->level > 0 && NULL == loop->rx)
+    {
+        data[pos] = loop->data[loop->head];
+        loop->head = (loop->head + 1) % TRANSPORT_LOOPBACK_SIZE;
+        loop->level--;
+        pos++;
+    }
+    *count = pos;
+    return E_OK;
+}
+
+/**
+ * @brief Gets the capabilities of the loopback backend
+ * 
+ * @param caps where to copy the capabilities
+ * @return Std_ReturnType 
+ */
+static Std_ReturnType Transport_LoopbackGetCaps(transportCaps_t* caps)
+{
+    caps->flags = TRANSPORT_CAP_TX_ANYTIME | TRANSPORT_CAP_RX_ANYTIME | TRANSPORT_CAP_STREAM;
+    caps->maxFrame = TRANSPORT_LOOPBACK_SIZE;
+    caps->bitRate = 0;
+    return E_OK;
+}
+
+/**
+ * @brief Initializes the backend selected by TRANSPORT_BACKEND
+ * 
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+Std_ReturnType Transport_Init(void)
+{
+    return Transport_SetBackend(TRANSPORT_BACKEND);
+}
+/**
+ * @brief Switches to another backend and initializes it
+ * 
+ * @param backend the backend
+ *                  TRANSPORT_HUART
+ *                  TRANSPORT_SPI
+ *                  TRANSPORT_LOOPBACK
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the backend is unknown or can't be initialized
+ */
+Std_ReturnType Transport_SetBackend(uint8_t backend)
+{
+    Std_ReturnType error = E_NOT_OK;
+    if(backend < TRANSPORT_NUMBER_OF_BACKENDS)
+    {
+        Transport_current = &Transport_backends[backend];
+        error = Transport_current->init();
+    }
+    return error;
+}
+/**
+ * @brief Sends a frame, the data is copied so the buffer can be reused
+ * as soon as the function returns
+ * 
+ * @param data the frame
+ * @param length the length of the frame in bytes
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the frame is accepted
+ *                  E_NOT_OK: If the frame is too long or the backend is busy
+ */
+Std_ReturnType Transport_Send(const uint8_t* data, uint16_t length)
+{
+    Std_ReturnType error = E_NOT_OK;
+    if(Transport_current && data)
+    {
+        error = Transport_current->send(data, length);
+    }
+    return error;
+}
+/**
+ * @brief Receives a frame, the receive callback is called when it is received
+ * or when the inter-byte timeout expires
+ * 
+ * @param data the buffer to receive in
+ * @param length the length of the frame in bytes
+ * @param interByteTimeout the time allowed between two bytes in milli seconds or 0 for no limit,
+ * it is ignored by backends without TRANSPORT_CAP_RX_TIMEOUT
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the backend is ready to receive
+ *                  E_NOT_OK: If the backend can't receive right now
+ */
+Std_ReturnType Transport_Receive(uint8_t* data, uint16_t length, uint16_t interByteTimeout)
+{
+    Std_ReturnType error = E_NOT_OK;
+    if(Transport_current)
+    {
+        error = Transport_current->receive(data, length, interByteTimeout);
+    }
+    return error;
+}
+/**
+ * @brief Reads the bytes received while no receive was armed, it does not wait
+ * for more, only backends with TRANSPORT_CAP_STREAM support it
+ * 
+ * @param data the buffer to read into
+ * @param maxLength the size of the buffer in bytes
+ * @param count the number of bytes read
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the backend has no byte stream
+ */
+Std_ReturnType Transport_Read(uint8_t* data, uint16_t maxLength, uint16_t* count)
+{
+    Std_ReturnType error = E_NOT_OK;
+    if(Transport_current && data && count)
+    {
+        error = Transport_current->read(data, maxLength, count);
+    }
+    return error;
+}
+/**
+ * @brief Sets the callback function that will be called when a frame is sent
+ * 
+ * @param func the callback function
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+Std_ReturnType Transport_SetTxCb(transportTxCb_t func)
+{
+    Transport_txCb = func;
+    return E_OK;
+}
+/**
+ * @brief Sets the callback function that will be called when a receive ends
+ * 
+ * @param func the callback function, it receives the number of bytes received and the status
+ *                  TRANSPORT_RX_COMPLETE
+ *                  TRANSPORT_RX_TIMEOUT
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+Std_ReturnType Transport_SetRxCb(transportRxCb_t func)
+{
+    Transport_rxCb = func;
+    return E_OK;
+}
+/**
+ * @brief Gets the capabilities of the current backend
+ * 
+ * @param caps where to copy the capabilities
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+Std_ReturnType Transport_GetCaps(transportCaps_t* caps)
+{
+    Std_ReturnType error = E_NOT_OK;
+    if(Transport_current && caps)
+    {
+        error = Transport_current->getCaps(caps);
+    }
+    return error;
+}
@@ -9,6 +9,7 @@
  *
  */
 #include "Std_Types.h"
+#include "Uart_Cfg.h"
 #include "Uart.h"
 
 #define UART_NUMBER_OF_MODULES        5
@@ -30,6 +31,10 @@ typedef struct
   uint32_t pos;
   uint32_t size;
   uint8_t state;
+  const uartSegment_t *seg;
+  uint8_t nSeg;
+  uint8_t segIdx;
+  uint32_t total;
 } dataBuffer_t;
 
 #define UART_INT_NUMBER 37
@@ -37,6 +42,14 @@ typedef struct
 #define UART_BUFFER_IDLE 0
 #define UART_BUFFER_BUSY 1
 
+typedef struct 
+{
+  uint8_t data[UART_RX_RING_SIZE];
+  uint16_t head;
+  uint16_t tail;
+  uint8_t stopped;
+} ringBuffer_t;
+
 /*Transmit data register
               empty*/
 #define UART_TXE_CLR 0xFFFFFF7F
@@ -53,10 +66,27 @@ typedef struct
 #define UART_STOP_CLR 0xFFFFCFFF
 /*TXE interrupt enable*/
 #define UART_TXEIE_CLR 0xFFFFFF7F
+/*Transmission complete interrupt
+              enable*/
+#define UART_TCIE_CLR 0xFFFFFFBF
+/*Transmission complete*/
+#define UART_TC_CLR 0xFFFFFFBF
 /*Parity selection*/
 #define UART_PS_CLR 0xFFFFFDFF
 /*Word length*/
 #define	UART_M_CLR				0xFFFFEFFF
+/*RXNE interrupt enable*/
+#define UART_RXNEIE_CLR 0xFFFFFFDF
+/*Wakeup method*/
+#define UART_WAKE_CLR 0xFFFFF7FF
+/*Receiver wakeup*/
+#define UART_RWU_CLR 0xFFFFFFFD
+/*Address of the USART node*/
+#define UART_ADD_CLR 0xFFFFFFF0
+/*Clock enable, polarity, phase and last bit clock pulse*/
+#define UART_CLOCK_CLR 0xFFFFF0FF
+/*Transmitter enable*/
+#define UART_TE_CLR 0xFFFFFFF7
 
 /*Transmit data register
               empty*/
@@ -68,6 +98,14 @@ typedef struct
 #define UART_RXNE_GET 0x00000020
 /*Parity error*/
 #define UART_PE_GET 0x00000001
+/*Framing error*/
+#define UART_FE_GET 0x00000002
+/*Noise error flag*/
+#define UART_NE_GET 0x00000004
+/*Overrun error*/
+#define UART_ORE_GET 0x00000008
+/*Errors that make the received byte unusable*/
+#define UART_BAD_BYTE_GET (UART_PE_GET | UART_FE_GET | UART_NE_GET)
 
 /*USART enable*/
 #define UART_UE_SET 0x00002000
@@ -91,12 +129,36 @@ typedef struct
 #define UART_RE_SET 0x00000004
 /*Word length*/
 #define	UART_M_SET 0x00001000
+/*Wakeup on address mark*/
+#define UART_WAKE_SET 0x00000800
+/*Receiver in mute mode*/
+#define UART_RWU_SET 0x00000002
+
+#if UART_ISR_PROFILING
+/*Debug exception and monitor control, trace enable*/
+#define UART_DEMCR (*(volatile uint32_t*)0xE000EDFC)
+#define UART_DEMCR_TRCENA_SET 0x01000000
+/*DWT control and cycle counter*/
+#define UART_DWT_CTRL (*(volatile uint32_t*)0xE0001000)
+#define UART_DWT_CYCCNTENA_SET 0x00000001
+#define UART_DWT_CYCCNT (*(volatile uint32_t*)0xE0001004)
+#endif
+
+/*The 9th bit marking an address byte*/
+#define UART_ADDRESS_MARK 0x00000100
+#define UART_MAX_ADDRESS 0x0F
 
 /*RTS enable*/
 #define UART_RTSE_CLR 0xFFFFFEFF
+/*CTS enable*/
+#define UART_CTSE_CLR 0xFFFFFDFF
 
 #define UART_NO_PRESCALER 0x1
 
+/*The UART oversamples by 16 and BRR holds USARTDIV * 16*/
+#define UART_OVERSAMPLING 16
+#define UART_BRR_MAX 0xFFFF
+
 const uint32_t Uart_Address[UART_NUMBER_OF_MODULES] = {
   0x40013800,
   0x40004400,
@@ -107,9 +169,178 @@ const uint32_t Uart_Address[UART_NUMBER_OF_MODULES] = {
 
 static volatile dataBuffer_t txBuffer[UART_NUMBER_OF_MODULES];
 static volatile dataBuffer_t rxBuffer[UART_NUMBER_OF_MODULES];
+static volatile ringBuffer_t rxRing[UART_NUMBER_OF_MODULES];
+static volatile uartStats_t Uart_stats[UART_NUMBER_OF_MODULES];
+static volatile uint8_t Uart_multiDrop[UART_NUMBER_OF_MODULES];
+
+static uint32_t Uart_actualBaud[UART_NUMBER_OF_MODULES];
+static sint32_t Uart_baudErrorPpm[UART_NUMBER_OF_MODULES];
 
 static volatile txCb_t appTxNotify[UART_NUMBER_OF_MODULES];
 static volatile rxCb_t appRxNotify[UART_NUMBER_OF_MODULES];
+static volatile doneCb_t appTxDone[UART_NUMBER_OF_MODULES];
+static volatile doneCb_t appRxDone[UART_NUMBER_OF_MODULES];
+static volatile flowCb_t appRxFlow[UART_NUMBER_OF_MODULES];
+static volatile flowCb_t appDriverEnable[UART_NUMBER_OF_MODULES];
+/**
+ * @brief Moves the transmit buffer to the next non empty segment of a
+ * scatter-gather send, if any
+ * 
+ * @param uartModule the module number of the UART
+ *                 UART1
+ *                 UART2
+ *                 UART3
+ *                 UART4
+ *                 UART5
+ */
+static void Uart_NextSegment(uint8_t uartModule)
+{
+  const uartSegment_t* seg = txBuffer[uartModule].seg;
+  uint8_t idx = txBuffer[uartModule].segIdx;
+  if (seg) 
+  {
+    while (++idx < txBuffer[uartModule].nSeg && 0 == seg[idx].length);
+    if (idx < txBuffer[uartModule].nSeg) 
+    {
+      txBuffer[uartModule].ptr = seg[idx].data;
+      txBuffer[uartModule].pos = 0;
+      txBuffer[uartModule].size = seg[idx].length;
+      txBuffer[uartModule].total += seg[idx].length;
+      txBuffer[uartModule].segIdx = idx;
+    }
+  }
+}
+/**
+ * @brief Gets the number of bytes waiting in the receive ring buffer
+ * 
+ * @param uartModule the module number of the UART
+ * @return uint16_t the number of bytes
+ */
+static uint16_t Uart_RingLevel(uint8_t uartModule)
+{
+  return (uint16_t)((rxRing[uartModule].head + UART_RX_RING_SIZE - rxRing[uartModule].tail) % UART_RX_RING_SIZE);
+}
+/**
+ * @brief Stores a received byte that no receive request was waiting for and
+ * asks the sender to stop when the high watermark is reached
+ * 
+ * @param uartModule the module number of the UART
+ * @param byte the received byte
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the byte is stored
+ *                  E_NOT_OK: If the ring buffer is full
+ */
+static Std_ReturnType Uart_RingPut(uint8_t uartModule, uint8_t byte)
+{
+  Std_ReturnType error = E_NOT_OK;
+  uint16_t next = (rxRing[uartModule].head + 1) % UART_RX_RING_SIZE;
+  if (next != rxRing[uartModule].tail) 
+  {
+    rxRing[uartModule].data[rxRing[uartModule].head] = byte;
+    rxRing[uartModule].head = next;
+    error = E_OK;
+  }
+  else 
+  {
+    Uart_stats[uartModule].rxDropped++;
+  }
+  if (!rxRing[uartModule].stopped && Uart_RingLevel(uartModule) >= UART_RX_HIGH_WATERMARK) 
+  {
+    rxRing[uartModule].stopped = 1;
+    if (appRxFlow[uartModule]) 
+    {
+      appRxFlow[uartModule](uartModule, UART_FLOW_STOP);
+    }
+  }
+  return error;
+}
+/**
+ * @brief Takes the oldest byte out of the receive ring buffer and lets the
+ * sender continue when the low watermark is reached
+ * 
+ * @param uartModule the module number of the UART
+ * @param byte where to store the byte
+ * @return Std_ReturnType A Status
+ *                  E_OK: If a byte is returned
+ *                  E_NOT_OK: If the ring buffer is empty
+ */
+static Std_ReturnType Uart_RingGet(uint8_t uartModule, uint8_t *byte)
+{
+  Std_ReturnType error = E_NOT_OK;
+  if (rxRing[uartModule].head != rxRing[uartModule].tail) 
+  {
+    *byte = rxRing[uartModule].data[rxRing[uartModule].tail];
+    rxRing[uartModule].tail = (rxRing[uartModule].tail + 1) % UART_RX_RING_SIZE;
+    error = E_OK;
+  }
+  if (rxRing[uartModule].stopped && Uart_RingLevel(uartModule) <= UART_RX_LOW_WATERMARK) 
+  {
+    rxRing[uartModule].stopped = 0;
+    if (appRxFlow[uartModule]) 
+    {
+      appRxFlow[uartModule](uartModule, UART_FLOW_GO);
+    }
+  }
+  return error;
+}
+/**
+ * @brief Ends the current receive request and notifies the user
+ * 
+ * @param uartModule the module number of the UART
+ */
+static void Uart_RxComplete(uint8_t uartModule)
+{
+  uint16_t length = rxBuffer[uartModule].size;
+  rxBuffer[uartModule].ptr = NULL;
+  rxBuffer[uartModule].size = 0;
+  rxBuffer[uartModule].pos = 0;
+  rxBuffer[uartModule].state = UART_BUFFER_IDLE;
+  if (appRxNotify[uartModule]) 
+  {
+    appRxNotify[uartModule]();
+  }
+  if (appRxDone[uartModule]) 
+  {
+    appRxDone[uartModule](uartModule, length);
+  }
+}
+/**
+ * @brief Asserts the driver enable line of a half-duplex module before
+ * a transmission starts
+ * 
+ * @param uartModule the module number of the UART
+ */
+static void Uart_TxStart(uint8_t uartModule)
+{
+  if (appDriverEnable[uartModule]) 
+  {
+    appDriverEnable[uartModule](uartModule, UART_DE_ASSERT);
+  }
+}
+/**
+ * @brief Ends the current transmission and notifies the user
+ * 
+ * @param uartModule the module number of the UART
+ */
+static void Uart_TxComplete(uint8_t uartModule)
+{
+  uint16_t length = txBuffer[uartModule].total;
+  txBuffer[uartModule].ptr = NULL;
+  txBuffer[uartModule].size = 0;
+  txBuffer[uartModule].pos = 0;
+  txBuffer[uartModule].seg = NULL;
+  txBuffer[uartModule].nSeg = 0;
+  txBuffer[uartModule].total = 0;
+  txBuffer[uartModule].state = UART_BUFFER_IDLE;
+  if (appTxNotify[uartModule]) 
+  {
+    appTxNotify[uartModule]();
+  }
+  if (length && appTxDone[uartModule]) 
+  {
+    appTxDone[uartModule](uartModule, length);
+  }
+}
 /**
  * @brief The Interrupt Handler for the UART driver
  * 
@@ -123,47 +354,99 @@ static volatile rxCb_t appRxNotify[UART_NUMBER_OF_MODULES];
 static void UART_IRQHandler(uint8_t uartModule)
 {
   volatile uart_t* Uart = (volatile uart_t*)Uart_Address[uartModule];
-  if (UART_TXE_GET & Uart->SR) 
+  uint32_t status;
+  uint32_t word;
+  uint8_t data;
+#if UART_ISR_PROFILING
+  uint32_t start = UART_DWT_CYCCNT;
+#endif
+  if ((UART_TXEIE_SET & Uart->CR1) && (UART_TXE_GET & Uart->SR)) 
   {
+    if (txBuffer[uartModule].size == txBuffer[uartModule].pos) 
+    {
+      Uart_NextSegment(uartModule);
+    }
     if (txBuffer[uartModule].size != txBuffer[uartModule].pos) 
     {
       Uart->DR = txBuffer[uartModule].ptr[txBuffer[uartModule].pos++];
+      Uart_stats[uartModule].txBytes++;
+    } 
+    else if (appDriverEnable[uartModule] && txBuffer[uartModule].total) 
+    {
+      /* The last byte is still shifting out, the line is released on TC */
+      Uart->CR1 &= UART_TXEIE_CLR;
+      Uart->CR1 |= UART_TCIE_SET;
+      appDriverEnable[uartModule](uartModule, UART_DE_DRAIN);
     } 
     else 
     {
-      txBuffer[uartModule].ptr = NULL;
-      txBuffer[uartModule].size = 0;
-      txBuffer[uartModule].pos = 0;
-      txBuffer[uartModule].state = UART_BUFFER_IDLE;
-      if (appTxNotify[uartModule]) 
-      {
-        appTxNotify[uartModule]();
-      }
+      Uart_TxComplete(uartModule);
       Uart->CR1 &= UART_TXEIE_CLR;
     }
   }
 
-  if (UART_RXNE_GET & Uart->SR) 
+  if ((UART_TCIE_SET & Uart->CR1) && (UART_TC_GET & Uart->SR)) 
   {
-    Uart->SR &= UART_RXNE_CLR;
-    if (UART_BUFFER_BUSY == rxBuffer[uartModule].state) 
+    Uart->CR1 &= UART_TCIE_CLR;
+    Uart->SR &= UART_TC_CLR;
+    if (appDriverEnable[uartModule]) 
+    {
+      appDriverEnable[uartModule](uartModule, UART_DE_RELEASE);
+    }
+    Uart_TxComplete(uartModule);
+  }
+
+  status = Uart->SR;
+  if (UART_RXNE_GET & status) 
+  {
+    /* Reading DR after SR clears RXNE together with ORE, NE, FE and PE */
+    word = Uart->DR;
+    data = (uint8_t)word;
+    if (UART_ORE_GET & status) 
+    {
+      /* DR still holds a good byte, the ones after it were lost */
+      Uart_stats[uartModule].overruns++;
+    }
+    if (UART_BAD_BYTE_GET & status) 
     {
-      rxBuffer[uartModule].ptr[rxBuffer[uartModule].pos] = Uart->DR;
+      if (UART_PE_GET & status) 
+      {
+        Uart_stats[uartModule].parityErrors++;
+      }
+      if (UART_FE_GET & status) 
+      {
+        Uart_stats[uartModule].framingErrors++;
+      }
+      if (UART_NE_GET & status) 
+      {
+        Uart_stats[uartModule].noiseErrors++;
+      }
+    }
+    else if (Uart_multiDrop[uartModule] && (UART_ADDRESS_MARK & word)) 
+    {
+      /* Our address woke the receiver up, the data follows */
+    }
+    else if (UART_BUFFER_BUSY == rxBuffer[uartModule].state) 
+    {
+      Uart_stats[uartModule].rxBytes++;
+      rxBuffer[uartModule].ptr[rxBuffer[uartModule].pos] = data;
       rxBuffer[uartModule].pos++;
 
       if (rxBuffer[uartModule].pos == rxBuffer[uartModule].size) 
       {
-        rxBuffer[uartModule].ptr = NULL;
-        rxBuffer[uartModule].size = 0;
-        rxBuffer[uartModule].pos = 0;
-        rxBuffer[uartModule].state = UART_BUFFER_IDLE;
-        if (appRxNotify[uartModule]) 
-        {
-          appRxNotify[uartModule]();
-        }
+        Uart_RxComplete(uartModule);
       }
     }
+    else 
+    {
+      Uart_stats[uartModule].rxBytes++;
+      Uart_RingPut(uartModule, data);
+    }
   }
+#if UART_ISR_PROFILING
+  Uart_stats[uartModule].isrCycles += UART_DWT_CYCCNT - start;
+  Uart_stats[uartModule].isrCalls++;
+#endif
 }
 /**
  * @brief The UART 1 Handler
@@ -220,9 +503,13 @@ void UART5_IRQHandler(void)
  *                 UART_EVEN_PARITY
  *                 UART_NO_PARITY
  * @param flowControl the flow control
+ *                 UART_FLOW_CONTROL_RTS
+ *                 UART_FLOW_CONTROL_CTS
  *                 UART_FLOW_CONTROL_EN
  *                 UART_FLOW_CONTROL_DIS
- * @param sysClk the clock of the system
+ * @param busClk the clock of the bus the module is on
+ *                 PCLK2 for UART1
+ *                 PCLK1 for UART2 to UART5
  * @param uartModule the module number of the UART
  *                 UART1
  *                 UART2
@@ -231,12 +518,34 @@ void UART5_IRQHandler(void)
  *                 UART5
  * @return Std_ReturnType A Status
  *                  E_OK: If the function executed successfully
- *                  E_NOT_OK: If the did not execute successfully
+ *                  E_NOT_OK: If the baud rate can't be reached within UART_BAUD_TOLERANCE_PPM
  */
-extern Std_ReturnType Uart_Init(uint32_t baudRate, uint32_t stopBits, uint32_t parity, uint32_t flowControl, uint32_t sysClk, uint8_t uartModule) 
+extern Std_ReturnType Uart_Init(uint32_t baudRate, uint32_t stopBits, uint32_t parity, uint32_t flowControl, uint32_t busClk, uint8_t uartModule) 
 {
   volatile uart_t* Uart = (volatile uart_t*)Uart_Address[uartModule];
-  Uart->BRR = ((uint32_t)((f64)sysClk / ((f64)baudRate * 16.0))) << 4;
+  uint32_t brr;
+  uint32_t actualBaud;
+  sint32_t errorPpm;
+  if (0 == baudRate) 
+  {
+    return E_NOT_OK;
+  }
+  /* BRR is the mantissa and the 4-bit fraction of USARTDIV, which is
+     busClk / (16 * baudRate), rounded to the nearest step */
+  brr = (busClk + (baudRate >> 1)) / baudRate;
+  if (brr < UART_OVERSAMPLING || brr > UART_BRR_MAX) 
+  {
+    return E_NOT_OK;
+  }
+  actualBaud = (busClk + (brr >> 1)) / brr;
+  errorPpm = (sint32_t)(((sint64_t)actualBaud - (sint64_t)baudRate) * 1000000 / (sint64_t)baudRate);
+  if (errorPpm > UART_BAUD_TOLERANCE_PPM || errorPpm < -UART_BAUD_TOLERANCE_PPM) 
+  {
+    return E_NOT_OK;
+  }
+  Uart_actualBaud[uartModule] = actualBaud;
+  Uart_baudErrorPpm[uartModule] = errorPpm;
+  Uart->BRR = brr;
   if (UART_NO_PARITY == parity) 
   {
     Uart->CR1 &= UART_M_CLR;
@@ -249,13 +558,22 @@ extern Std_ReturnType Uart_Init(uint32_t baudRate, uint32_t stopBits, uint32_t p
     Uart->CR1 &= UART_PS_CLR;
     Uart->CR1 |= parity;
   }
+  Uart->CR1 &= UART_WAKE_CLR & UART_RWU_CLR & UART_TCIE_CLR;
+  Uart_multiDrop[uartModule] = 0;
   Uart->CR2 &= UART_STOP_CLR;
   Uart->CR2 |= stopBits;
-  Uart->CR3 &= UART_RTSE_CLR;
+  Uart->CR3 &= UART_RTSE_CLR & UART_CTSE_CLR;
   Uart->CR3 |= flowControl;
   Uart->GTPR |= UART_NO_PRESCALER;
   rxBuffer[uartModule].state = UART_BUFFER_IDLE;
   txBuffer[uartModule].state = UART_BUFFER_IDLE;
+  rxRing[uartModule].head = 0;
+  rxRing[uartModule].tail = 0;
+  rxRing[uartModule].stopped = 0;
+#if UART_ISR_PROFILING
+  UART_DEMCR |= UART_DEMCR_TRCENA_SET;
+  UART_DWT_CTRL |= UART_DWT_CYCCNTENA_SET;
+#endif
   Uart->CR1 |= UART_UE_SET | UART_TXEIE_SET | UART_RXNEIE_SET | UART_TE_SET | UART_RE_SET;
   return E_OK;
 }
@@ -285,13 +603,106 @@ Std_ReturnType Uart_Send(uint8_t *data, uint16_t length, uint8_t uartModule)
     txBuffer[uartModule].ptr = data;
     txBuffer[uartModule].pos = 0;
     txBuffer[uartModule].size = length;
+    txBuffer[uartModule].seg = NULL;
+    txBuffer[uartModule].nSeg = 0;
+    txBuffer[uartModule].total = length;
 
+    Uart_TxStart(uartModule);
     Uart->DR = txBuffer[uartModule].ptr[txBuffer[uartModule].pos++];
+    Uart_stats[uartModule].txBytes++;
+    Uart->CR1 |= UART_TXEIE_SET;
+    error = E_OK;
+  }
+  return error;
+}
+/**
+ * @brief Sends data to one node of a multi-drop bus, the address byte is sent
+ * with the address mark first so only that node wakes up to receive the data
+ *
+ * @param data The data to send
+ * @param length the length of the data in bytes
+ * @param address the address of the receiving node (0 to 15)
+ * @param uartModule the module number of the UART
+ *                 UART1
+ *                 UART2
+ *                 UART3
+ *                 UART4
+ *                 UART5
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the driver is ready to send
+ *                  E_NOT_OK: If the driver can't send data right now or the module is not in multi-drop mode
+ */
+Std_ReturnType Uart_SendTo(uint8_t *data, uint16_t length, uint8_t address, uint8_t uartModule) 
+{
+  Std_ReturnType error = E_NOT_OK;
+  volatile uart_t* Uart = (volatile uart_t*)Uart_Address[uartModule];
+  if (data && (length > 0) && address <= UART_MAX_ADDRESS && Uart_multiDrop[uartModule] 
+      && txBuffer[uartModule].state == UART_BUFFER_IDLE) 
+  {
+    txBuffer[uartModule].state = UART_BUFFER_BUSY;
+    txBuffer[uartModule].ptr = data;
+    txBuffer[uartModule].pos = 0;
+    txBuffer[uartModule].size = length;
+    txBuffer[uartModule].seg = NULL;
+    txBuffer[uartModule].nSeg = 0;
+    txBuffer[uartModule].total = length;
+
+    Uart_TxStart(uartModule);
+    Uart->DR = UART_ADDRESS_MARK | address;
+    Uart_stats[uartModule].txBytes++;
     Uart->CR1 |= UART_TXEIE_SET;
     error = E_OK;
   }
   return error;
 }
+/**
+ * @brief Sends a list of segments back to back through the UART without
+ * copying them, the segments and the data they point to must stay valid
+ * until the transmission is completed
+ *
+ * @param segments The segments to send
+ * @param nSegments the number of segments
+ * @param uartModule the module number of the UART
+ *                 UART1
+ *                 UART2
+ *                 UART3
+ *                 UART4
+ *                 UART5
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the driver is ready to send
+ *                  E_NOT_OK: If the driver can't send data right now
+ */
+Std_ReturnType Uart_SendSegments(const uartSegment_t *segments, uint8_t nSegments, uint8_t uartModule) 
+{
+  Std_ReturnType error = E_NOT_OK;
+  volatile uart_t* Uart = (volatile uart_t*)Uart_Address[uartModule];
+  uint8_t idx = 0;
+  if (segments && txBuffer[uartModule].state == UART_BUFFER_IDLE) 
+  {
+    while (idx < nSegments && 0 == segments[idx].length)
+    {
+      idx++;
+    }
+    if (idx < nSegments && segments[idx].data) 
+    {
+      txBuffer[uartModule].state = UART_BUFFER_BUSY;
+      txBuffer[uartModule].seg = segments;
+      txBuffer[uartModule].nSeg = nSegments;
+      txBuffer[uartModule].segIdx = idx;
+      txBuffer[uartModule].ptr = segments[idx].data;
+      txBuffer[uartModule].pos = 0;
+      txBuffer[uartModule].size = segments[idx].length;
+      txBuffer[uartModule].total = segments[idx].length;
+
+      Uart_TxStart(uartModule);
+      Uart->DR = txBuffer[uartModule].ptr[txBuffer[uartModule].pos++];
+      Uart_stats[uartModule].txBytes++;
+      Uart->CR1 |= UART_TXEIE_SET;
+      error = E_OK;
+    }
+  }
+  return error;
+}
 /**
  * @brief Receives data through the UART
  *
@@ -310,12 +721,61 @@ Std_ReturnType Uart_Send(uint8_t *data, uint16_t length, uint8_t uartModule)
 Std_ReturnType Uart_Receive(uint8_t *data, uint16_t length, uint8_t uartModule) 
 {
   Std_ReturnType error = E_NOT_OK;
-  if (rxBuffer[uartModule].state == UART_BUFFER_IDLE) 
+  volatile uart_t* Uart = (volatile uart_t*)Uart_Address[uartModule];
+  uint16_t pos = 0;
+  if (data && (length > 0) && rxBuffer[uartModule].state == UART_BUFFER_IDLE) 
   {
+    /* Bytes that arrived before the request are taken first, the receive
+       interrupt is held off so none can slip in between */
+    Uart->CR1 &= UART_RXNEIE_CLR;
+    while (pos < length && E_OK == Uart_RingGet(uartModule, &data[pos])) 
+    {
+      pos++;
+    }
     rxBuffer[uartModule].ptr = data;
     rxBuffer[uartModule].size = length;
-    rxBuffer[uartModule].pos = 0;
+    rxBuffer[uartModule].pos = pos;
     rxBuffer[uartModule].state = UART_BUFFER_BUSY;
+    if (pos == length) 
+    {
+      Uart_RxComplete(uartModule);
+    }
+    Uart->CR1 |= UART_RXNEIE_SET;
+    error = E_OK;
+  }
+  return error;
+}
+/**
+ * @brief Reads the bytes that arrived while no receive request was waiting,
+ * it does not wait for more so it suits byte stream decoders
+ *
+ * @param data The buffer to read into
+ * @param maxLength the size of the buffer in bytes
+ * @param count the number of bytes read
+ * @param uartModule the module number of the UART
+ *                 UART1
+ *                 UART2
+ *                 UART3
+ *                 UART4
+ *                 UART5
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+Std_ReturnType Uart_Read(uint8_t *data, uint16_t maxLength, uint16_t *count, uint8_t uartModule) 
+{
+  Std_ReturnType error = E_NOT_OK;
+  volatile uart_t* Uart = (volatile uart_t*)Uart_Address[uartModule];
+  uint16_t pos = 0;
+  if (data && count) 
+  {
+    Uart->CR1 &= UART_RXNEIE_CLR;
+    while (pos < maxLength && E_OK == Uart_RingGet(uartModule, &data[pos])) 
+    {
+      pos++;
+    }
+    Uart->CR1 |= UART_RXNEIE_SET;
+    *count = pos;
     error = E_OK;
   }
   return error;
@@ -360,3 +820,324 @@ Std_ReturnType Uart_SetRxCb(rxCb_t func, uint8_t uartModule)
   appRxNotify[uartModule] = func;
   return E_OK;
 }
+/**
+ * @brief Sets the callback function that will be called with the module number
+ * and the number of bytes sent when a transmission is completed
+ *
+ * @param func the callback function
+ * @param uartModule the module number of the UART
+ *                 UART1
+ *                 UART2
+ *                 UART3
+ *                 UART4
+ *                 UART5
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+Std_ReturnType Uart_SetTxDoneCb(doneCb_t func, uint8_t uartModule) 
+{
+  appTxDone[uartModule] = func;
+  return E_OK;
+}
+/**
+ * @brief Sets the callback function that will be called with the module number
+ * and the number of bytes received when a receive is completed
+ *
+ * @param func the callback function
+ * @param uartModule the module number of the UART
+ *                 UART1
+ *                 UART2
+ *                 UART3
+ *                 UART4
+ *                 UART5
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+Std_ReturnType Uart_SetRxDoneCb(doneCb_t func, uint8_t uartModule) 
+{
+  appRxDone[uartModule] = func;
+  return E_OK;
+}
+/**
+ * @brief Gets the baud rate achieved by the last successful initialization
+ *
+ * @param actualBaud the achieved baud rate
+ * @param errorPpm the difference from the requested baud rate in ppm
+ * @param uartModule the module number of the UART
+ *                 UART1
+ *                 UART2
+ *                 UART3
+ *                 UART4
+ *                 UART5
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+Std_ReturnType Uart_GetBaudRate(uint32_t *actualBaud, sint32_t *errorPpm, uint8_t uartModule) 
+{
+  Std_ReturnType error = E_NOT_OK;
+  if (actualBaud && errorPpm && Uart_actualBaud[uartModule]) 
+  {
+    *actualBaud = Uart_actualBaud[uartModule];
+    *errorPpm = Uart_baudErrorPpm[uartModule];
+    error = E_OK;
+  }
+  return error;
+}
+/**
+ * @brief Sets the callback function that will be called when the receive ring
+ * buffer crosses its watermarks, it can be used to drive the RTS line
+ *
+ * @param func the callback function
+ *                 UART_FLOW_STOP: The ring buffer reached UART_RX_HIGH_WATERMARK
+ *                 UART_FLOW_GO: The ring buffer drained to UART_RX_LOW_WATERMARK
+ * @param uartModule the module number of the UART
+ *                 UART1
+ *                 UART2
+ *                 UART3
+ *                 UART4
+ *                 UART5
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+Std_ReturnType Uart_SetRxFlowCb(flowCb_t func, uint8_t uartModule) 
+{
+  appRxFlow[uartModule] = func;
+  return E_OK;
+}
+/**
+ * @brief Gets the byte and error counters of a module
+ *
+ * @param stats where to copy the counters
+ * @param uartModule the module number of the UART
+ *                 UART1
+ *                 UART2
+ *                 UART3
+ *                 UART4
+ *                 UART5
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+Std_ReturnType Uart_GetStats(uartStats_t *stats, uint8_t uartModule) 
+{
+  Std_ReturnType error = E_NOT_OK;
+  if (stats) 
+  {
+    stats->txBytes = Uart_stats[uartModule].txBytes;
+    stats->rxBytes = Uart_stats[uartModule].rxBytes;
+    stats->overruns = Uart_stats[uartModule].overruns;
+    stats->framingErrors = Uart_stats[uartModule].framingErrors;
+    stats->noiseErrors = Uart_stats[uartModule].noiseErrors;
+    stats->parityErrors = Uart_stats[uartModule].parityErrors;
+    stats->rxDropped = Uart_stats[uartModule].rxDropped;
+    stats->isrCalls = Uart_stats[uartModule].isrCalls;
+    stats->isrCycles = Uart_stats[uartModule].isrCycles;
+    error = E_OK;
+  }
+  return error;
+}
+/**
+ * @brief Clears the byte and error counters of a module
+ *
+ * @param uartModule the module number of the UART
+ *                 UART1
+ *                 UART2
+ *                 UART3
+ *                 UART4
+ *                 UART5
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+Std_ReturnType Uart_ResetStats(uint8_t uartModule) 
+{
+  Uart_stats[uartModule].txBytes = 0;
+  Uart_stats[uartModule].rxBytes = 0;
+  Uart_stats[uartModule].overruns = 0;
+  Uart_stats[uartModule].framingErrors = 0;
+  Uart_stats[uartModule].noiseErrors = 0;
+  Uart_stats[uartModule].parityErrors = 0;
+  Uart_stats[uartModule].rxDropped = 0;
+  Uart_stats[uartModule].isrCalls = 0;
+  Uart_stats[uartModule].isrCycles = 0;
+  return E_OK;
+}
+/**
+ * @brief Puts the module in multi-drop mode with the given node address, the
+ * receiver stays muted until a byte with the address mark and this address
+ * arrives, the module must be initialized without parity
+ *
+ * @param address the address of this node (0 to 15)
+ * @param uartModule the module number of the UART
+ *                 UART1
+ *                 UART2
+ *                 UART3
+ *                 UART4
+ *                 UART5
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the address is invalid or parity is enabled
+ */
+Std_ReturnType Uart_SetAddress(uint8_t address, uint8_t uartModule) 
+{
+  Std_ReturnType error = E_NOT_OK;
+  volatile uart_t* Uart = (volatile uart_t*)Uart_Address[uartModule];
+  if (address <= UART_MAX_ADDRESS && !(Uart->CR1 & UART_PCE_SET)) 
+  {
+    Uart->CR2 &= UART_ADD_CLR;
+    Uart->CR2 |= address;
+    /* 9-bit words, the 9th bit is the address mark */
+    Uart->CR1 |= UART_M_SET | UART_WAKE_SET;
+    Uart_multiDrop[uartModule] = 1;
+    Uart->CR1 |= UART_RWU_SET;
+    error = E_OK;
+  }
+  return error;
+}
+/**
+ * @brief Mutes the receiver of a multi-drop module until its address is
+ * received again
+ *
+ * @param uartModule the module number of the UART
+ *                 UART1
+ *                 UART2
+ *                 UART3
+ *                 UART4
+ *                 UART5
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the module is not in multi-drop mode
+ */
+Std_ReturnType Uart_Mute(uint8_t uartModule) 
+{
+  Std_ReturnType error = E_NOT_OK;
+  volatile uart_t* Uart = (volatile uart_t*)Uart_Address[uartModule];
+  if (Uart_multiDrop[uartModule]) 
+  {
+    Uart->CR1 |= UART_RWU_SET;
+    error = E_OK;
+  }
+  return error;
+}
+/**
+ * @brief Gets the number of bytes received so far for the current receive request
+ *
+ * @param count the number of bytes received
+ * @param uartModule the module number of the UART
+ *                 UART1
+ *                 UART2
+ *                 UART3
+ *                 UART4
+ *                 UART5
+ * @return Std_ReturnType A Status
+ *                  E_OK: If a receive request is running
+ *                  E_NOT_OK: If there is no receive request
+ */
+Std_ReturnType Uart_GetRxCount(uint16_t *count, uint8_t uartModule) 
+{
+  Std_ReturnType error = E_NOT_OK;
+  if (count && rxBuffer[uartModule].state == UART_BUFFER_BUSY) 
+  {
+    *count = rxBuffer[uartModule].pos;
+    error = E_OK;
+  }
+  return error;
+}
+/**
+ * @brief Ends the current receive request without notifying the user,
+ * the bytes already received stay in the buffer of the request
+ * *Bytes that arrive after the abort are kept in the receive ring
+ *
+ * @param count the number of bytes received before the abort
+ * @param uartModule the module number of the UART
+ *                 UART1
+ *                 UART2
+ *                 UART3
+ *                 UART4
+ *                 UART5
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the request is aborted
+ *                  E_NOT_OK: If there is no receive request, it may have just completed
+ */
+Std_ReturnType Uart_AbortReceive(uint16_t *count, uint8_t uartModule) 
+{
+  Std_ReturnType error = E_NOT_OK;
+  volatile uart_t* Uart = (volatile uart_t*)Uart_Address[uartModule];
+  Uart->CR1 &= UART_RXNEIE_CLR;
+  if (rxBuffer[uartModule].state == UART_BUFFER_BUSY) 
+  {
+    if (count) 
+    {
+      *count = rxBuffer[uartModule].pos;
+    }
+    rxBuffer[uartModule].ptr = NULL;
+    rxBuffer[uartModule].size = 0;
+    rxBuffer[uartModule].pos = 0;
+    rxBuffer[uartModule].state = UART_BUFFER_IDLE;
+    error = E_OK;
+  }
+  Uart->CR1 |= UART_RXNEIE_SET;
+  return error;
+}
+/**
+ * @brief Sets the callback function that drives the driver enable line of a
+ * half-duplex (RS-485) transceiver, setting it puts the module in half-duplex mode
+ * *In half-duplex mode the transmission is only done once the last stop bit has
+ * left the line (TC) so the next one can't start before the line is released
+ *
+ * @param func the callback function or NULL for full-duplex
+ *                 UART_DE_ASSERT: Before the first byte is written
+ *                 UART_DE_DRAIN: The last byte is in the shift register
+ *                 UART_DE_RELEASE: The transmission is complete
+ * @param uartModule the module number of the UART
+ *                 UART1
+ *                 UART2
+ *                 UART3
+ *                 UART4
+ *                 UART5
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+Std_ReturnType Uart_SetDriverEnableCb(flowCb_t func, uint8_t uartModule) 
+{
+  appDriverEnable[uartModule] = func;
+  return E_OK;
+}
+/**
+ * @brief Sets the synchronous clock mode of a module, in synchronous mode the
+ * module is the clock master and drives CK while it transmits
+ * *The USART can't take its clock from CK so there is no slave mode, the peer
+ * of a synchronous link has to be a clock slave (like an SPI slave)
+ *
+ * @param clockMode UART_CLOCK_DIS or UART_CLOCK_EN combined with
+ *                 UART_CLOCK_CPOL_HIGH: CK is high when idle
+ *                 UART_CLOCK_CPHA_SECOND: Data is captured on the second clock edge
+ *                 UART_CLOCK_LAST_BIT: A clock pulse is given for the last data bit
+ * @param uartModule the module number of the UART
+ *                 UART1
+ *                 UART2
+ *                 UART3
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the module has no CK pin (UART4 and UART5) or is sending
+ */
+Std_ReturnType Uart_SetClockMode(uint32_t clockMode, uint8_t uartModule) 
+{
+  Std_ReturnType error = E_NOT_OK;
+  volatile uart_t* Uart = (volatile uart_t*)Uart_Address[uartModule];
+  if ((UART_CLOCK_DIS == clockMode || uartModule < UART4) && UART_BUFFER_IDLE == txBuffer[uartModule].state) 
+  {
+    /* CPOL, CPHA and LBCL must not be changed while the transmitter is enabled */
+    Uart->CR1 &= UART_TE_CLR;
+    Uart->CR2 &= UART_CLOCK_CLR;
+    Uart->CR2 |= clockMode & ~UART_CLOCK_CLR;
+    Uart->CR1 |= UART_TE_SET;
+    error = E_OK;
+  }
+  return error;
+}
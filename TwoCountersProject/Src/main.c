@@ -14,13 +14,27 @@
 #include "HUart.h"
 #include "HRcc.h"
 #include "CLcd.h"
+#include "App_Cfg.h"
 #include "App.h"
 #include "Switch.h"
+#include "Link.h"
+#include "Heartbeat.h"
+#include "Rpc.h"
+#include "Flash.h"
+#include "FwUpdate.h"
+#include "Persist.h"
 
-Task t1 = {APP_sendTask, 4000, 2};
-Task t2 = {CLcd_Task, 1000, 3};
-Task t3 = {Switch_Task, 4000, 0};
-Task t4 = {HUart_Task, 1000, 1};
+/* The LCD and the switch count their runs for the LCD delays and the debouncing */
+Task t1 = {APP_sendTask, APP_TASK_PERIOD_MS * 1000, 2, SCHED_TASK_TUNABLE};
+Task t2 = {CLcd_Task, 1000, 3, SCHED_TASK_FIXED};
+Task t3 = {Switch_Task, 4000, 0, SCHED_TASK_FIXED};
+Task t4 = {HUart_Task, 1000, 1, SCHED_TASK_TUNABLE};
+Task t5 = {Link_Task, 1000, 4, SCHED_TASK_TUNABLE};
+Task t6 = {Heartbeat_Task, 10000, 5, SCHED_TASK_TUNABLE};
+Task t7 = {Rpc_Task, 10000, 6, SCHED_TASK_TUNABLE};
+Task t8 = {Flash_Task, 1000, 7, SCHED_TASK_TUNABLE};
+Task t9 = {FwUpdate_Task, 10000, 8, SCHED_TASK_TUNABLE};
+Task t10 = {Persist_Task, 100000, 9, SCHED_TASK_TUNABLE};
 
 void main(void)
 {
@@ -30,6 +44,12 @@ void main(void)
 	SCHED_createTask(&t2);
 	SCHED_createTask(&t3);
 	SCHED_createTask(&t4);
+	SCHED_createTask(&t5);
+	SCHED_createTask(&t6);
+	SCHED_createTask(&t7);
+	SCHED_createTask(&t8);
+	SCHED_createTask(&t9);
+	SCHED_createTask(&t10);
 
 	APP_init();
 	SCHED_init();
@@ -0,0 +1,36 @@
+/**
+ * @file Check.h
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief This is the check macro of the host tests, a failed check is printed with
+ * its place and the test goes on so one run shows every failure
+ * @version 0.1
+ * @date 2020-04-24
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#ifndef CHECK_H
+#define CHECK_H
+
+#include <stdio.h>
+
+static unsigned int Check_failures;
+static unsigned int Check_count;
+
+#define CHECK(cond)                                                                 \
+    do                                                                              \
+    {                                                                               \
+        Check_count++;                                                              \
+        if(!(cond))                                                                 \
+        {                                                                           \
+            Check_failures++;                                                       \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);         \
+        }                                                                           \
+    } while(0)
+
+/* The exit code of the test, 0 when every check passed */
+#define CHECK_RESULT(name)                                                          \
+    (printf("%s: %u checks, %u failed\n", (name), Check_count, Check_failures),     \
+     (Check_failures ? 1 : 0))
+
+#endif
@@ -0,0 +1,57 @@
+/**
+ * @file FlashSim.h
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief This is the user interface for the simulated flash controller, it plays the part
+ * of the hardware behind the registers of the flash driver over the flash that Sim_Init maps
+ * *A test is linked with -Wl,--wrap=Flash_Task so every run of the driver, also the ones
+ * the boot loader makes on its own, is one step of the controller, a page erase keeps
+ * BSY set for one run and a half word is programmed at once
+ * *A power cut is simulated by freezing the flash after some runs, the driver goes on
+ * so it ends its job, and FlashSim_PowerUp puts the flash back as it was at the cut
+ * @version 0.1
+ * @date 2020-04-24
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#ifndef FLASHSIM_H
+#define FLASHSIM_H
+
+/**
+ * @brief Locks the simulated controller like after a reset, Sim_Init has to be called first
+ *
+ */
+extern void FlashSim_Init(void);
+/**
+ * @brief Moves the controller on by one run of the driver, it unlocks it after the keys
+ * and erases the page it was started on
+ *
+ */
+extern void FlashSim_Step(void);
+/**
+ * @brief Gets the number of pages erased since FlashSim_Init
+ *
+ * @return uint32_t the number of pages
+ */
+extern uint32_t FlashSim_GetErases(void);
+/**
+ * @brief Cuts the power once the driver ran some more times, what the driver programs
+ * or erases after that is lost at FlashSim_PowerUp
+ *
+ * @param runs the runs of Flash_Task that still reach the flash
+ */
+extern void FlashSim_CutAfter(uint32_t runs);
+/**
+ * @brief Checks if the power was cut
+ *
+ * @return uint8_t 1 if it was and 0 if not
+ */
+extern uint8_t FlashSim_IsCut(void);
+/**
+ * @brief Starts the flash again after a power cut, it holds what it held at the cut,
+ * the driver has to be idle first like after a reset
+ *
+ */
+extern void FlashSim_PowerUp(void);
+
+#endif
@@ -0,0 +1,82 @@
+/**
+ * @file FwSend.h
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief This is the user interface for the host side of the firmware update, it streams
+ * an image to FwUpdate over the link, two blocks ahead of the last one acknowledged,
+ * sends a block again when the board asks for it and ends with FINISH and REBOOT
+ * @version 0.1
+ * @date 2020-04-24
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#ifndef FWSEND_H
+#define FWSEND_H
+
+#define FWSEND_IDLE                 0
+#define FWSEND_STARTING             1
+#define FWSEND_SENDING              2
+#define FWSEND_FINISHING            3
+#define FWSEND_REBOOTING            4
+#define FWSEND_DONE                 5
+#define FWSEND_FAILED               6
+
+/* A request that got no reply is sent again after this time in micro seconds */
+#define FWSEND_RETRY_US             2000000
+
+typedef struct
+{
+    uint8_t state;
+    uint16_t blocks;
+    /* The blocks the board programmed and checked */
+    uint16_t acked;
+    /* Blocks sent again after the board asked for them or went quiet */
+    uint32_t resent;
+    /* The status of the last reply that was not FWUPDATE_STATUS_OK */
+    uint8_t lastError;
+}fwSendStats_t;
+
+/**
+ * @brief Initializes the sender, an update that was running is dropped
+ *
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+extern Std_ReturnType FwSend_Init(void);
+/**
+ * @brief Starts sending an image, the link has to be initialized first and its
+ * messages given to FwSend_Receive
+ *
+ * @param image the image, it has to stay there until the update ends
+ * @param size the size of the image in bytes
+ * @param reboot 1 to reset the board into the boot loader once the image is checked
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the update started
+ *                  E_NOT_OK: If the image is empty or an update is running
+ */
+extern Std_ReturnType FwSend_Start(const uint8_t* image, uint32_t size, uint8_t reboot);
+/**
+ * @brief Handles a message received from the link, the ones that are not replies
+ * of the firmware update are ignored
+ *
+ * @param data the message
+ * @param length the length of the message
+ */
+extern void FwSend_Receive(const uint8_t* data, uint16_t length);
+/**
+ * @brief Gets the progress of the update
+ *
+ * @param stats where to put the progress
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+extern Std_ReturnType FwSend_GetStats(fwSendStats_t* stats);
+/**
+ * @brief The sender task, it gives the link the next requests, it comes after Link_Task
+ *
+ */
+extern void FwSend_Task(void);
+
+#endif
@@ -0,0 +1,77 @@
+/**
+ * @file Sim.h
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief This is the user interface for the host simulation of the micro controller,
+ * the flash and the peripheral registers are mapped at their real addresses so the
+ * drivers run unchanged, the time is virtual and only moves when the test moves it
+ * @version 0.1
+ * @date 2020-04-24
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#ifndef SIM_H
+#define SIM_H
+
+#define SIM_FLASH_BASE              0x08000000
+#define SIM_FLASH_SIZE              0x00010000
+#define SIM_PERIPHERAL_BASE         0x40000000
+#define SIM_PERIPHERAL_SIZE         0x00024000
+#define SIM_CORE_BASE               0xE0000000
+#define SIM_CORE_SIZE               0x00100000
+
+#define SIM_NS_PER_US               1000ULL
+#define SIM_NS_PER_MS               1000000ULL
+
+/**
+ * @brief Maps the flash and the registers the first time it is called and clears the
+ * registers, the virtual clock and the interrupt state every time
+ * *The flash keeps its content between calls so a test can restart the modules
+ * over the same flash like after a reset
+ *
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the memory is mapped
+ *                  E_NOT_OK: If an address range is not free on this host
+ */
+extern Std_ReturnType Sim_Init(void);
+/**
+ * @brief Gets the virtual time
+ *
+ * @return uint64_t the time since Sim_Init in nano seconds
+ */
+extern uint64_t Sim_GetNanos(void);
+/**
+ * @brief Moves the virtual time forward, it never goes back
+ *
+ * @param nanos the new time in nano seconds
+ */
+extern void Sim_SetNanos(uint64_t nanos);
+/**
+ * @brief Checks if an interrupt is enabled in the NVIC and not masked by the CPU
+ *
+ * @param interruptNum the number of the interrupt
+ * @return uint8_t 1 if the interrupt can be taken and 0 if not
+ */
+extern uint8_t Sim_IsIrqEnabled(uint8_t interruptNum);
+/**
+ * @brief Applies the writes to the set and reset registers of the GPIO ports
+ * to their output registers like the hardware does
+ *
+ */
+extern void Sim_SyncGpio(void);
+/**
+ * @brief Reads an output pin after Sim_SyncGpio
+ *
+ * @param port the port address
+ * @param pin the pin mask
+ * @return uint8_t 1 if the pin is high and 0 if it is low
+ */
+extern uint8_t Sim_ReadOutputPin(uint32_t port, uint32_t pin);
+/**
+ * @brief Gets the number of system resets asked for since Sim_Init
+ *
+ * @return uint32_t the number of resets
+ */
+extern uint32_t Sim_GetResets(void);
+
+#endif
@@ -0,0 +1,44 @@
+/**
+ * @brief The Standered types used in the drivers when they are built for the host
+ * *long is 64 bits on a 64-bit host so the fixed width types are taken from stdint.h
+ *
+ */
+#ifndef STD_TYPES_H
+#define STD_TYPES_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef uint8_t                         u8;
+typedef int8_t                          s8;
+typedef int8_t                          sint8_t;
+typedef uint16_t                        u16;
+typedef int16_t                         s16;
+typedef int16_t                         sint16_t;
+typedef uint32_t                        u32;
+typedef int32_t                         s32;
+typedef int32_t                         sint32_t;
+typedef uint64_t                        u64;
+typedef int64_t                         s64;
+typedef int64_t                         sint64_t;
+
+typedef float                           f32;
+typedef double                          f64;
+
+typedef void (*callback_t)(void);
+
+typedef uint8_t Std_ReturnType;
+
+#define E_OK                            (0)
+#define E_NOT_OK                        (1)
+
+#define STD_LOW                         (0)
+#define STD_HIGH                        (1)
+
+#define STD_IDLE                        (0)
+#define STD_ACTIVE                      (1)
+
+#define STD_OFF                         (0)
+#define STD_ON                          (1)
+
+#endif
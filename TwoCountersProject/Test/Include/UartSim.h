@@ -0,0 +1,94 @@
+/**
+ * @file UartSim.h
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief This is the user interface for the simulated USART, it plays the part of the
+ * hardware behind the registers of the UART driver and joins two modules with a
+ * virtual wire that takes the real character time for every byte
+ * *The data register is double buffered like the real one, a byte that arrives while
+ * RXNE is still set is lost and counted as an overrun, the multi-drop mute mode and
+ * the synchronous clock are not simulated
+ * @version 0.1
+ * @date 2020-04-24
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#ifndef UARTSIM_H
+#define UARTSIM_H
+
+#define UARTSIM_NO_EVENT            0xFFFFFFFFFFFFFFFFULL
+
+typedef struct
+{
+    /* Bytes that left the transmitter of the module */
+    uint32_t wireBytes;
+    /* Bytes lost at the receiver of the module because RXNE was still set */
+    uint32_t overrunBytes;
+    /* Writes to the data register while the holding register was full */
+    uint32_t overwrites;
+    uint32_t irqCalls;
+    /* Host time spent in the interrupt handler of the module */
+    uint64_t irqHostNanos;
+}uartSimStats_t;
+
+/**
+ * @brief Initializes the simulated modules, Sim_Init has to be called first
+ *
+ * @param busClk the clock of the buses in Hz, the baud rate is taken from BRR with it
+ */
+extern void UartSim_Init(uint32_t busClk);
+/**
+ * @brief Joins the transmitter of each module to the receiver of the other
+ *
+ * @param moduleA the first module (UART1 to UART5)
+ * @param moduleB the second module (UART1 to UART5)
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the modules are joined
+ *                  E_NOT_OK: If a module number is wrong or both are the same
+ */
+extern Std_ReturnType UartSim_Connect(uint8_t moduleA, uint8_t moduleB);
+/**
+ * @brief Tells the wire which output pin is the RTS of a module, the peer only
+ * starts a byte while that pin is low if its CTS is enabled
+ *
+ * @param uartModule the module (UART1 to UART5)
+ * @param port the port of the RTS pin
+ * @param pin the RTS pin
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the pin is set
+ *                  E_NOT_OK: If the module number is wrong
+ */
+extern Std_ReturnType UartSim_SetRtsPin(uint8_t uartModule, uint32_t port, uint32_t pin);
+/**
+ * @brief Holds all the UART interrupts back until a time, like a long critical
+ * section or a higher priority interrupt would
+ *
+ * @param untilNanos the virtual time the interrupts can be taken again
+ */
+extern void UartSim_BlockIrq(uint64_t untilNanos);
+/**
+ * @brief Gets the time of the next thing the simulated hardware does by itself
+ *
+ * @return uint64_t the virtual time in nano seconds or UARTSIM_NO_EVENT
+ */
+extern uint64_t UartSim_NextEvent(void);
+/**
+ * @brief Brings the simulated hardware to the virtual time, it takes the data
+ * written by the driver, moves the bytes on the wires and calls the interrupt
+ * handlers, it has to be called after the virtual time moves and after every
+ * call into the driver
+ *
+ */
+extern void UartSim_Step(void);
+/**
+ * @brief Gets the statistics of a simulated module
+ *
+ * @param uartModule the module (UART1 to UART5)
+ * @param stats where to copy the statistics
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the statistics are copied
+ *                  E_NOT_OK: If the module number is wrong
+ */
+extern Std_ReturnType UartSim_GetStats(uint8_t uartModule, uartSimStats_t* stats);
+
+#endif
@@ -0,0 +1,175 @@
+/**
+ * @file FlashSim.c
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief This is the implementation for the simulated flash controller
+ * *The half words the driver programs land in the mapped flash directly, so the rule
+ * that only erased flash is programmed is not checked, and the status register is plain
+ * memory so no error or end of operation flag is ever set
+ * @version 0.1
+ * @date 2020-04-24
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include <string.h>
+#include "Std_Types.h"
+#include "Flash.h"
+#include "Sim.h"
+#include "FlashSim.h"
+
+#define FLASHSIM_REGISTERS          ((volatile flashSimRegisters_t*)0x40022000)
+
+#define FLASHSIM_KEY2               0xCDEF89AB
+
+#define FLASHSIM_SR_BSY             0x00000001
+
+#define FLASHSIM_CR_PER             0x00000002
+#define FLASHSIM_CR_STRT            0x00000040
+#define FLASHSIM_CR_LOCK            0x00000080
+
+#define FLASHSIM_ERASED             0xFF
+
+typedef struct
+{
+    uint32_t ACR;
+    uint32_t KEYR;
+    uint32_t OPTKEYR;
+    uint32_t SR;
+    uint32_t CR;
+    uint32_t AR;
+    uint32_t RESERVED;
+    uint32_t OBR;
+    uint32_t WRPR;
+}flashSimRegisters_t;
+
+static uint32_t FlashSim_erases;
+
+/* The runs left before the cut while cutArmed is set and the flash as it was at the cut */
+static uint8_t FlashSim_cutArmed;
+static uint32_t FlashSim_runsLeft;
+static uint8_t FlashSim_cut;
+static uint8_t FlashSim_frozen[SIM_FLASH_SIZE];
+
+extern void __real_Flash_Task(void);
+
+/**
+ * @brief Locks the simulated controller like after a reset, Sim_Init has to be called first
+ *
+ */
+void FlashSim_Init(void)
+{
+    FLASHSIM_REGISTERS->CR = FLASHSIM_CR_LOCK;
+    FLASHSIM_REGISTERS->SR = 0;
+    FLASHSIM_REGISTERS->KEYR = 0;
+    FlashSim_erases = 0;
+    FlashSim_cutArmed = 0;
+    FlashSim_cut = 0;
+}
+
+/**
+ * @brief Moves the controller on by one run of the driver, it unlocks it after the keys
+ * and erases the page it was started on
+ *
+ */
+void FlashSim_Step(void)
+{
+    uint32_t page;
+    /* Only the last write to the key register is seen, the driver writes both at once */
+    if(FLASHSIM_KEY2 == FLASHSIM_REGISTERS->KEYR)
+    {
+        FLASHSIM_REGISTERS->CR &= ~FLASHSIM_CR_LOCK;
+        FLASHSIM_REGISTERS->KEYR = 0;
+    }
+    if((FLASHSIM_REGISTERS->CR & FLASHSIM_CR_PER) && (FLASHSIM_REGISTERS->CR & FLASHSIM_CR_STRT))
+    {
+        if(FLASHSIM_REGISTERS->CR & FLASHSIM_CR_LOCK)
+        {
+            /* The control register cannot be written while it is locked */
+            FLASHSIM_REGISTERS->CR &= ~(FLASHSIM_CR_PER | FLASHSIM_CR_STRT);
+        }
+        else if(!(FLASHSIM_REGISTERS->SR & FLASHSIM_SR_BSY))
+        {
+            FLASHSIM_REGISTERS->SR |= FLASHSIM_SR_BSY;
+        }
+        else
+        {
+            page = FLASHSIM_REGISTERS->AR & ~(uint32_t)(FLASH_PAGE_SIZE - 1);
+            if(page >= SIM_FLASH_BASE && page - SIM_FLASH_BASE < SIM_FLASH_SIZE)
+            {
+                memset((void*)(uintptr_t)page, FLASHSIM_ERASED, FLASH_PAGE_SIZE);
+                FlashSim_erases++;
+            }
+            FLASHSIM_REGISTERS->SR &= ~FLASHSIM_SR_BSY;
+            FLASHSIM_REGISTERS->CR &= ~FLASHSIM_CR_STRT;
+        }
+    }
+}
+
+/**
+ * @brief Gets the number of pages erased since FlashSim_Init
+ *
+ * @return uint32_t the number of pages
+ */
+uint32_t FlashSim_GetErases(void)
+{
+    return FlashSim_erases;
+}
+
+/**
+ * @brief Cuts the power once the driver ran some more times, what the driver programs
+ * or erases after that is lost at FlashSim_PowerUp
+ *
+ * @param runs the runs of Flash_Task that still reach the flash
+ */
+void FlashSim_CutAfter(uint32_t runs)
+{
+    FlashSim_runsLeft = runs;
+    FlashSim_cutArmed = 1;
+}
+
+/**
+ * @brief Checks if the power was cut
+ *
+ * @return uint8_t 1 if it was and 0 if not
+ */
+uint8_t FlashSim_IsCut(void)
+{
+    return FlashSim_cut;
+}
+
+/**
+ * @brief Starts the flash again after a power cut, it holds what it held at the cut,
+ * the driver has to be idle first like after a reset
+ *
+ */
+void FlashSim_PowerUp(void)
+{
+    if(FlashSim_cut)
+    {
+        memcpy((void*)(uintptr_t)SIM_FLASH_BASE, FlashSim_frozen, SIM_FLASH_SIZE);
+    }
+    FlashSim_Init();
+}
+
+/**
+ * @brief Stands in for Flash_Task in the tests linked with -Wl,--wrap=Flash_Task
+ *
+ */
+void __wrap_Flash_Task(void)
+{
+    if(FlashSim_cutArmed)
+    {
+        if(0 == FlashSim_runsLeft)
+        {
+            memcpy(FlashSim_frozen, (const void*)(uintptr_t)SIM_FLASH_BASE, SIM_FLASH_SIZE);
+            FlashSim_cutArmed = 0;
+            FlashSim_cut = 1;
+        }
+        else
+        {
+            FlashSim_runsLeft--;
+        }
+    }
+    FlashSim_Step();
+    __real_Flash_Task();
+}
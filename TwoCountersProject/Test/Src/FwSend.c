@@ -0,0 +1,321 @@
+/**
+ * @file FwSend.c
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief This is the implementation for the host side of the firmware update
+ * @version 0.1
+ * @date 2020-04-24
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include "Std_Types.h"
+#include "SYSTICK.h"
+#include "Frame_Cfg.h"
+#include "Frame.h"
+#include "Link_Cfg.h"
+#include "Link.h"
+#include "FwUpdate_Cfg.h"
+#include "FwUpdate.h"
+#include "FwSend.h"
+
+#define FWSEND_CRC_INIT             0xFFFF
+#define FWSEND_CHUNKS_PER_BLOCK     (FWUPDATE_BLOCK_SIZE / FWUPDATE_CHUNK_SIZE)
+#define FWSEND_START_ARGS           6
+/* The board receives a block while it programs the one before */
+#define FWSEND_BLOCKS_IN_FLIGHT     2
+
+static fwSendStats_t FwSend_stats;
+static const uint8_t* FwSend_image;
+static uint32_t FwSend_size;
+static uint16_t FwSend_crc;
+static uint8_t FwSend_reboot;
+
+/* The next block to send and the next chunk of it, past the last chunk comes its end */
+static uint16_t FwSend_block;
+static uint16_t FwSend_chunk;
+
+/* A request waits for its reply, or blocks wait for their acks */
+static uint8_t FwSend_waiting;
+static uint32_t FwSend_sentAt;
+
+/**
+ * @brief Gives a request to the link
+ *
+ * @param op the operation
+ * @param arg the 16 bits argument
+ * @param args the arguments after the header, can be NULL if there are none
+ * @param argLength the length of the arguments
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the link took the request
+ *                  E_NOT_OK: If its window is full
+ */
+static Std_ReturnType FwSend_Request(uint8_t op, uint16_t arg, const uint8_t* args, uint16_t argLength)
+{
+    uint8_t message[FWUPDATE_HEADER_SIZE + FWUPDATE_CHUNK_SIZE];
+    uint16_t i;
+    message[0] = FWUPDATE_MSG_REQUEST;
+    message[1] = op;
+    message[2] = (uint8_t)arg;
+    message[3] = (uint8_t)(arg >> 8);
+    for(i = 0; i < argLength; i++)
+    {
+        message[FWUPDATE_HEADER_SIZE + i] = args[i];
+    }
+    return Link_Send(message, FWUPDATE_HEADER_SIZE + argLength);
+}
+
+/**
+ * @brief Gives the link the chunks and the block ends it has room for, up to two
+ * blocks past the last one acknowledged
+ *
+ */
+static void FwSend_SendBlocks(void)
+{
+    uint32_t offset;
+    uint32_t length;
+    uint32_t chunkOffset;
+    uint16_t crc;
+    uint8_t args[2];
+    Std_ReturnType error = E_OK;
+    while(E_OK == error && FwSend_block < FwSend_stats.blocks && FwSend_block < FwSend_stats.acked + FWSEND_BLOCKS_IN_FLIGHT)
+    {
+        offset = (uint32_t)FwSend_block * FWUPDATE_BLOCK_SIZE;
+        length = FwSend_size - offset < FWUPDATE_BLOCK_SIZE ? FwSend_size - offset : FWUPDATE_BLOCK_SIZE;
+        chunkOffset = (uint32_t)FwSend_chunk * FWUPDATE_CHUNK_SIZE;
+        if(chunkOffset < length)
+        {
+            error = FwSend_Request(FWUPDATE_OP_DATA, FwSend_block * FWSEND_CHUNKS_PER_BLOCK + FwSend_chunk,
+                                   &FwSend_image[offset + chunkOffset],
+                                   length - chunkOffset < FWUPDATE_CHUNK_SIZE ? length - chunkOffset : FWUPDATE_CHUNK_SIZE);
+            if(E_OK == error)
+            {
+                FwSend_chunk++;
+            }
+        }
+        else
+        {
+            crc = Frame_Crc16(&FwSend_image[offset], (uint16_t)length, FWSEND_CRC_INIT);
+            args[0] = (uint8_t)crc;
+            args[1] = (uint8_t)(crc >> 8);
+            error = FwSend_Request(FWUPDATE_OP_BLOCK_END, FwSend_block, args, sizeof(args));
+            if(E_OK == error)
+            {
+                FwSend_block++;
+                FwSend_chunk = 0;
+            }
+        }
+        if(E_OK == error && !FwSend_waiting)
+        {
+            FwSend_waiting = 1;
+            FwSend_sentAt = SYSTICK_getMicros();
+        }
+    }
+}
+
+/**
+ * @brief Goes on from a block the board asked for
+ *
+ * @param block the index of the block
+ */
+static void FwSend_Rewind(uint16_t block)
+{
+    FwSend_block = block;
+    FwSend_chunk = 0;
+    FwSend_stats.resent++;
+}
+
+/**
+ * @brief Initializes the sender, an update that was running is dropped
+ *
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+Std_ReturnType FwSend_Init(void)
+{
+    FwSend_stats.state = FWSEND_IDLE;
+    FwSend_stats.blocks = 0;
+    FwSend_stats.acked = 0;
+    FwSend_stats.resent = 0;
+    FwSend_stats.lastError = FWUPDATE_STATUS_OK;
+    FwSend_waiting = 0;
+    return E_OK;
+}
+
+/**
+ * @brief Starts sending an image, the link has to be initialized first and its
+ * messages given to FwSend_Receive
+ *
+ * @param image the image, it has to stay there until the update ends
+ * @param size the size of the image in bytes
+ * @param reboot 1 to reset the board into the boot loader once the image is checked
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the update started
+ *                  E_NOT_OK: If the image is empty or an update is running
+ */
+Std_ReturnType FwSend_Start(const uint8_t* image, uint32_t size, uint8_t reboot)
+{
+    Std_ReturnType error = E_NOT_OK;
+    if(image && size && size <= FWUPDATE_SLOT_SIZE && (FWSEND_IDLE == FwSend_stats.state ||
+        FWSEND_DONE == FwSend_stats.state || FWSEND_FAILED == FwSend_stats.state))
+    {
+        FwSend_image = image;
+        FwSend_size = size;
+        FwSend_crc = Frame_Crc16(image, (uint16_t)size, FWSEND_CRC_INIT);
+        FwSend_reboot = reboot;
+        FwSend_stats.blocks = (uint16_t)((size + FWUPDATE_BLOCK_SIZE - 1) / FWUPDATE_BLOCK_SIZE);
+        FwSend_stats.acked = 0;
+        FwSend_stats.resent = 0;
+        FwSend_stats.lastError = FWUPDATE_STATUS_OK;
+        FwSend_stats.state = FWSEND_STARTING;
+        FwSend_waiting = 0;
+        error = E_OK;
+    }
+    return error;
+}
+
+/**
+ * @brief Handles a message received from the link, the ones that are not replies
+ * of the firmware update are ignored
+ *
+ * @param data the message
+ * @param length the length of the message
+ */
+void FwSend_Receive(const uint8_t* data, uint16_t length)
+{
+    uint8_t op;
+    uint8_t status;
+    uint16_t next;
+    if(data && length == FWUPDATE_REPLY_SIZE && data[0] == FWUPDATE_MSG_REPLY)
+    {
+        op = data[1];
+        status = data[2];
+        next = data[3] | (uint16_t)(data[4] << 8);
+        if(FWUPDATE_STATUS_OK != status)
+        {
+            FwSend_stats.lastError = status;
+        }
+        if(FWSEND_STARTING == FwSend_stats.state && FWUPDATE_OP_START == op)
+        {
+            /* A busy board is asked again once the request times out */
+            if(FWUPDATE_STATUS_OK == status && next <= FwSend_stats.blocks)
+            {
+                FwSend_stats.acked = next;
+                FwSend_block = next;
+                FwSend_chunk = 0;
+                FwSend_waiting = 0;
+                FwSend_stats.state = next == FwSend_stats.blocks ? FWSEND_FINISHING : FWSEND_SENDING;
+            }
+            else if(FWUPDATE_STATUS_BUSY != status)
+            {
+                FwSend_stats.state = FWSEND_FAILED;
+            }
+        }
+        else if(FWSEND_SENDING == FwSend_stats.state && FWUPDATE_OP_BLOCK_END == op)
+        {
+            if(FWUPDATE_STATUS_OK == status)
+            {
+                if(next > FwSend_stats.acked && next <= FwSend_block)
+                {
+                    FwSend_stats.acked = next;
+                    FwSend_sentAt = SYSTICK_getMicros();
+                    FwSend_waiting = next < FwSend_block;
+                }
+                if(FwSend_stats.acked == FwSend_stats.blocks)
+                {
+                    FwSend_stats.state = FWSEND_FINISHING;
+                }
+            }
+            else if(FWUPDATE_STATUS_CRC_ERROR == status || FWUPDATE_STATUS_BUSY == status)
+            {
+                FwSend_Rewind(next);
+            }
+            else if(FWUPDATE_STATUS_FLASH_ERROR == status)
+            {
+                FwSend_stats.state = FWSEND_FAILED;
+            }
+            /* FWUPDATE_STATUS_BAD_STATE is the end of a block sent before a rewind, the
+             * board was waiting for another one and dropped it */
+        }
+        else if(FWSEND_FINISHING == FwSend_stats.state && FWUPDATE_OP_FINISH == op &&
+                FWUPDATE_STATUS_BAD_STATE != status)
+        {
+            /* A FINISH sent again while the board checks the image is refused, the
+             * first one is still answered */
+            FwSend_waiting = 0;
+            FwSend_stats.state = FWUPDATE_STATUS_OK != status ? FWSEND_FAILED :
+                                 FwSend_reboot ? FWSEND_REBOOTING : FWSEND_DONE;
+        }
+        else if(FWSEND_REBOOTING == FwSend_stats.state && FWUPDATE_OP_REBOOT == op)
+        {
+            FwSend_waiting = 0;
+            FwSend_stats.state = FWUPDATE_STATUS_OK == status ? FWSEND_DONE : FWSEND_FAILED;
+        }
+    }
+}
+
+/**
+ * @brief Gets the progress of the update
+ *
+ * @param stats where to put the progress
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+Std_ReturnType FwSend_GetStats(fwSendStats_t* stats)
+{
+    Std_ReturnType error = E_NOT_OK;
+    if(stats)
+    {
+        *stats = FwSend_stats;
+        error = E_OK;
+    }
+    return error;
+}
+
+/**
+ * @brief The sender task, it gives the link the next requests, it comes after Link_Task
+ *
+ */
+void FwSend_Task(void)
+{
+    uint8_t args[FWSEND_START_ARGS];
+    uint8_t op = FWUPDATE_OP_START;
+    uint16_t argLength = 0;
+    if(FwSend_waiting && SYSTICK_getMicros() - FwSend_sentAt >= FWSEND_RETRY_US)
+    {
+        /* The board went quiet, the blocks not acknowledged are sent again */
+        FwSend_waiting = 0;
+        if(FWSEND_SENDING == FwSend_stats.state)
+        {
+            FwSend_Rewind(FwSend_stats.acked);
+        }
+    }
+    if(FWSEND_SENDING == FwSend_stats.state)
+    {
+        FwSend_SendBlocks();
+    }
+    else if(!FwSend_waiting && (FWSEND_STARTING == FwSend_stats.state || FWSEND_FINISHING == FwSend_stats.state ||
+            FWSEND_REBOOTING == FwSend_stats.state))
+    {
+        if(FWSEND_STARTING == FwSend_stats.state)
+        {
+            args[0] = (uint8_t)FwSend_size;
+            args[1] = (uint8_t)(FwSend_size >> 8);
+            args[2] = (uint8_t)(FwSend_size >> 16);
+            args[3] = (uint8_t)(FwSend_size >> 24);
+            args[4] = (uint8_t)FwSend_crc;
+            args[5] = (uint8_t)(FwSend_crc >> 8);
+            argLength = FWSEND_START_ARGS;
+        }
+        else
+        {
+            op = FWSEND_FINISHING == FwSend_stats.state ? FWUPDATE_OP_FINISH : FWUPDATE_OP_REBOOT;
+        }
+        if(E_OK == FwSend_Request(op, 0, args, argLength))
+        {
+            FwSend_waiting = 1;
+            FwSend_sentAt = SYSTICK_getMicros();
+        }
+    }
+}
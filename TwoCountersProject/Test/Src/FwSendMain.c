@@ -0,0 +1,214 @@
+/**
+ * @file FwSendMain.c
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief This is the host tool that sends an application image to the board over a
+ * serial port, the link runs over the port in place of the transport and the time
+ * is taken from the host clock in place of the SysTick
+ *
+ *   FwSend <serial port> <image.bin> [-b baudrate] [-n]
+ *
+ * *The image is the binary of the application linked at FWUPDATE_APP_ADDRESS, -n leaves
+ * it in the download slot without asking the board to reset into the boot loader
+ * @version 0.1
+ * @date 2020-04-24
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include "Std_Types.h"
+#include "SYSTICK.h"
+#include "Link_Cfg.h"
+#include "Link.h"
+#include "FwUpdate_Cfg.h"
+#include "FwUpdate.h"
+#include "FwSend.h"
+
+#define FWSENDMAIN_DEFAULT_BAUDRATE 9600
+
+typedef struct
+{
+    uint32_t baudrate;
+    speed_t speed;
+}fwSendMainSpeed_t;
+
+static const fwSendMainSpeed_t FwSendMain_speeds[] = {
+    {9600, B9600},
+    {19200, B19200},
+    {38400, B38400},
+    {57600, B57600},
+    {115200, B115200},
+    {230400, B230400}
+};
+
+static int FwSendMain_port = -1;
+static uint8_t FwSendMain_image[FWUPDATE_SLOT_SIZE];
+
+Std_ReturnType Transport_Send(const uint8_t* data, uint16_t length)
+{
+    ssize_t written;
+    while(length)
+    {
+        written = write(FwSendMain_port, data, length);
+        if(written < 0 && EAGAIN != errno && EINTR != errno)
+        {
+            return E_NOT_OK;
+        }
+        if(written > 0)
+        {
+            data += written;
+            length -= (uint16_t)written;
+        }
+    }
+    return E_OK;
+}
+Std_ReturnType Transport_Read(uint8_t* data, uint16_t maxLength, uint16_t* count)
+{
+    ssize_t n = read(FwSendMain_port, data, maxLength);
+    *count = n > 0 ? (uint16_t)n : 0;
+    return E_OK;
+}
+u32 SYSTICK_getMicros(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (u32)((uint64_t)now.tv_sec * 1000000 + (uint64_t)now.tv_nsec / 1000);
+}
+
+/**
+ * @brief Opens the serial port raw at a baud rate
+ *
+ * @param path the port
+ * @param baudrate the baud rate
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the port is open
+ *                  E_NOT_OK: If it could not be opened or the baud rate is not supported
+ */
+static Std_ReturnType FwSendMain_Open(const char* path, uint32_t baudrate)
+{
+    struct termios options;
+    uint8_t i;
+    for(i = 0; i < sizeof(FwSendMain_speeds) / sizeof(FwSendMain_speeds[0]); i++)
+    {
+        if(FwSendMain_speeds[i].baudrate == baudrate)
+        {
+            break;
+        }
+    }
+    if(i == sizeof(FwSendMain_speeds) / sizeof(FwSendMain_speeds[0]))
+    {
+        return E_NOT_OK;
+    }
+    FwSendMain_port = open(path, O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if(FwSendMain_port < 0 || tcgetattr(FwSendMain_port, &options))
+    {
+        return E_NOT_OK;
+    }
+    cfmakeraw(&options);
+    cfsetispeed(&options, FwSendMain_speeds[i].speed);
+    cfsetospeed(&options, FwSendMain_speeds[i].speed);
+    options.c_cflag |= CLOCAL | CREAD;
+    options.c_cflag &= ~(CSTOPB | CRTSCTS);
+    return tcsetattr(FwSendMain_port, TCSANOW, &options) ? E_NOT_OK : E_OK;
+}
+
+/**
+ * @brief Reads the image file
+ *
+ * @param path the file
+ * @param size where to put the size of the image
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the image is read
+ *                  E_NOT_OK: If it could not be read, is empty or does not fit the download slot
+ */
+static Std_ReturnType FwSendMain_Load(const char* path, uint32_t* size)
+{
+    FILE* file = fopen(path, "rb");
+    size_t n;
+    if(!file)
+    {
+        return E_NOT_OK;
+    }
+    n = fread(FwSendMain_image, 1, sizeof(FwSendMain_image), file);
+    /* Anything left means the image is larger than the slot */
+    if(EOF != fgetc(file))
+    {
+        n = 0;
+    }
+    fclose(file);
+    *size = (uint32_t)n;
+    return n ? E_OK : E_NOT_OK;
+}
+
+int main(int argc, char** argv)
+{
+    const struct timespec period = {0, LINK_TASK_PERIOD_MS * 1000000L};
+    fwSendStats_t stats;
+    uint32_t baudrate = FWSENDMAIN_DEFAULT_BAUDRATE;
+    uint32_t size = 0;
+    uint8_t reboot = 1;
+    uint16_t shown = 0xFFFF;
+    int i;
+    for(i = 3; i < argc; i++)
+    {
+        if(0 == strcmp(argv[i], "-b") && i + 1 < argc)
+        {
+            baudrate = (uint32_t)strtoul(argv[++i], NULL, 10);
+        }
+        else if(0 == strcmp(argv[i], "-n"))
+        {
+            reboot = 0;
+        }
+        else
+        {
+            argc = 0;
+        }
+    }
+    if(argc < 3)
+    {
+        fprintf(stderr, "usage: %s <serial port> <image.bin> [-b baudrate] [-n]\n", argv[0]);
+        return 2;
+    }
+    if(E_OK != FwSendMain_Load(argv[2], &size))
+    {
+        fprintf(stderr, "%s: cannot read the image or it is larger than %u bytes\n", argv[2], FWUPDATE_SLOT_SIZE);
+        return 1;
+    }
+    if(E_OK != FwSendMain_Open(argv[1], baudrate))
+    {
+        fprintf(stderr, "%s: cannot open the port at %u baud\n", argv[1], (unsigned int)baudrate);
+        return 1;
+    }
+    Link_Init();
+    Link_SetRxCb(FwSend_Receive);
+    FwSend_Init();
+    FwSend_Start(FwSendMain_image, size, reboot);
+    do
+    {
+        nanosleep(&period, NULL);
+        Link_Task();
+        FwSend_Task();
+        FwSend_GetStats(&stats);
+        if(stats.acked != shown && FWSEND_STARTING != stats.state)
+        {
+            shown = stats.acked;
+            printf("\rblock %u of %u", (unsigned int)stats.acked, (unsigned int)stats.blocks);
+            fflush(stdout);
+        }
+    } while(FWSEND_DONE != stats.state && FWSEND_FAILED != stats.state);
+    printf("\n%s, %u blocks sent again\n", FWSEND_DONE == stats.state ? "done" : "failed",
+           (unsigned int)stats.resent);
+    if(FWSEND_FAILED == stats.state)
+    {
+        fprintf(stderr, "the board replied with status %u\n", (unsigned int)stats.lastError);
+    }
+    close(FwSendMain_port);
+    return FWSEND_DONE == stats.state ? 0 : 1;
+}
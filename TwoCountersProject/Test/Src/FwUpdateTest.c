@@ -0,0 +1,325 @@
+/**
+ * @file FwUpdateTest.c
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief These are the host tests of the firmware update, the host sender talks through
+ * link A to link B of the board, which hands the requests to FwUpdate over the simulated
+ * flash controller, then the boot loader installs the image and jumps to it
+ * *The test is linked at a fixed address so the reset vector of the image can be a
+ * function of the test that returns to it
+ * @version 0.1
+ * @date 2020-04-24
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include <setjmp.h>
+#include <string.h>
+#include "Std_Types.h"
+#include "Link_Cfg.h"
+#include "Link.h"
+#include "Flash_Cfg.h"
+#include "Flash.h"
+#include "FwUpdate_Cfg.h"
+#include "FwUpdate.h"
+#include "Boot.h"
+#include "FwSend.h"
+#include "Sim.h"
+#include "FlashSim.h"
+#include "Check.h"
+
+#define FWUPDATETEST_WIRE_SIZE      1024
+#define FWUPDATETEST_IMAGE_SIZE     5001
+#define FWUPDATETEST_CHUNKS         ((FWUPDATETEST_IMAGE_SIZE + FWUPDATE_CHUNK_SIZE - 1) / FWUPDATE_CHUNK_SIZE)
+#define FWUPDATETEST_BLOCK_CHUNKS   (FWUPDATE_BLOCK_SIZE / FWUPDATE_CHUNK_SIZE)
+#define FWUPDATETEST_STACK          0x20005000
+#define FWUPDATETEST_VTOR           (*(volatile uint32_t*)0xE000ED08)
+#define FWUPDATETEST_META           ((const volatile uint16_t*)FWUPDATE_META_ADDRESS)
+
+#define FWUPDATETEST_DECLARE(P)                                                     \
+    extern Std_ReturnType P##_Link_Init(void);                                      \
+    extern Std_ReturnType P##_Link_SetRxCb(linkRxCb_t func);                        \
+    extern void P##_Link_Task(void);
+
+FWUPDATETEST_DECLARE(A)
+FWUPDATETEST_DECLARE(B)
+
+typedef struct
+{
+    uint8_t data[FWUPDATETEST_WIRE_SIZE];
+    uint16_t head;
+    uint16_t tail;
+}fwUpdateTestWire_t;
+
+static fwUpdateTestWire_t FwUpdateTest_wireAB;
+static fwUpdateTestWire_t FwUpdateTest_wireBA;
+static uint8_t FwUpdateTest_image[FWUPDATETEST_IMAGE_SIZE];
+static jmp_buf FwUpdateTest_jump;
+static uint32_t FwUpdateTest_starts;
+
+/**
+ * @brief Puts bytes on a wire, they can be read at once
+ *
+ * @param wire the wire
+ * @param data the bytes
+ * @param length the number of bytes
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the bytes are on the wire
+ *                  E_NOT_OK: If the wire is full, like a busy transport
+ */
+static Std_ReturnType FwUpdateTest_WireSend(fwUpdateTestWire_t* wire, const uint8_t* data, uint16_t length)
+{
+    if(wire->tail + length > FWUPDATETEST_WIRE_SIZE)
+    {
+        return E_NOT_OK;
+    }
+    memcpy(&wire->data[wire->tail], data, length);
+    wire->tail += length;
+    return E_OK;
+}
+/**
+ * @brief Reads the bytes on a wire
+ *
+ * @param wire the wire
+ * @param data where to put the bytes
+ * @param maxLength the size of data
+ * @param count the number of bytes read
+ */
+static void FwUpdateTest_WireRead(fwUpdateTestWire_t* wire, uint8_t* data, uint16_t maxLength, uint16_t* count)
+{
+    uint16_t n = wire->tail - wire->head;
+    if(n > maxLength)
+    {
+        n = maxLength;
+    }
+    memcpy(data, &wire->data[wire->head], n);
+    wire->head += n;
+    if(wire->head == wire->tail)
+    {
+        wire->head = 0;
+        wire->tail = 0;
+    }
+    *count = n;
+}
+
+Std_ReturnType A_Transport_Send(const uint8_t* data, uint16_t length)
+{
+    return FwUpdateTest_WireSend(&FwUpdateTest_wireAB, data, length);
+}
+Std_ReturnType B_Transport_Send(const uint8_t* data, uint16_t length)
+{
+    return FwUpdateTest_WireSend(&FwUpdateTest_wireBA, data, length);
+}
+Std_ReturnType A_Transport_Read(uint8_t* data, uint16_t maxLength, uint16_t* count)
+{
+    FwUpdateTest_WireRead(&FwUpdateTest_wireBA, data, maxLength, count);
+    return E_OK;
+}
+Std_ReturnType B_Transport_Read(uint8_t* data, uint16_t maxLength, uint16_t* count)
+{
+    FwUpdateTest_WireRead(&FwUpdateTest_wireAB, data, maxLength, count);
+    return E_OK;
+}
+
+/**
+ * @brief The reset handler of the test image, it goes back to the test
+ *
+ */
+static void FwUpdateTest_AppReset(void)
+{
+    FwUpdateTest_starts++;
+    longjmp(FwUpdateTest_jump, 1);
+}
+/**
+ * @brief Hands the messages of link B to the firmware update like the application does
+ *
+ * @param data the message
+ * @param length the length of the message
+ */
+static void FwUpdateTest_ReceiveB(const uint8_t* data, uint16_t length)
+{
+    FwUpdate_Receive(data, length);
+}
+
+/**
+ * @brief Fills the test image, it starts with the stack and the reset vector of an
+ * application and goes on with bytes that differ from block to block
+ *
+ * @param seed makes one image differ from another
+ */
+static void FwUpdateTest_MakeImage(uint8_t seed)
+{
+    uint32_t stack = FWUPDATETEST_STACK;
+    uint32_t reset = (uint32_t)(uintptr_t)FwUpdateTest_AppReset;
+    uint32_t i;
+    for(i = 0; i < sizeof(FwUpdateTest_image); i++)
+    {
+        FwUpdateTest_image[i] = (uint8_t)(i * 7 + (i >> 8) + seed);
+    }
+    memcpy(&FwUpdateTest_image[0], &stack, sizeof(stack));
+    memcpy(&FwUpdateTest_image[4], &reset, sizeof(reset));
+}
+/**
+ * @brief Starts the sender, the board side, the links and both wires like after a reset of both
+ *
+ */
+static void FwUpdateTest_Start(void)
+{
+    memset(&FwUpdateTest_wireAB, 0, sizeof(FwUpdateTest_wireAB));
+    memset(&FwUpdateTest_wireBA, 0, sizeof(FwUpdateTest_wireBA));
+    A_Link_Init();
+    B_Link_Init();
+    A_Link_SetRxCb(FwSend_Receive);
+    B_Link_SetRxCb(FwUpdateTest_ReceiveB);
+    FwUpdate_Init();
+    FwSend_Init();
+}
+/**
+ * @brief Runs both sides until the sender fails or the board asks for a reset
+ *
+ * @param ms the longest time to run
+ * @param ackedLimit stops once the board acknowledged this many blocks and the flash is idle
+ */
+static void FwUpdateTest_Run(uint32_t ms, uint16_t ackedLimit)
+{
+    fwSendStats_t stats;
+    uint8_t busy = 1;
+    uint32_t resets = Sim_GetResets();
+    FwSend_GetStats(&stats);
+    while(ms-- && FWSEND_FAILED != stats.state && resets == Sim_GetResets() &&
+            (stats.acked < ackedLimit || busy))
+    {
+        Sim_SetNanos(Sim_GetNanos() + SIM_NS_PER_MS);
+        A_Link_Task();
+        FwSend_Task();
+        B_Link_Task();
+        Flash_Task();
+        if(0 == (Sim_GetNanos() / SIM_NS_PER_MS) % FWUPDATE_TASK_PERIOD_MS)
+        {
+            FwUpdate_Task();
+        }
+        FwSend_GetStats(&stats);
+        Flash_IsBusy(&busy);
+    }
+}
+
+/**
+ * @brief An image goes to the download slot block by block, it is checked and the
+ * board resets once the reply to REBOOT is acknowledged
+ *
+ */
+static void FwUpdateTest_Download(void)
+{
+    fwSendStats_t sent;
+    fwUpdateStats_t board;
+    FwUpdateTest_MakeImage(1);
+    FwUpdateTest_Start();
+    CHECK(E_OK == FwSend_Start(FwUpdateTest_image, sizeof(FwUpdateTest_image), 1));
+    CHECK(E_NOT_OK == FwSend_Start(FwUpdateTest_image, sizeof(FwUpdateTest_image), 1));
+    FwUpdateTest_Run(20000, 0xFFFF);
+    FwSend_GetStats(&sent);
+    FwUpdate_GetStats(&board);
+    CHECK(1 == Sim_GetResets());
+    CHECK(FWUPDATE_READY == board.state);
+    CHECK(sent.blocks == board.programmed && sent.acked == sent.blocks);
+    CHECK(0 == sent.resent && 0 == board.dropped && 0 == board.crcErrors);
+    CHECK(0 == memcmp((const void*)FWUPDATE_DOWNLOAD_ADDRESS, FwUpdateTest_image, sizeof(FwUpdateTest_image)));
+    CHECK(FWUPDATE_META_READY == FWUPDATETEST_META[FWUPDATE_META_STATE_INDEX]);
+    /* The board resets once the sender acknowledged the reply */
+    CHECK(FWSEND_DONE == sent.state);
+}
+/**
+ * @brief The boot loader copies the checked image over the application, erases the
+ * state page and jumps to the reset vector of the new image
+ *
+ */
+static void FwUpdateTest_Boot(void)
+{
+    uint32_t erases = FlashSim_GetErases();
+    FwUpdateTest_starts = 0;
+    if(0 == setjmp(FwUpdateTest_jump))
+    {
+        Boot_Run();
+    }
+    CHECK(1 == FwUpdateTest_starts);
+    CHECK(FWUPDATE_APP_ADDRESS == FWUPDATETEST_VTOR);
+    CHECK(0 == memcmp((const void*)FWUPDATE_APP_ADDRESS, FwUpdateTest_image, sizeof(FwUpdateTest_image)));
+    CHECK(0xFFFF == FWUPDATETEST_META[FWUPDATE_META_MAGIC_INDEX]);
+    CHECK(FWUPDATE_SLOT_SIZE / FLASH_PAGE_SIZE + 1 == FlashSim_GetErases() - erases);
+
+    /* Nothing to install the next time, the application is started as it is */
+    FwUpdateTest_starts = 0;
+    if(0 == setjmp(FwUpdateTest_jump))
+    {
+        Boot_Run();
+    }
+    CHECK(1 == FwUpdateTest_starts);
+    CHECK(FWUPDATE_SLOT_SIZE / FLASH_PAGE_SIZE + 1 == FlashSim_GetErases() - erases);
+}
+/**
+ * @brief The board resets in the middle of a download, the sender starts again and
+ * the board goes on from the blocks marked in the state page
+ *
+ */
+static void FwUpdateTest_Resume(void)
+{
+    fwSendStats_t sent;
+    fwUpdateStats_t board;
+    uint16_t acked;
+    FwUpdateTest_MakeImage(2);
+    FwUpdateTest_Start();
+    FwSend_Start(FwUpdateTest_image, sizeof(FwUpdateTest_image), 0);
+    FwUpdateTest_Run(20000, 5);
+    FwSend_GetStats(&sent);
+    acked = sent.acked;
+    CHECK(acked >= 5 && acked < sent.blocks);
+
+    FwUpdateTest_Start();
+    CHECK(E_OK == FwSend_Start(FwUpdateTest_image, sizeof(FwUpdateTest_image), 0));
+    FwUpdateTest_Run(5000, 0xFFFF);
+    FwSend_GetStats(&sent);
+    FwUpdate_GetStats(&board);
+    CHECK(FWSEND_DONE == sent.state);
+    CHECK(0 == Sim_GetResets());
+    /* Only the blocks the board had not marked were sent again */
+    CHECK(board.chunks <= (uint32_t)(FWUPDATETEST_CHUNKS - acked * FWUPDATETEST_BLOCK_CHUNKS));
+    CHECK(0 == memcmp((const void*)FWUPDATE_DOWNLOAD_ADDRESS, FwUpdateTest_image, sizeof(FwUpdateTest_image)));
+}
+/**
+ * @brief A state page that says ready over a slot that does not match is not installed,
+ * the application that is there is started
+ *
+ */
+static void FwUpdateTest_BadSlot(void)
+{
+    uint8_t app[FWUPDATETEST_IMAGE_SIZE];
+    memcpy(app, (const void*)FWUPDATE_APP_ADDRESS, sizeof(app));
+    /* A bit of the slot flips after the image was checked */
+    *(volatile uint8_t*)(FWUPDATE_DOWNLOAD_ADDRESS + 100) ^= 0x01;
+    CHECK(FWUPDATE_META_READY == FWUPDATETEST_META[FWUPDATE_META_STATE_INDEX]);
+    FwUpdateTest_starts = 0;
+    if(0 == setjmp(FwUpdateTest_jump))
+    {
+        Boot_Run();
+    }
+    CHECK(1 == FwUpdateTest_starts);
+    CHECK(0 == memcmp((const void*)FWUPDATE_APP_ADDRESS, app, sizeof(app)));
+}
+
+int main(void)
+{
+    if(E_OK != Sim_Init())
+    {
+        printf("FwUpdateTest: the simulated memory could not be mapped\n");
+        return 1;
+    }
+    FlashSim_Init();
+    FwUpdateTest_Download();
+    Sim_Init();
+    FlashSim_Init();
+    FwUpdateTest_Boot();
+    Sim_Init();
+    FlashSim_Init();
+    FwUpdateTest_Resume();
+    FwUpdateTest_BadSlot();
+    return CHECK_RESULT("FwUpdateTest");
+}
@@ -0,0 +1,251 @@
+/**
+ * @file GCounterTest.c
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief These are the host tests of the replicated counter, two instances of GCounter.c
+ * are built with their symbols renamed (A_ as node 0 and B_ as node 1) and the messages
+ * one builds are merged by the other like the link would deliver them
+ * @version 0.1
+ * @date 2020-04-24
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include "Std_Types.h"
+#include "CounterCodec_Cfg.h"
+#include "CounterCodec.h"
+#include "Check.h"
+
+#define GCOUNTERTEST_BUFFER_SIZE    64
+#define GCOUNTERTEST_NODE_A         0
+#define GCOUNTERTEST_NODE_B         1
+
+#define GCOUNTERTEST_DECLARE(P)                                                                             \
+    extern Std_ReturnType P##_GCounter_Init(void);                                                          \
+    extern Std_ReturnType P##_GCounter_Increment(void);                                                     \
+    extern Std_ReturnType P##_GCounter_BuildDelta(uint8_t* buffer, uint16_t bufferSize, uint16_t* length,   \
+                                                  uint32_t* sentMask);                                      \
+    extern Std_ReturnType P##_GCounter_CommitDelta(uint32_t sentMask);                                      \
+    extern Std_ReturnType P##_GCounter_BuildSync(uint8_t* buffer, uint16_t bufferSize, uint16_t* length,    \
+                                                 uint32_t* sentMask);                                       \
+    extern Std_ReturnType P##_GCounter_CommitSync(uint32_t sentMask);                                       \
+    extern Std_ReturnType P##_GCounter_MergeDelta(const uint8_t* data, uint16_t length, uint8_t* changed);  \
+    extern Std_ReturnType P##_GCounter_MergeSync(const uint8_t* data, uint16_t length, uint8_t* changed);   \
+    extern Std_ReturnType P##_GCounter_GetTotal(uint32_t* total);                                           \
+    extern Std_ReturnType P##_GCounter_GetSlot(uint8_t node, uint32_t* value);
+
+GCOUNTERTEST_DECLARE(A)
+GCOUNTERTEST_DECLARE(B)
+
+static uint8_t GCounterTest_buffer[GCOUNTERTEST_BUFFER_SIZE];
+static uint16_t GCounterTest_length;
+static uint32_t GCounterTest_mask;
+
+/**
+ * @brief Increments the slot of A a number of times
+ *
+ * @param count the number of presses
+ */
+static void GCounterTest_Press(uint32_t count)
+{
+    while(count--)
+    {
+        A_GCounter_Increment();
+    }
+}
+/**
+ * @brief Builds the next delta message of A and commits it like a link that took it
+ *
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the message was built
+ *                  E_NOT_OK: If it was not
+ */
+static Std_ReturnType GCounterTest_SendDelta(void)
+{
+    Std_ReturnType error;
+    error = A_GCounter_BuildDelta(GCounterTest_buffer, sizeof(GCounterTest_buffer), &GCounterTest_length, &GCounterTest_mask);
+    if(error == E_OK)
+    {
+        A_GCounter_CommitDelta(GCounterTest_mask);
+    }
+    return error;
+}
+/**
+ * @brief Gets the slot of A as B sees it
+ *
+ * @return uint32_t the slot
+ */
+static uint32_t GCounterTest_SlotAtB(void)
+{
+    uint32_t value = 0;
+    B_GCounter_GetSlot(GCOUNTERTEST_NODE_A, &value);
+    return value;
+}
+
+/**
+ * @brief The first update of a slot is a snapshot and the next ones are short deltas
+ * that B adds to it, a snapshot still comes once every period
+ *
+ */
+static void GCounterTest_Deltas(void)
+{
+    uint8_t changed = 0;
+    uint32_t i;
+    uint32_t longest = 0;
+    A_GCounter_Init();
+    B_GCounter_Init();
+
+    GCounterTest_Press(1000);
+    CHECK(E_OK == GCounterTest_SendDelta());
+    CHECK(GCOUNTERTEST_NODE_A == GCounterTest_buffer[0]);
+    CHECK(GCounterTest_length > 2);
+    CHECK(E_OK == B_GCounter_MergeDelta(GCounterTest_buffer, GCounterTest_length, &changed));
+    CHECK(changed && 1000 == GCounterTest_SlotAtB());
+
+    /* Nothing changed, nothing to send */
+    CHECK(E_OK == GCounterTest_SendDelta());
+    CHECK(0 == GCounterTest_length && 0 == GCounterTest_mask);
+
+    /* The node number and one byte of delta, far less than the whole value */
+    GCounterTest_Press(3);
+    CHECK(E_OK == GCounterTest_SendDelta());
+    CHECK(2 == GCounterTest_length);
+    CHECK(E_OK == B_GCounter_MergeDelta(GCounterTest_buffer, GCounterTest_length, &changed));
+    CHECK(1003 == GCounterTest_SlotAtB());
+
+    for(i = 0; i < 3 * COUNTER_CODEC_SNAPSHOT_PERIOD; i++)
+    {
+        GCounterTest_Press(1);
+        GCounterTest_SendDelta();
+        longest = GCounterTest_length > longest ? GCounterTest_length : longest;
+        B_GCounter_MergeDelta(GCounterTest_buffer, GCounterTest_length, &changed);
+    }
+    CHECK(longest > 2);
+    CHECK(1003 + 3 * COUNTER_CODEC_SNAPSHOT_PERIOD == GCounterTest_SlotAtB());
+}
+/**
+ * @brief A message the link refused is built again the same, and a press that comes
+ * between building and committing a message is sent with the next one
+ *
+ */
+static void GCounterTest_Pending(void)
+{
+    uint8_t changed = 0;
+    uint8_t first[GCOUNTERTEST_BUFFER_SIZE];
+    uint16_t firstLength;
+    uint16_t i;
+    A_GCounter_Init();
+    B_GCounter_Init();
+    GCounterTest_Press(5);
+    CHECK(E_OK == GCounterTest_SendDelta());
+    B_GCounter_MergeDelta(GCounterTest_buffer, GCounterTest_length, &changed);
+
+    GCounterTest_Press(2);
+    A_GCounter_BuildDelta(first, sizeof(first), &firstLength, &GCounterTest_mask);
+    A_GCounter_BuildDelta(GCounterTest_buffer, sizeof(GCounterTest_buffer), &GCounterTest_length, &GCounterTest_mask);
+    CHECK(firstLength == GCounterTest_length);
+    for(i = 0; i < firstLength && i < GCounterTest_length; i++)
+    {
+        CHECK(first[i] == GCounterTest_buffer[i]);
+    }
+
+    GCounterTest_Press(1);
+    A_GCounter_CommitDelta(GCounterTest_mask);
+    B_GCounter_MergeDelta(GCounterTest_buffer, GCounterTest_length, &changed);
+    CHECK(7 == GCounterTest_SlotAtB());
+    CHECK(E_OK == GCounterTest_SendDelta());
+    CHECK(GCounterTest_length > 0);
+    B_GCounter_MergeDelta(GCounterTest_buffer, GCounterTest_length, &changed);
+    CHECK(8 == GCounterTest_SlotAtB());
+}
+/**
+ * @brief B starts again and loses the base of the deltas, it skips them until
+ * the anti-entropy message restarts the stream
+ *
+ */
+static void GCounterTest_Resync(void)
+{
+    uint8_t changed = 0;
+    A_GCounter_Init();
+    B_GCounter_Init();
+    GCounterTest_Press(40);
+    GCounterTest_SendDelta();
+    B_GCounter_MergeDelta(GCounterTest_buffer, GCounterTest_length, &changed);
+    CHECK(40 == GCounterTest_SlotAtB());
+
+    B_GCounter_Init();
+    GCounterTest_Press(1);
+    GCounterTest_SendDelta();
+    CHECK(E_OK == B_GCounter_MergeDelta(GCounterTest_buffer, GCounterTest_length, &changed));
+    CHECK(!changed && 0 == GCounterTest_SlotAtB());
+
+    CHECK(E_OK == A_GCounter_BuildSync(GCounterTest_buffer, sizeof(GCounterTest_buffer), &GCounterTest_length, &GCounterTest_mask));
+    CHECK(GCounterTest_mask == (1u << GCOUNTERTEST_NODE_A));
+    A_GCounter_CommitSync(GCounterTest_mask);
+    CHECK(E_OK == B_GCounter_MergeSync(GCounterTest_buffer, GCounterTest_length, &changed));
+    CHECK(changed && 41 == GCounterTest_SlotAtB());
+
+    /* The deltas after the sync are taken from the value in it */
+    GCounterTest_Press(2);
+    GCounterTest_SendDelta();
+    CHECK(2 == GCounterTest_length);
+    B_GCounter_MergeDelta(GCounterTest_buffer, GCounterTest_length, &changed);
+    CHECK(43 == GCounterTest_SlotAtB());
+}
+/**
+ * @brief A slot raised by a merge goes out with the next delta message of the node
+ * that merged it, so an update reaches the nodes past it
+ *
+ */
+static void GCounterTest_Relay(void)
+{
+    uint8_t changed = 0;
+    uint32_t value = 0;
+    A_GCounter_Init();
+    B_GCounter_Init();
+    GCounterTest_Press(9);
+    GCounterTest_SendDelta();
+    B_GCounter_MergeDelta(GCounterTest_buffer, GCounterTest_length, &changed);
+    CHECK(changed);
+
+    CHECK(E_OK == B_GCounter_BuildDelta(GCounterTest_buffer, sizeof(GCounterTest_buffer), &GCounterTest_length, &GCounterTest_mask));
+    CHECK(GCounterTest_mask == (1u << GCOUNTERTEST_NODE_A));
+    B_GCounter_CommitDelta(GCounterTest_mask);
+    /* A already has its own slot, the relay changes nothing there and stops */
+    CHECK(E_OK == A_GCounter_MergeDelta(GCounterTest_buffer, GCounterTest_length, &changed));
+    CHECK(!changed);
+    A_GCounter_GetSlot(GCOUNTERTEST_NODE_A, &value);
+    CHECK(9 == value);
+    CHECK(E_OK == A_GCounter_BuildDelta(GCounterTest_buffer, sizeof(GCounterTest_buffer), &GCounterTest_length, &GCounterTest_mask));
+    CHECK(0 == GCounterTest_mask);
+    CHECK(E_OK == B_GCounter_BuildDelta(GCounterTest_buffer, sizeof(GCounterTest_buffer), &GCounterTest_length, &GCounterTest_mask));
+    CHECK(0 == GCounterTest_mask);
+}
+/**
+ * @brief A node number out of range or a cut record stops the merge
+ *
+ */
+static void GCounterTest_Corrupted(void)
+{
+    uint8_t changed = 0;
+    uint8_t badNode[] = {0xF0, 0x02};
+    uint32_t total = 0;
+    A_GCounter_Init();
+    B_GCounter_Init();
+    CHECK(E_NOT_OK == B_GCounter_MergeDelta(badNode, sizeof(badNode), &changed));
+    CHECK(E_NOT_OK == B_GCounter_MergeSync(badNode, sizeof(badNode), &changed));
+    GCounterTest_Press(1000);
+    GCounterTest_SendDelta();
+    CHECK(E_NOT_OK == B_GCounter_MergeDelta(GCounterTest_buffer, GCounterTest_length - 1, &changed));
+    B_GCounter_GetTotal(&total);
+    CHECK(0 == total);
+}
+
+int main(void)
+{
+    GCounterTest_Deltas();
+    GCounterTest_Pending();
+    GCounterTest_Resync();
+    GCounterTest_Relay();
+    GCounterTest_Corrupted();
+    return CHECK_RESULT("GCounterTest");
+}
@@ -0,0 +1,454 @@
+/**
+ * @file LinkTest.c
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief These are the host tests of the link layer, two instances of Link.c are built
+ * with their symbols renamed (A_ and B_) and talk over an in-memory wire that can be
+ * slowed down, cut or made to lose frames
+ * *Every message is a 32-bit counter of its sender so the receiver sees any loss,
+ * duplicate or reordering
+ * @version 0.1
+ * @date 2020-04-24
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include <string.h>
+#include "Std_Types.h"
+#include "Link_Cfg.h"
+#include "Link.h"
+#include "Sim.h"
+#include "Check.h"
+
+#define LINKTEST_WIRE_SIZE          512
+/* About 115200 baud */
+#define LINKTEST_BYTES_PER_MS       11
+
+#define LINKTEST_DECLARE(P)                                                         \
+    extern Std_ReturnType P##_Link_Init(void);                                      \
+    extern Std_ReturnType P##_Link_Send(const uint8_t* data, uint16_t length);      \
+    extern Std_ReturnType P##_Link_SetRxCb(linkRxCb_t func);                        \
+    extern Std_ReturnType P##_Link_GetStats(linkStats_t* stats);                    \
+    extern Std_ReturnType P##_Link_GetPending(uint8_t* pending);                    \
+    extern void P##_Link_Task(void);
+
+LINKTEST_DECLARE(A)
+LINKTEST_DECLARE(B)
+
+typedef struct
+{
+    uint8_t data[LINKTEST_WIRE_SIZE];
+    /* Bytes from head to arrived can be read, the ones up to tail are on their way */
+    uint16_t head;
+    uint16_t arrived;
+    uint16_t tail;
+    uint32_t frames;
+    /* Every dropEvery-th frame is lost, 0 loses none */
+    uint16_t dropEvery;
+    /* Every frame is lost while the wire is cut */
+    uint8_t cut;
+}linkTestWire_t;
+
+typedef struct
+{
+    /* The next counter to send and the next one expected from the peer */
+    uint32_t sent;
+    uint32_t expected;
+    uint32_t received;
+    /* Messages that were not the expected counter */
+    uint32_t bad;
+    /* The next message may start anywhere, the peer started again */
+    uint8_t resync;
+    uint8_t sending;
+}linkTestSide_t;
+
+static linkTestWire_t LinkTest_wireAB;
+static linkTestWire_t LinkTest_wireBA;
+static linkTestSide_t LinkTest_a;
+static linkTestSide_t LinkTest_b;
+static uint8_t LinkTest_bRunning;
+/* The period of the task of A in milli seconds, like SCHED_setPeriod would change it */
+static uint32_t LinkTest_aPeriod;
+
+/**
+ * @brief Puts a frame on a wire or loses it
+ *
+ * @param wire the wire
+ * @param data the frame
+ * @param length the length of the frame
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the frame is on the wire or lost on it
+ *                  E_NOT_OK: If the wire is full, like a busy transport
+ */
+static Std_ReturnType LinkTest_WireSend(linkTestWire_t* wire, const uint8_t* data, uint16_t length)
+{
+    if(wire->tail + length > LINKTEST_WIRE_SIZE)
+    {
+        return E_NOT_OK;
+    }
+    wire->frames++;
+    if(!wire->cut && !(wire->dropEvery && 0 == wire->frames % wire->dropEvery))
+    {
+        memcpy(&wire->data[wire->tail], data, length);
+        wire->tail += length;
+    }
+    return E_OK;
+}
+/**
+ * @brief Reads the bytes that arrived at the end of a wire
+ *
+ * @param wire the wire
+ * @param data where to put the bytes
+ * @param maxLength the size of data
+ * @param count the number of bytes read
+ */
+static void LinkTest_WireRead(linkTestWire_t* wire, uint8_t* data, uint16_t maxLength, uint16_t* count)
+{
+    uint16_t n = wire->arrived - wire->head;
+    if(n > maxLength)
+    {
+        n = maxLength;
+    }
+    memcpy(data, &wire->data[wire->head], n);
+    wire->head += n;
+    if(wire->head == wire->tail)
+    {
+        wire->head = 0;
+        wire->arrived = 0;
+        wire->tail = 0;
+    }
+    *count = n;
+}
+/**
+ * @brief Moves the bytes of a wire on by one milli second
+ *
+ * @param wire the wire
+ */
+static void LinkTest_WireTick(linkTestWire_t* wire)
+{
+    uint16_t n = wire->tail - wire->arrived;
+    wire->arrived += (n > LINKTEST_BYTES_PER_MS) ? LINKTEST_BYTES_PER_MS : n;
+}
+
+Std_ReturnType A_Transport_Send(const uint8_t* data, uint16_t length)
+{
+    return LinkTest_WireSend(&LinkTest_wireAB, data, length);
+}
+Std_ReturnType B_Transport_Send(const uint8_t* data, uint16_t length)
+{
+    return LinkTest_WireSend(&LinkTest_wireBA, data, length);
+}
+Std_ReturnType A_Transport_Read(uint8_t* data, uint16_t maxLength, uint16_t* count)
+{
+    LinkTest_WireRead(&LinkTest_wireBA, data, maxLength, count);
+    return E_OK;
+}
+Std_ReturnType B_Transport_Read(uint8_t* data, uint16_t maxLength, uint16_t* count)
+{
+    LinkTest_WireRead(&LinkTest_wireAB, data, maxLength, count);
+    return E_OK;
+}
+
+/**
+ * @brief Checks a message against the counter expected from the peer
+ *
+ * @param side the receiving side
+ * @param data the message
+ * @param length the length of the message
+ */
+static void LinkTest_Receive(linkTestSide_t* side, const uint8_t* data, uint16_t length)
+{
+    uint32_t value = 0;
+    if(sizeof(value) == length)
+    {
+        memcpy(&value, data, sizeof(value));
+    }
+    if(value != side->expected && !side->resync)
+    {
+        side->bad++;
+    }
+    side->resync = 0;
+    side->expected = value + 1;
+    side->received++;
+}
+static void LinkTest_ReceiveA(const uint8_t* data, uint16_t length)
+{
+    LinkTest_Receive(&LinkTest_a, data, length);
+}
+static void LinkTest_ReceiveB(const uint8_t* data, uint16_t length)
+{
+    LinkTest_Receive(&LinkTest_b, data, length);
+}
+
+/**
+ * @brief Starts both sides and both wires from scratch
+ *
+ */
+static void LinkTest_Start(void)
+{
+    memset(&LinkTest_wireAB, 0, sizeof(LinkTest_wireAB));
+    memset(&LinkTest_wireBA, 0, sizeof(LinkTest_wireBA));
+    memset(&LinkTest_a, 0, sizeof(LinkTest_a));
+    memset(&LinkTest_b, 0, sizeof(LinkTest_b));
+    A_Link_Init();
+    B_Link_Init();
+    A_Link_SetRxCb(LinkTest_ReceiveA);
+    B_Link_SetRxCb(LinkTest_ReceiveB);
+    LinkTest_bRunning = 1;
+    LinkTest_aPeriod = 1;
+}
+/**
+ * @brief Runs both sides for some milli seconds, a side that is sending offers
+ * a new message every milli second
+ *
+ * @param ms the time to run
+ */
+static void LinkTest_Run(uint32_t ms)
+{
+    while(ms--)
+    {
+        Sim_SetNanos(Sim_GetNanos() + SIM_NS_PER_MS);
+        LinkTest_WireTick(&LinkTest_wireAB);
+        LinkTest_WireTick(&LinkTest_wireBA);
+        if(LinkTest_a.sending && E_OK == A_Link_Send((const uint8_t*)&LinkTest_a.sent, sizeof(LinkTest_a.sent)))
+        {
+            LinkTest_a.sent++;
+        }
+        if(0 == (Sim_GetNanos() / SIM_NS_PER_MS) % LinkTest_aPeriod)
+        {
+            A_Link_Task();
+        }
+        if(LinkTest_bRunning)
+        {
+            if(LinkTest_b.sending && E_OK == B_Link_Send((const uint8_t*)&LinkTest_b.sent, sizeof(LinkTest_b.sent)))
+            {
+                LinkTest_b.sent++;
+            }
+            B_Link_Task();
+        }
+    }
+}
+/**
+ * @brief Stops sending and runs until both windows are empty
+ *
+ * @param ms the longest time to run
+ */
+static void LinkTest_Drain(uint32_t ms)
+{
+    uint8_t pendingA = 1;
+    uint8_t pendingB = 1;
+    LinkTest_a.sending = 0;
+    LinkTest_b.sending = 0;
+    while(ms-- && (pendingA || pendingB))
+    {
+        LinkTest_Run(1);
+        A_Link_GetPending(&pendingA);
+        B_Link_GetPending(&pendingB);
+    }
+}
+
+/**
+ * @brief Both sides start together, then one starts long after the other with
+ * messages waiting for it
+ *
+ */
+static void LinkTest_Handshake(void)
+{
+    linkStats_t a;
+    linkStats_t b;
+    LinkTest_Start();
+    /* The decoders drop what comes before their first delimiter, so the first
+       SYN is lost and the session starts with the one sent again */
+    LinkTest_Run(LINK_INITIAL_RTO_MS + 20);
+    A_Link_GetStats(&a);
+    B_Link_GetStats(&b);
+    CHECK(a.framesReceived > 0 && b.framesReceived > 0);
+    CHECK(0 == a.restarts && 0 == b.restarts);
+    LinkTest_a.sending = 1;
+    LinkTest_b.sending = 1;
+    LinkTest_Run(500);
+    LinkTest_Drain(1000);
+    CHECK(LinkTest_a.sent > 100 && LinkTest_b.sent > 100);
+    CHECK(LinkTest_b.received == LinkTest_a.sent && LinkTest_a.received == LinkTest_b.sent);
+    CHECK(0 == LinkTest_a.bad && 0 == LinkTest_b.bad);
+
+    /* B is off while A fills its window, nothing goes out before B answers */
+    LinkTest_Start();
+    LinkTest_bRunning = 0;
+    LinkTest_a.sending = 1;
+    LinkTest_Run(1000);
+    CHECK(LINK_WINDOW_SIZE == LinkTest_a.sent);
+    LinkTest_wireAB.head = LinkTest_wireAB.arrived = LinkTest_wireAB.tail = 0;
+    LinkTest_bRunning = 1;
+    LinkTest_Run(500);
+    LinkTest_Drain(1000);
+    CHECK(LinkTest_b.received == LinkTest_a.sent);
+    CHECK(0 == LinkTest_b.bad);
+}
+/**
+ * @brief Frames are lost in both directions, the sender goes back to the oldest
+ * message not acked and the receiver drops what comes after a gap
+ *
+ */
+static void LinkTest_GoBackN(void)
+{
+    linkStats_t a;
+    linkStats_t b;
+    LinkTest_Start();
+    LinkTest_wireAB.dropEvery = 7;
+    LinkTest_wireBA.dropEvery = 11;
+    LinkTest_a.sending = 1;
+    LinkTest_b.sending = 1;
+    LinkTest_Run(3000);
+    LinkTest_wireAB.dropEvery = 0;
+    LinkTest_wireBA.dropEvery = 0;
+    LinkTest_Drain(5000);
+    A_Link_GetStats(&a);
+    B_Link_GetStats(&b);
+    /* Every loss costs an RTO, the sequence numbers still go round the window many times */
+    CHECK(LinkTest_a.sent > 2 * LINK_WINDOW_SIZE && LinkTest_b.sent > 2 * LINK_WINDOW_SIZE);
+    CHECK(LinkTest_b.received == LinkTest_a.sent && LinkTest_a.received == LinkTest_b.sent);
+    CHECK(0 == LinkTest_a.bad && 0 == LinkTest_b.bad);
+    CHECK(a.timeouts > 0 && a.retransmits > 0);
+    CHECK(b.outOfOrder > 0);
+    CHECK(a.delivered == LinkTest_b.sent && b.delivered == LinkTest_a.sent);
+}
+/**
+ * @brief The retransmission timeout follows the measured RTT, backs off while
+ * the wire is cut and comes back down after it is fixed
+ *
+ */
+static void LinkTest_Rto(void)
+{
+    linkStats_t a;
+    uint32_t ms;
+    uint32_t timeouts = 0;
+    uint32_t lastTimeout = 0;
+    uint16_t rto;
+    uint8_t pending;
+    LinkTest_Start();
+    LinkTest_a.sending = 1;
+    LinkTest_Run(500);
+    LinkTest_Drain(1000);
+    A_Link_GetStats(&a);
+    CHECK(a.rttSamples > 0);
+    CHECK(a.rtoMs >= LINK_MIN_RTO_MS && a.rtoMs < LINK_INITIAL_RTO_MS);
+    CHECK(a.srttMs >= a.rttMinMs && a.srttMs <= a.rttMaxMs);
+    rto = a.rtoMs;
+
+    /* One message on a cut wire, every timeout doubles the next one */
+    LinkTest_wireAB.cut = 1;
+    A_Link_Send((const uint8_t*)&LinkTest_a.sent, sizeof(LinkTest_a.sent));
+    LinkTest_a.sent++;
+    for(ms=1; ms<=6000; ms++)
+    {
+        LinkTest_Run(1);
+        A_Link_GetStats(&a);
+        if(a.timeouts != timeouts)
+        {
+            CHECK(ms - lastTimeout >= rto);
+            CHECK(ms - lastTimeout <= rto + LINK_TASK_PERIOD_MS);
+            lastTimeout = ms;
+            timeouts = a.timeouts;
+            rto = (rto << 1) > LINK_MAX_RTO_MS ? LINK_MAX_RTO_MS : (rto << 1);
+            CHECK(a.rtoMs == rto);
+        }
+    }
+    CHECK(timeouts >= 4);
+    CHECK(LINK_MAX_RTO_MS == a.rtoMs);
+    CHECK(0 == LinkTest_b.received - (LinkTest_a.sent - 1));
+
+    /* A retransmitted message gives no sample, the next new one brings the RTO down */
+    LinkTest_wireAB.cut = 0;
+    LinkTest_Run(LINK_MAX_RTO_MS + 100);
+    A_Link_GetPending(&pending);
+    CHECK(0 == pending);
+    CHECK(LinkTest_b.received == LinkTest_a.sent);
+    LinkTest_a.sending = 1;
+    LinkTest_Run(100);
+    LinkTest_Drain(1000);
+    A_Link_GetStats(&a);
+    CHECK(a.rtoMs < LINK_INITIAL_RTO_MS);
+    CHECK(0 == LinkTest_b.bad);
+}
+/**
+ * @brief B starts again in the middle of a transfer, both sides start a new
+ * session and the traffic goes on
+ *
+ */
+static void LinkTest_PeerRestart(void)
+{
+    linkStats_t a;
+    uint32_t received;
+    LinkTest_Start();
+    LinkTest_a.sending = 1;
+    LinkTest_b.sending = 1;
+    LinkTest_Run(1000);
+    B_Link_Init();
+    /* B counts from 0 again and the messages A had in flight for the old B are dropped */
+    LinkTest_b.sent = 0;
+    LinkTest_a.expected = 0;
+    LinkTest_b.resync = 1;
+    received = LinkTest_a.received;
+    LinkTest_Run(1000);
+    LinkTest_Drain(1000);
+    A_Link_GetStats(&a);
+    CHECK(1 == a.restarts);
+    CHECK(LinkTest_a.received - received == LinkTest_b.sent);
+    CHECK(LinkTest_a.received - received > 100);
+    CHECK(0 == LinkTest_a.bad && 0 == LinkTest_b.bad);
+}
+
+/**
+ * @brief The task of A runs less often, the link keeps its time on the SysTick so the
+ * timeouts stay in milli seconds and are only seen up to one period late
+ *
+ */
+static void LinkTest_SlowTask(void)
+{
+    linkStats_t a;
+    uint32_t ms;
+    uint32_t timeouts = 0;
+    uint32_t lastTimeout = 0;
+    uint16_t rto = LINK_INITIAL_RTO_MS;
+    LinkTest_Start();
+    LinkTest_aPeriod = 5;
+    LinkTest_Run(LINK_INITIAL_RTO_MS + 20);
+    LinkTest_a.sending = 1;
+    LinkTest_Run(500);
+    LinkTest_Drain(1000);
+    CHECK(LinkTest_b.received == LinkTest_a.sent && LinkTest_a.sent > 0);
+    A_Link_GetStats(&a);
+    rto = a.rtoMs;
+
+    LinkTest_wireAB.cut = 1;
+    A_Link_Send((const uint8_t*)&LinkTest_a.sent, sizeof(LinkTest_a.sent));
+    LinkTest_a.sent++;
+    for(ms=1; ms<=3000; ms++)
+    {
+        LinkTest_Run(1);
+        A_Link_GetStats(&a);
+        if(a.timeouts != timeouts)
+        {
+            CHECK(ms - lastTimeout >= rto);
+            CHECK(ms - lastTimeout <= rto + LinkTest_aPeriod);
+            lastTimeout = ms;
+            timeouts = a.timeouts;
+            rto = (rto << 1) > LINK_MAX_RTO_MS ? LINK_MAX_RTO_MS : (rto << 1);
+        }
+    }
+    CHECK(timeouts >= 3);
+    LinkTest_wireAB.cut = 0;
+    LinkTest_Drain(LINK_MAX_RTO_MS + 1000);
+    CHECK(LinkTest_b.received == LinkTest_a.sent);
+    CHECK(0 == LinkTest_b.bad);
+}
+
+int main(void)
+{
+    LinkTest_Handshake();
+    LinkTest_GoBackN();
+    LinkTest_Rto();
+    LinkTest_PeerRestart();
+    LinkTest_SlowTask();
+    return CHECK_RESULT("LinkTest");
+}
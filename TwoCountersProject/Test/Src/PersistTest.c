@@ -0,0 +1,311 @@
+/**
+ * @file PersistTest.c
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief These are the host tests of the counter persistence, the log is written through
+ * the flash driver over the simulated flash controller and the board is started again
+ * over the same flash, also after a power cut in the middle of a record or a page header
+ * @version 0.1
+ * @date 2020-04-24
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include <string.h>
+#include "Std_Types.h"
+#include "GCounter_Cfg.h"
+#include "GCounter.h"
+#include "Flash_Cfg.h"
+#include "Flash.h"
+#include "Persist_Cfg.h"
+#include "Persist.h"
+#include "Sim.h"
+#include "FlashSim.h"
+#include "Check.h"
+
+#define PERSISTTEST_NODE            GCOUNTER_NODE_ID
+#define PERSISTTEST_REMOTE          (GCOUNTER_NODE_ID ^ 1)
+/* Long enough for the interval between two records and the flash jobs after it */
+#define PERSISTTEST_RECORD_MS       (PERSIST_MIN_INTERVAL_MS + 10 * PERSIST_TASK_PERIOD_MS)
+#define PERSISTTEST_MAGIC           0x5350
+
+#define PERSISTTEST_PAGE(page)      ((const volatile uint16_t*)(PERSIST_FIRST_PAGE + (uint32_t)(page) * FLASH_PAGE_SIZE))
+
+/**
+ * @brief Erases the pages of the log like on a new part
+ *
+ */
+static void PersistTest_Erase(void)
+{
+    memset((void*)(uintptr_t)PERSIST_FIRST_PAGE, 0xFF, (uint32_t)PERSIST_PAGES * FLASH_PAGE_SIZE);
+}
+/**
+ * @brief Starts the board again over the same flash, the flash job that was running
+ * is ended first like the power going down would end it
+ *
+ */
+static void PersistTest_Start(void)
+{
+    uint8_t busy = 1;
+    while(busy)
+    {
+        Flash_Task();
+        Flash_IsBusy(&busy);
+    }
+    FlashSim_PowerUp();
+    GCounter_Init();
+    Persist_Init();
+}
+/**
+ * @brief Runs the flash every milli second and the persistence every period
+ *
+ * @param ms the time to run
+ */
+static void PersistTest_Run(uint32_t ms)
+{
+    while(ms--)
+    {
+        Sim_SetNanos(Sim_GetNanos() + SIM_NS_PER_MS);
+        Flash_Task();
+        if(0 == (Sim_GetNanos() / SIM_NS_PER_MS) % PERSIST_TASK_PERIOD_MS)
+        {
+            Persist_Task();
+        }
+    }
+}
+/**
+ * @brief Runs until a flash job is running
+ *
+ * @param ms the longest time to run
+ * @return uint8_t 1 if a job started and 0 if not
+ */
+static uint8_t PersistTest_RunUntilBusy(uint32_t ms)
+{
+    uint8_t busy = 0;
+    Flash_IsBusy(&busy);
+    while(ms-- && !busy)
+    {
+        PersistTest_Run(1);
+        Flash_IsBusy(&busy);
+    }
+    return busy;
+}
+/**
+ * @brief Presses the switch of this node
+ *
+ * @param count the number of presses
+ */
+static void PersistTest_Press(uint32_t count)
+{
+    while(count--)
+    {
+        GCounter_Increment();
+    }
+}
+/**
+ * @brief Gets a slot of the counter
+ *
+ * @param node the node of the slot
+ * @return uint32_t the slot
+ */
+static uint32_t PersistTest_Slot(uint8_t node)
+{
+    uint32_t value = 0;
+    GCounter_GetSlot(node, &value);
+    return value;
+}
+/**
+ * @brief Gets the stats of the log
+ *
+ * @return persistStats_t the stats
+ */
+static persistStats_t PersistTest_Stats(void)
+{
+    persistStats_t stats;
+    Persist_GetStats(&stats);
+    return stats;
+}
+/**
+ * @brief Presses once every record interval until the log starts a new page, it stops
+ * once the page is erased and the job of its header started, before it runs
+ *
+ * @return uint8_t 1 if the new page was started and 0 if not
+ */
+static uint8_t PersistTest_FillPage(void)
+{
+    uint32_t erases = PersistTest_Stats().erases;
+    uint32_t ms;
+    for(ms = 0; erases == PersistTest_Stats().erases && ms < 1000 * PERSISTTEST_RECORD_MS; ms++)
+    {
+        if(0 == ms % PERSISTTEST_RECORD_MS)
+        {
+            PersistTest_Press(1);
+        }
+        PersistTest_Run(1);
+    }
+    return erases != PersistTest_Stats().erases;
+}
+
+/**
+ * @brief The slots are written after the interval and merged back at start up, the
+ * presses within one interval go in one record
+ *
+ */
+static void PersistTest_Restore(void)
+{
+    const uint8_t remote[] = {PERSISTTEST_REMOTE, 0xAC, 0x02};
+    uint8_t changed = 0;
+    PersistTest_Erase();
+    PersistTest_Start();
+    CHECK(0 == PersistTest_Stats().restored);
+
+    PersistTest_Press(5);
+    GCounter_Merge(remote, sizeof(remote), &changed);
+    PersistTest_Run(PERSIST_MIN_INTERVAL_MS - 2 * PERSIST_TASK_PERIOD_MS);
+    CHECK(0 == PersistTest_Stats().records);
+    PersistTest_Run(10 * PERSIST_TASK_PERIOD_MS);
+    CHECK(1 == PersistTest_Stats().records);
+    CHECK(1 == PersistTest_Stats().sequence && 1 == PersistTest_Stats().erases);
+    CHECK(PERSISTTEST_MAGIC == PERSISTTEST_PAGE(0)[2]);
+
+    PersistTest_Press(1);
+    PersistTest_Run(PERSIST_TASK_PERIOD_MS);
+    PersistTest_Press(2);
+    PersistTest_Run(PERSISTTEST_RECORD_MS);
+    CHECK(2 == PersistTest_Stats().records);
+    /* Nothing changed, nothing written */
+    PersistTest_Run(2 * PERSISTTEST_RECORD_MS);
+    CHECK(2 == PersistTest_Stats().records);
+
+    PersistTest_Start();
+    CHECK(1 == PersistTest_Stats().restored);
+    CHECK(8 == PersistTest_Slot(PERSISTTEST_NODE));
+    CHECK(300 == PersistTest_Slot(PERSISTTEST_REMOTE));
+    /* The next record goes on in the same page */
+    PersistTest_Press(1);
+    PersistTest_Run(PERSISTTEST_RECORD_MS);
+    CHECK(1 == PersistTest_Stats().sequence && 0 == PersistTest_Stats().erases);
+    PersistTest_Start();
+    CHECK(9 == PersistTest_Slot(PERSISTTEST_NODE));
+}
+/**
+ * @brief Full pages are followed by the next one in turn with the next sequence number,
+ * the first page is used again after the last one
+ *
+ */
+static void PersistTest_Rotation(void)
+{
+    uint32_t erases = FlashSim_GetErases();
+    uint32_t saved;
+    uint8_t page;
+    PersistTest_Erase();
+    PersistTest_Start();
+    PersistTest_Press(1);
+    PersistTest_Run(PERSISTTEST_RECORD_MS);
+    for(page = 0; page < PERSIST_PAGES; page++)
+    {
+        CHECK(PersistTest_FillPage());
+    }
+    PersistTest_Run(PERSISTTEST_RECORD_MS);
+    CHECK(PERSIST_PAGES + 1 == PersistTest_Stats().sequence);
+    CHECK(PERSIST_PAGES + 1 == FlashSim_GetErases() - erases);
+    CHECK(PERSIST_PAGES + 1 == PERSISTTEST_PAGE(0)[0] && PERSISTTEST_MAGIC == PERSISTTEST_PAGE(0)[2]);
+    for(page = 1; page < PERSIST_PAGES; page++)
+    {
+        CHECK(page + 1 == PERSISTTEST_PAGE(page)[0]);
+    }
+
+    PersistTest_Press(1);
+    PersistTest_Run(PERSISTTEST_RECORD_MS);
+    saved = PersistTest_Slot(PERSISTTEST_NODE);
+    PersistTest_Start();
+    CHECK(PERSIST_PAGES + 1 == PersistTest_Stats().sequence);
+    CHECK(saved == PersistTest_Slot(PERSISTTEST_NODE));
+}
+/**
+ * @brief A record cut by the power fails its CRC and the one before it is restored,
+ * the next record goes after the cut one
+ *
+ */
+static void PersistTest_CutRecord(void)
+{
+    PersistTest_Erase();
+    PersistTest_Start();
+    PersistTest_Press(20);
+    PersistTest_Run(PERSISTTEST_RECORD_MS);
+    CHECK(1 == PersistTest_Stats().records);
+
+    PersistTest_Press(1);
+    CHECK(PersistTest_RunUntilBusy(PERSISTTEST_RECORD_MS));
+    /* One run programs the length and the slots but not the CRC */
+    FlashSim_CutAfter(1);
+    PersistTest_Run(PERSIST_TASK_PERIOD_MS);
+    CHECK(FlashSim_IsCut());
+    PersistTest_Start();
+    CHECK(1 == PersistTest_Stats().restored);
+    CHECK(20 == PersistTest_Slot(PERSISTTEST_NODE));
+
+    PersistTest_Press(2);
+    PersistTest_Run(PERSISTTEST_RECORD_MS);
+    CHECK(1 == PersistTest_Stats().records && 0 == PersistTest_Stats().errors);
+    PersistTest_Start();
+    CHECK(22 == PersistTest_Slot(PERSISTTEST_NODE));
+}
+/**
+ * @brief A page cut before its magic is not taken as the newest one, and a page with
+ * only a cut record sends the restore back to the page before it
+ *
+ */
+static void PersistTest_CutPage(void)
+{
+    uint32_t saved;
+    PersistTest_Erase();
+    PersistTest_Start();
+    PersistTest_Press(1);
+    PersistTest_Run(PERSISTTEST_RECORD_MS);
+    /* The header of the second page is cut before its magic */
+    CHECK(PersistTest_FillPage());
+    saved = PersistTest_Slot(PERSISTTEST_NODE);
+    FlashSim_CutAfter(1);
+    PersistTest_Run(PERSIST_TASK_PERIOD_MS);
+    CHECK(FlashSim_IsCut());
+    PersistTest_Start();
+    CHECK(PERSISTTEST_MAGIC != PERSISTTEST_PAGE(1)[2] && 2 == PERSISTTEST_PAGE(1)[0]);
+    CHECK(1 == PersistTest_Stats().restored && 1 == PersistTest_Stats().sequence);
+    /* The record that started the page was never written */
+    CHECK(saved - 1 == PersistTest_Slot(PERSISTTEST_NODE));
+
+    /* This time the header is whole and the first record of the page is cut */
+    CHECK(PersistTest_FillPage());
+    saved = PersistTest_Slot(PERSISTTEST_NODE);
+    PersistTest_Run(PERSIST_TASK_PERIOD_MS / 2);
+    CHECK(PERSISTTEST_MAGIC == PERSISTTEST_PAGE(1)[2]);
+    CHECK(PersistTest_RunUntilBusy(PERSIST_TASK_PERIOD_MS * 2));
+    FlashSim_CutAfter(1);
+    PersistTest_Run(PERSIST_TASK_PERIOD_MS);
+    CHECK(FlashSim_IsCut());
+    PersistTest_Start();
+    CHECK(1 == PersistTest_Stats().restored && 2 == PersistTest_Stats().sequence);
+    CHECK(saved - 1 == PersistTest_Slot(PERSISTTEST_NODE));
+
+    /* The log goes on in the newest page after the cut record */
+    PersistTest_Press(1);
+    PersistTest_Run(PERSISTTEST_RECORD_MS);
+    CHECK(0 == PersistTest_Stats().erases && 1 == PersistTest_Stats().records);
+    PersistTest_Start();
+    CHECK(saved == PersistTest_Slot(PERSISTTEST_NODE));
+}
+
+int main(void)
+{
+    if(E_OK != Sim_Init())
+    {
+        printf("PersistTest: the simulated memory could not be mapped\n");
+        return 1;
+    }
+    FlashSim_Init();
+    PersistTest_Restore();
+    PersistTest_Rotation();
+    PersistTest_CutRecord();
+    PersistTest_CutPage();
+    return CHECK_RESULT("PersistTest");
+}
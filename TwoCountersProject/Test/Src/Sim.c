@@ -0,0 +1,252 @@
+/**
+ * @file Sim.c
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief This is the implementation for the host simulation of the micro controller,
+ * it also stands in for the NVIC and the SysTick drivers that need the core
+ * @version 0.1
+ * @date 2020-04-24
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#define _GNU_SOURCE
+#include <string.h>
+#include <sys/mman.h>
+#include "Std_Types.h"
+#include "NVIC.h"
+#include "SYSTICK.h"
+#include "Gpio.h"
+#include "Sim.h"
+
+#define SIM_IRQ_NUMBER              68
+
+#define SIM_GPIO_ODR                0x0C
+#define SIM_GPIO_BSRR               0x10
+#define SIM_GPIO_BRR                0x14
+#define SIM_GPIO_PORTS              7
+#define SIM_GPIO_PORT_STRIDE        0x400
+
+#define SIM_FLASH_ERASED            0xFF
+
+typedef struct
+{
+    uint32_t base;
+    uint32_t size;
+}simRegion_t;
+
+static const simRegion_t Sim_regions[] = {
+    {SIM_FLASH_BASE, SIM_FLASH_SIZE},
+    {SIM_PERIPHERAL_BASE, SIM_PERIPHERAL_SIZE},
+    {SIM_CORE_BASE, SIM_CORE_SIZE}
+};
+
+#define SIM_REGIONS                 (sizeof(Sim_regions) / sizeof(Sim_regions[0]))
+
+static uint8_t Sim_mapped;
+static uint64_t Sim_nanos;
+static uint8_t Sim_irqEnabled[SIM_IRQ_NUMBER];
+static uint8_t Sim_masked;
+static uint32_t Sim_resets;
+
+/**
+ * @brief Maps the flash and the registers the first time it is called and clears the
+ * registers, the virtual clock and the interrupt state every time
+ *
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the memory is mapped
+ *                  E_NOT_OK: If an address range is not free on this host
+ */
+Std_ReturnType Sim_Init(void)
+{
+    uint8_t i;
+    void* block;
+    if(!Sim_mapped)
+    {
+        for(i=0; i<SIM_REGIONS; i++)
+        {
+            block = mmap((void*)(uintptr_t)Sim_regions[i].base, Sim_regions[i].size, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+            if(MAP_FAILED == block || (uintptr_t)block != Sim_regions[i].base)
+            {
+                return E_NOT_OK;
+            }
+        }
+        /* A new part comes with its flash erased */
+        memset((void*)(uintptr_t)SIM_FLASH_BASE, SIM_FLASH_ERASED, SIM_FLASH_SIZE);
+        Sim_mapped = 1;
+    }
+    memset((void*)(uintptr_t)SIM_PERIPHERAL_BASE, 0, SIM_PERIPHERAL_SIZE);
+    memset((void*)(uintptr_t)SIM_CORE_BASE, 0, SIM_CORE_SIZE);
+    memset(Sim_irqEnabled, 0, sizeof(Sim_irqEnabled));
+    Sim_nanos = 0;
+    Sim_masked = 0;
+    Sim_resets = 0;
+    return E_OK;
+}
+/**
+ * @brief Gets the virtual time
+ *
+ * @return uint64_t the time since Sim_Init in nano seconds
+ */
+uint64_t Sim_GetNanos(void)
+{
+    return Sim_nanos;
+}
+/**
+ * @brief Moves the virtual time forward, it never goes back
+ *
+ * @param nanos the new time in nano seconds
+ */
+void Sim_SetNanos(uint64_t nanos)
+{
+    if(nanos > Sim_nanos)
+    {
+        Sim_nanos = nanos;
+    }
+}
+/**
+ * @brief Checks if an interrupt is enabled in the NVIC and not masked by the CPU
+ *
+ * @param interruptNum the number of the interrupt
+ * @return uint8_t 1 if the interrupt can be taken and 0 if not
+ */
+uint8_t Sim_IsIrqEnabled(uint8_t interruptNum)
+{
+    return (interruptNum < SIM_IRQ_NUMBER) && Sim_irqEnabled[interruptNum] && !Sim_masked;
+}
+/**
+ * @brief Applies the writes to the set and reset registers of the GPIO ports
+ * to their output registers like the hardware does
+ *
+ */
+void Sim_SyncGpio(void)
+{
+    uint8_t i;
+    volatile uint32_t* odr;
+    volatile uint32_t* bsrr;
+    volatile uint32_t* brr;
+    for(i=0; i<SIM_GPIO_PORTS; i++)
+    {
+        odr = (volatile uint32_t*)(uintptr_t)(GPIO_PORTA + i * SIM_GPIO_PORT_STRIDE + SIM_GPIO_ODR);
+        bsrr = (volatile uint32_t*)(uintptr_t)(GPIO_PORTA + i * SIM_GPIO_PORT_STRIDE + SIM_GPIO_BSRR);
+        brr = (volatile uint32_t*)(uintptr_t)(GPIO_PORTA + i * SIM_GPIO_PORT_STRIDE + SIM_GPIO_BRR);
+        /* The upper half of BSRR resets pins, the lower half sets them and wins */
+        *odr &= ~(*brr | (*bsrr >> 16));
+        *odr |= *bsrr & 0xFFFF;
+        *bsrr = 0;
+        *brr = 0;
+    }
+}
+/**
+ * @brief Reads an output pin after Sim_SyncGpio
+ *
+ * @param port the port address
+ * @param pin the pin mask
+ * @return uint8_t 1 if the pin is high and 0 if it is low
+ */
+uint8_t Sim_ReadOutputPin(uint32_t port, uint32_t pin)
+{
+    return 0 != (*(volatile uint32_t*)(uintptr_t)(port + SIM_GPIO_ODR) & pin);
+}
+/**
+ * @brief Gets the number of system resets asked for since Sim_Init
+ *
+ * @return uint32_t the number of resets
+ */
+uint32_t Sim_GetResets(void)
+{
+    return Sim_resets;
+}
+
+/**
+ * @brief Gets the virtual time, it stands in for the SysTick driver
+ *
+ * @return u32 the time in micro seconds, it wraps like the real one
+ */
+u32 SYSTICK_getMicros(void)
+{
+    return (u32)(Sim_nanos / SIM_NS_PER_US);
+}
+
+/**
+ * @brief Enables or disables an interrupt
+ *
+ * @param interruptNum the number of the interrupt
+ * @param status NVIC_ENABLE or NVIC_DISABLE
+ */
+void NVIC_controlInterrupt(u8 interruptNum, u8 status)
+{
+    if(interruptNum < SIM_IRQ_NUMBER)
+    {
+        Sim_irqEnabled[interruptNum] = (NVIC_ENABLE == status);
+    }
+}
+/**
+ * @brief The pending flags are not simulated
+ *
+ */
+void NVIC_controlPendingFlag(u8 interruptNum, u8 val)
+{
+    (void)interruptNum;
+    (void)val;
+}
+/**
+ * @brief No interrupt is active outside of the handler calls of the simulation
+ *
+ */
+u8 NVIC_getActiveFlagStatus(u8 interruptNum)
+{
+    (void)interruptNum;
+    return 0;
+}
+/**
+ * @brief The priorities are not simulated, the simulation calls one handler at a time
+ *
+ */
+void NVIC_configurePriority(u8 interruptNum, u8 priority)
+{
+    (void)interruptNum;
+    (void)priority;
+}
+/**
+ * @brief The priorities are not simulated
+ *
+ */
+u8 NVIC_getPriority(u8 interruptNum)
+{
+    (void)interruptNum;
+    return 0;
+}
+/**
+ * @brief Masks or unmasks all the interrupts like CPSID I and CPSIE I
+ *
+ * @param status NVIC_ENABLE or NVIC_DISABLE
+ */
+void NVIC_controlAllPeripheral(u8 status)
+{
+    Sim_masked = (NVIC_DISABLE == status);
+}
+/**
+ * @brief The faults are not simulated
+ *
+ */
+void NVIC_controlFault(u8 status)
+{
+    (void)status;
+}
+/**
+ * @brief The priorities are not simulated
+ *
+ */
+void NVIC_filterInterrupts(u8 priority)
+{
+    (void)priority;
+}
+/**
+ * @brief Counts the reset, on the host it returns so the test can restart the modules
+ *
+ */
+void NVIC_systemReset(void)
+{
+    Sim_resets++;
+}
@@ -0,0 +1,405 @@
+/**
+ * @file UartBench.c
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief This is the host benchmark of the UART handler, UART1 sends packets through
+ * HUart to UART2 over the simulated wire and the results of every scenario are written
+ * as CSV or JSON
+ * *The throughput is what the receiving application read per second of virtual time,
+ * the latency is from HUart_SendOn to the end of the transmission as HUart measures it,
+ * the CPU cost is host time in the driver per byte read so it only compares builds,
+ * the loss is what left UART1 and never reached the application of UART2
+ * @version 0.1
+ * @date 2020-04-24
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "Std_Types.h"
+#include "Uart.h"
+#include "HUart_Cfg.h"
+#include "HUart.h"
+#include "Gpio.h"
+#include "Sim.h"
+#include "UartSim.h"
+
+#define BENCH_SENDER                HUART_MODULE_1
+#define BENCH_RECEIVER              HUART_MODULE_2
+
+#define BENCH_DEFAULT_DURATION_MS   2000
+/* Time without new packets at the end so the queued ones can arrive */
+#define BENCH_DRAIN_MS              500
+
+/* The queue holds 5 packets and one is in flight so 8 buffers are never reused early */
+#define BENCH_TX_BUFFERS            8
+#define BENCH_MAX_PACKET            256
+#define BENCH_MAX_READ              256
+
+#define BENCH_FORMAT_CSV            0
+#define BENCH_FORMAT_JSON           1
+
+typedef struct
+{
+    const char* name;
+    uint32_t baudRate;
+    uint16_t packetLength;
+    /* A packet is queued every sendPeriodMs */
+    uint16_t sendPeriodMs;
+    /* The receiver reads up to readChunk bytes every readPeriodMs */
+    uint16_t readPeriodMs;
+    uint16_t readChunk;
+    /* The interrupts are held back this long after every task run */
+    uint32_t irqBlockUs;
+    uint32_t flowControl;
+}benchScenario_t;
+
+typedef struct
+{
+    uint8_t ok;
+    uint32_t offeredBps;
+    uint32_t throughputBps;
+    uint32_t latencyAvgUs;
+    uint32_t latencyMinUs;
+    uint32_t latencyMaxUs;
+    uint32_t hostNsPerByte;
+    uint32_t isrNsPerByte;
+    uint32_t packetsSent;
+    uint32_t queueFull;
+    uint32_t wireBytes;
+    uint32_t readBytes;
+    uint32_t lostBytes;
+    uint32_t rxDropped;
+    uint32_t overruns;
+}benchResult_t;
+
+static const benchScenario_t Bench_scenarios[] = {
+    {"9600_16B",              9600,   16, 20,  1, 64,   0, HUART_FLOW_CONTROL_DIS},
+    {"115200_16B",            115200, 16,  2,  1, 64,   0, HUART_FLOW_CONTROL_DIS},
+    {"115200_64B_saturated",  115200, 64,  1,  1, 64,   0, HUART_FLOW_CONTROL_DIS},
+    {"230400_64B",            230400, 64,  4,  1, 64,   0, HUART_FLOW_CONTROL_DIS},
+    {"115200_slow_reader",    115200, 32,  3, 10, 32,   0, HUART_FLOW_CONTROL_DIS},
+    {"115200_slow_reader_rts",115200, 32,  3, 10, 32,   0, HUART_FLOW_CONTROL_EN},
+    {"230400_irq_blocked",    230400, 32,  2,  1, 64, 100, HUART_FLOW_CONTROL_DIS}
+};
+
+#define BENCH_SCENARIOS             (sizeof(Bench_scenarios) / sizeof(Bench_scenarios[0]))
+
+static uint64_t Bench_hostNanos;
+
+/**
+ * @brief Gets the host clock
+ *
+ * @return uint64_t the time in nano seconds
+ */
+static uint64_t Bench_HostNow(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
+/**
+ * @brief Runs the simulated hardware up to a virtual time
+ *
+ * @param nanos the virtual time
+ */
+static void Bench_RunUntil(uint64_t nanos)
+{
+    uint64_t next = UartSim_NextEvent();
+    while(next <= nanos)
+    {
+        Sim_SetNanos(next);
+        UartSim_Step();
+        next = UartSim_NextEvent();
+    }
+    Sim_SetNanos(nanos);
+    UartSim_Step();
+}
+/**
+ * @brief Initializes one end of the wire
+ *
+ * @param uartModule the module
+ * @param scenario the scenario
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the module is initialized
+ *                  E_NOT_OK: If the baud rate can't be reached
+ */
+static Std_ReturnType Bench_InitModule(uint8_t uartModule, const benchScenario_t* scenario)
+{
+    Std_ReturnType error = HUart_ConfigOn(uartModule, scenario->baudRate, HUART_STOP_ONE_BIT, HUART_NO_PARITY, scenario->flowControl);
+    if(E_OK == error)
+    {
+        error = HUart_InitOn(uartModule);
+    }
+    if(E_OK == error)
+    {
+        error = HUart_ResetStatsOn(uartModule);
+    }
+    return error;
+}
+/**
+ * @brief Runs one scenario in the process it is called in
+ *
+ * @param scenario the scenario
+ * @param durationMs the time packets are queued for
+ * @param result where to store the result
+ */
+static void Bench_Run(const benchScenario_t* scenario, uint32_t durationMs, benchResult_t* result)
+{
+    static uint8_t txBuffer[BENCH_TX_BUFFERS][BENCH_MAX_PACKET];
+    uint8_t rxBuffer[BENCH_MAX_READ];
+    hUartStats_t sender;
+    hUartStats_t receiver;
+    uartSimStats_t wireA;
+    uartSimStats_t wireB;
+    uint32_t ms;
+    uint16_t i;
+    uint16_t count;
+    uint8_t pattern = 0;
+    uint32_t next = 0;
+    uint64_t lastRead = 0;
+    uint64_t start;
+    memset(result, 0, sizeof(*result));
+    if(E_OK != Sim_Init())
+    {
+        return;
+    }
+    UartSim_Init(HUART_SYSTEM_CLK);
+    UartSim_Connect(BENCH_SENDER, BENCH_RECEIVER);
+    UartSim_SetRtsPin(BENCH_SENDER, GPIO_PORTA, GPIO_PIN_12);
+    UartSim_SetRtsPin(BENCH_RECEIVER, GPIO_PORTA, GPIO_PIN_1);
+    if(E_OK != Bench_InitModule(BENCH_SENDER, scenario) || E_OK != Bench_InitModule(BENCH_RECEIVER, scenario))
+    {
+        return;
+    }
+    UartSim_Step();
+    Bench_hostNanos = 0;
+    for(ms=0; ms<durationMs + BENCH_DRAIN_MS; ms++)
+    {
+        Bench_RunUntil((uint64_t)ms * SIM_NS_PER_MS);
+        if(ms < durationMs && 0 == ms % scenario->sendPeriodMs)
+        {
+            for(i=0; i<scenario->packetLength; i++)
+            {
+                txBuffer[next][i] = (uint8_t)(pattern + i);
+            }
+            start = Bench_HostNow();
+            if(E_OK == HUart_SendOn(BENCH_SENDER, txBuffer[next], scenario->packetLength))
+            {
+                pattern += (uint8_t)scenario->packetLength;
+                next = (next + 1) % BENCH_TX_BUFFERS;
+                result->packetsSent++;
+            }
+            Bench_hostNanos += Bench_HostNow() - start;
+            UartSim_Step();
+        }
+        start = Bench_HostNow();
+        HUart_Task();
+        Bench_hostNanos += Bench_HostNow() - start;
+        UartSim_Step();
+        if(0 == ms % scenario->readPeriodMs)
+        {
+            count = 0;
+            start = Bench_HostNow();
+            HUart_ReadOn(BENCH_RECEIVER, rxBuffer, scenario->readChunk, &count);
+            Bench_hostNanos += Bench_HostNow() - start;
+            if(count > 0)
+            {
+                result->readBytes += count;
+                lastRead = Sim_GetNanos();
+            }
+            UartSim_Step();
+        }
+        if(scenario->irqBlockUs)
+        {
+            UartSim_BlockIrq(Sim_GetNanos() + scenario->irqBlockUs * SIM_NS_PER_US);
+        }
+    }
+    HUart_GetStatsOn(BENCH_SENDER, &sender);
+    HUart_GetStatsOn(BENCH_RECEIVER, &receiver);
+    UartSim_GetStats(BENCH_SENDER, &wireA);
+    UartSim_GetStats(BENCH_RECEIVER, &wireB);
+    result->ok = 1;
+    result->offeredBps = (uint32_t)((uint64_t)scenario->packetLength * 1000 / scenario->sendPeriodMs);
+    if(lastRead > 0)
+    {
+        result->throughputBps = (uint32_t)((uint64_t)result->readBytes * 1000000000ULL / lastRead);
+    }
+    if(sender.latencySamples > 0)
+    {
+        result->latencyAvgUs = sender.latencyTotalUs / sender.latencySamples;
+    }
+    result->latencyMinUs = sender.latencyMinUs;
+    result->latencyMaxUs = sender.latencyMaxUs;
+    if(result->readBytes > 0)
+    {
+        result->hostNsPerByte = (uint32_t)((Bench_hostNanos + wireA.irqHostNanos + wireB.irqHostNanos) / result->readBytes);
+        result->isrNsPerByte = (uint32_t)((wireA.irqHostNanos + wireB.irqHostNanos) / result->readBytes);
+    }
+    result->queueFull = sender.queueFull;
+    result->wireBytes = wireA.wireBytes;
+    result->lostBytes = wireA.wireBytes - result->readBytes;
+    result->rxDropped = receiver.rxDropped;
+    result->overruns = wireB.overrunBytes;
+}
+/**
+ * @brief Runs one scenario in a child process so every scenario starts with
+ * the drivers in their reset state
+ *
+ * @param scenario the scenario
+ * @param durationMs the time packets are queued for
+ * @param result where to store the result
+ */
+static void Bench_RunIsolated(const benchScenario_t* scenario, uint32_t durationMs, benchResult_t* result)
+{
+    int fds[2];
+    pid_t child;
+    memset(result, 0, sizeof(*result));
+    if(0 != pipe(fds))
+    {
+        return;
+    }
+    child = fork();
+    if(0 == child)
+    {
+        close(fds[0]);
+        Bench_Run(scenario, durationMs, result);
+        if(sizeof(*result) != write(fds[1], result, sizeof(*result)))
+        {
+            _exit(1);
+        }
+        _exit(0);
+    }
+    close(fds[1]);
+    if(child > 0)
+    {
+        if(sizeof(*result) != read(fds[0], result, sizeof(*result)))
+        {
+            memset(result, 0, sizeof(*result));
+        }
+        waitpid(child, NULL, 0);
+    }
+    close(fds[0]);
+}
+/**
+ * @brief Writes the results as CSV
+ *
+ * @param out the output file
+ * @param results the results of all the scenarios
+ */
+static void Bench_WriteCsv(FILE* out, const benchResult_t* results)
+{
+    uint8_t i;
+    fprintf(out, "scenario,baud,packet_bytes,offered_bps,throughput_bps,latency_avg_us,latency_min_us,latency_max_us,"
+                 "host_ns_per_byte,isr_ns_per_byte,packets_sent,queue_full,wire_bytes,read_bytes,lost_bytes,rx_dropped,overruns\n");
+    for(i=0; i<BENCH_SCENARIOS; i++)
+    {
+        if(results[i].ok)
+        {
+            fprintf(out, "%s,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u\n", Bench_scenarios[i].name,
+                    Bench_scenarios[i].baudRate, Bench_scenarios[i].packetLength, results[i].offeredBps,
+                    results[i].throughputBps, results[i].latencyAvgUs, results[i].latencyMinUs, results[i].latencyMaxUs,
+                    results[i].hostNsPerByte, results[i].isrNsPerByte, results[i].packetsSent, results[i].queueFull,
+                    results[i].wireBytes, results[i].readBytes, results[i].lostBytes, results[i].rxDropped, results[i].overruns);
+        }
+    }
+}
+/**
+ * @brief Writes the results as JSON
+ *
+ * @param out the output file
+ * @param results the results of all the scenarios
+ */
+static void Bench_WriteJson(FILE* out, const benchResult_t* results)
+{
+    uint8_t i;
+    uint8_t first = 1;
+    fprintf(out, "[\n");
+    for(i=0; i<BENCH_SCENARIOS; i++)
+    {
+        if(results[i].ok)
+        {
+            fprintf(out, "%s  {\"scenario\": \"%s\", \"baud\": %u, \"packet_bytes\": %u, \"offered_bps\": %u, "
+                         "\"throughput_bps\": %u, \"latency_avg_us\": %u, \"latency_min_us\": %u, \"latency_max_us\": %u, "
+                         "\"host_ns_per_byte\": %u, \"isr_ns_per_byte\": %u, \"packets_sent\": %u, \"queue_full\": %u, "
+                         "\"wire_bytes\": %u, \"read_bytes\": %u, \"lost_bytes\": %u, \"rx_dropped\": %u, \"overruns\": %u}",
+                    first ? "" : ",\n", Bench_scenarios[i].name, Bench_scenarios[i].baudRate, Bench_scenarios[i].packetLength,
+                    results[i].offeredBps, results[i].throughputBps, results[i].latencyAvgUs, results[i].latencyMinUs,
+                    results[i].latencyMaxUs, results[i].hostNsPerByte, results[i].isrNsPerByte, results[i].packetsSent,
+                    results[i].queueFull, results[i].wireBytes, results[i].readBytes, results[i].lostBytes,
+                    results[i].rxDropped, results[i].overruns);
+            first = 0;
+        }
+    }
+    fprintf(out, "\n]\n");
+}
+
+/**
+ * @brief Runs all the scenarios
+ * *Usage: UartBench [-f csv|json] [-o file] [-d duration_ms]
+ *
+ */
+int main(int argc, char** argv)
+{
+    benchResult_t results[BENCH_SCENARIOS];
+    uint8_t format = BENCH_FORMAT_CSV;
+    uint32_t durationMs = BENCH_DEFAULT_DURATION_MS;
+    const char* path = NULL;
+    FILE* out = stdout;
+    uint8_t failed = 0;
+    uint8_t i;
+    int option;
+    while(-1 != (option = getopt(argc, argv, "f:o:d:")))
+    {
+        switch(option)
+        {
+            case 'f':
+                format = (0 == strcmp(optarg, "json")) ? BENCH_FORMAT_JSON : BENCH_FORMAT_CSV;
+                break;
+            case 'o':
+                path = optarg;
+                break;
+            case 'd':
+                durationMs = (uint32_t)strtoul(optarg, NULL, 10);
+                break;
+            default:
+                fprintf(stderr, "usage: %s [-f csv|json] [-o file] [-d duration_ms]\n", argv[0]);
+                return 2;
+        }
+    }
+    for(i=0; i<BENCH_SCENARIOS; i++)
+    {
+        Bench_RunIsolated(&Bench_scenarios[i], durationMs, &results[i]);
+        if(!results[i].ok)
+        {
+            fprintf(stderr, "%s: the scenario could not run\n", Bench_scenarios[i].name);
+            failed = 1;
+        }
+    }
+    if(path)
+    {
+        out = fopen(path, "w");
+        if(!out)
+        {
+            perror(path);
+            return 1;
+        }
+    }
+    if(BENCH_FORMAT_JSON == format)
+    {
+        Bench_WriteJson(out, results);
+    }
+    else
+    {
+        Bench_WriteCsv(out, results);
+    }
+    if(path)
+    {
+        fclose(out);
+    }
+    return failed;
+}
@@ -0,0 +1,461 @@
+/**
+ * @file UartSim.c
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief This is the implementation for the simulated USART
+ * *The status and data registers are owned by the simulation, the data register
+ * holds a marker that a byte from the driver can never have so a write is seen
+ * on the next step, received bytes are shown with RXNE only for the handler call
+ * @version 0.1
+ * @date 2020-04-24
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include <time.h>
+#include "Std_Types.h"
+#include "Uart.h"
+#include "NVIC.h"
+#include "Sim.h"
+#include "UartSim.h"
+
+#define UARTSIM_MODULES             5
+#define UARTSIM_NO_PEER             0xFF
+
+/* The data register can only take 9 bits from the driver */
+#define UARTSIM_DR_IDLE             0xFFFF0000
+#define UARTSIM_DR_RX               0xFFFE0000
+#define UARTSIM_DR_WRITTEN(dr)      ((dr) < 0x10000)
+#define UARTSIM_DR_DATA             0x1FF
+
+#define UARTSIM_SR_TXE              0x80
+#define UARTSIM_SR_TC               0x40
+#define UARTSIM_SR_RXNE             0x20
+#define UARTSIM_SR_ORE              0x08
+
+#define UARTSIM_CR1_UE              0x2000
+#define UARTSIM_CR1_M               0x1000
+#define UARTSIM_CR1_TXEIE           0x80
+#define UARTSIM_CR1_TCIE            0x40
+#define UARTSIM_CR1_RXNEIE          0x20
+#define UARTSIM_CR1_TE              0x08
+#define UARTSIM_CR1_RE              0x04
+#define UARTSIM_CR2_STOP_SHIFT      12
+#define UARTSIM_CR2_STOP_MASK       0x3
+#define UARTSIM_CR3_CTSE            0x200
+
+/* A handler that leaves its flags set would be called forever, real code
+   clears them within a few calls */
+#define UARTSIM_MAX_IRQ_CALLS       8
+
+typedef struct
+{
+    uint32_t SR;
+    uint32_t DR;
+    uint32_t BRR;
+    uint32_t CR1;
+    uint32_t CR2;
+    uint32_t CR3;
+    uint32_t GTPR;
+}uartSimRegs_t;
+
+typedef struct
+{
+    uint8_t peer;
+    uint8_t holdingFull;
+    uint16_t holding;
+    uint8_t shiftFull;
+    uint16_t shift;
+    uint64_t shiftEnd;
+    uint8_t tc;
+    uint8_t rxFull;
+    uint16_t rx;
+    uint8_t ore;
+    uint32_t rtsPort;
+    uint32_t rtsPin;
+    uartSimStats_t stats;
+}uartSim_t;
+
+extern void USART1_IRQHandler(void);
+extern void USART2_IRQHandler(void);
+extern void USART3_IRQHandler(void);
+extern void UART4_IRQHandler(void);
+extern void UART5_IRQHandler(void);
+
+static const uint32_t UartSim_address[UARTSIM_MODULES] = {
+    0x40013800,
+    0x40004400,
+    0x40004800,
+    0x40004C00,
+    0x40005000
+};
+
+static const uint8_t UartSim_irq[UARTSIM_MODULES] = {
+    NVIC_IRQNUM_USART1,
+    NVIC_IRQNUM_USART2,
+    NVIC_IRQNUM_USART3,
+    NVIC_IRQNUM_UART4,
+    NVIC_IRQNUM_UART5
+};
+
+static void (* const UartSim_handler[UARTSIM_MODULES])(void) = {
+    USART1_IRQHandler,
+    USART2_IRQHandler,
+    USART3_IRQHandler,
+    UART4_IRQHandler,
+    UART5_IRQHandler
+};
+
+/* The length of the stop bits in half bits for each value of CR2.STOP */
+static const uint8_t UartSim_stopHalfBits[4] = {2, 1, 4, 3};
+
+static uartSim_t UartSim_module[UARTSIM_MODULES];
+static uint32_t UartSim_busClk;
+static uint64_t UartSim_blockedUntil;
+
+/**
+ * @brief Gets the registers of a module
+ *
+ * @param uartModule the module
+ * @return volatile uartSimRegs_t* the registers
+ */
+static volatile uartSimRegs_t* UartSim_Regs(uint8_t uartModule)
+{
+    return (volatile uartSimRegs_t*)(uintptr_t)UartSim_address[uartModule];
+}
+/**
+ * @brief Gets the time one character takes on the wire with the current settings
+ *
+ * @param uartModule the module
+ * @return uint64_t the character time in nano seconds
+ */
+static uint64_t UartSim_CharNanos(uint8_t uartModule)
+{
+    volatile uartSimRegs_t* regs = UartSim_Regs(uartModule);
+    uint64_t halfBits = 2 + ((regs->CR1 & UARTSIM_CR1_M) ? 18 : 16)
+                      + UartSim_stopHalfBits[(regs->CR2 >> UARTSIM_CR2_STOP_SHIFT) & UARTSIM_CR2_STOP_MASK];
+    return (halfBits * regs->BRR * 1000000000ULL) / (2ULL * UartSim_busClk);
+}
+/**
+ * @brief Checks if the transmitter of a module may start a character
+ *
+ * @param uartModule the module
+ * @return uint8_t 1 if it may and 0 if the CTS line is high
+ */
+static uint8_t UartSim_ClearToSend(uint8_t uartModule)
+{
+    uartSim_t* sim = &UartSim_module[uartModule];
+    uartSim_t* peer = &UartSim_module[sim->peer];
+    uint8_t clear = 1;
+    if((UartSim_Regs(uartModule)->CR3 & UARTSIM_CR3_CTSE) && peer->rtsPin)
+    {
+        Sim_SyncGpio();
+        clear = !Sim_ReadOutputPin(peer->rtsPort, peer->rtsPin);
+    }
+    return clear;
+}
+/**
+ * @brief Takes a byte written to the data register into the holding register
+ * and starts the shift register if it is free
+ *
+ * @param uartModule the module
+ */
+static void UartSim_TakeData(uint8_t uartModule)
+{
+    volatile uartSimRegs_t* regs = UartSim_Regs(uartModule);
+    uartSim_t* sim = &UartSim_module[uartModule];
+    uint32_t dr = regs->DR;
+    if(UARTSIM_DR_WRITTEN(dr))
+    {
+        regs->DR = UARTSIM_DR_IDLE;
+        if((regs->CR1 & UARTSIM_CR1_UE) && (regs->CR1 & UARTSIM_CR1_TE))
+        {
+            if(sim->holdingFull)
+            {
+                sim->stats.overwrites++;
+            }
+            sim->holding = (uint16_t)(dr & UARTSIM_DR_DATA);
+            sim->holdingFull = 1;
+            sim->tc = 0;
+        }
+    }
+    if(!sim->shiftFull && sim->holdingFull && UartSim_ClearToSend(uartModule))
+    {
+        sim->shift = sim->holding;
+        sim->shiftFull = 1;
+        sim->holdingFull = 0;
+        sim->shiftEnd = Sim_GetNanos() + UartSim_CharNanos(uartModule);
+    }
+}
+/**
+ * @brief Hands a character that left a transmitter to the receiver of the peer
+ *
+ * @param uartModule the receiving module
+ * @param data the character
+ */
+static void UartSim_Deliver(uint8_t uartModule, uint16_t data)
+{
+    volatile uartSimRegs_t* regs = UartSim_Regs(uartModule);
+    uartSim_t* sim = &UartSim_module[uartModule];
+    if((regs->CR1 & UARTSIM_CR1_UE) && (regs->CR1 & UARTSIM_CR1_RE))
+    {
+        if(sim->rxFull)
+        {
+            /* The data register keeps the old byte, the new one is lost */
+            sim->ore = 1;
+            sim->stats.overrunBytes++;
+        }
+        else
+        {
+            sim->rx = data;
+            sim->rxFull = 1;
+        }
+    }
+}
+/**
+ * @brief Finishes the characters whose time on the wire is over, the next one
+ * starts right after the stop bit if the holding register is full
+ *
+ * @param uartModule the module
+ */
+static void UartSim_Shift(uint8_t uartModule)
+{
+    uartSim_t* sim = &UartSim_module[uartModule];
+    uint64_t now = Sim_GetNanos();
+    uint64_t end;
+    while(sim->shiftFull && sim->shiftEnd <= now)
+    {
+        end = sim->shiftEnd;
+        sim->shiftFull = 0;
+        sim->stats.wireBytes++;
+        UartSim_Deliver(sim->peer, sim->shift);
+        if(sim->holdingFull && UartSim_ClearToSend(uartModule))
+        {
+            sim->shift = sim->holding;
+            sim->shiftFull = 1;
+            sim->holdingFull = 0;
+            sim->shiftEnd = end + UartSim_CharNanos(uartModule);
+        }
+        else if(!sim->holdingFull)
+        {
+            sim->tc = 1;
+        }
+    }
+}
+/**
+ * @brief Shows the transmitter flags in the status register
+ *
+ * @param uartModule the module
+ */
+static void UartSim_ShowTx(uint8_t uartModule)
+{
+    uartSim_t* sim = &UartSim_module[uartModule];
+    UartSim_Regs(uartModule)->SR = (sim->holdingFull ? 0 : UARTSIM_SR_TXE) | (sim->tc ? UARTSIM_SR_TC : 0);
+}
+/**
+ * @brief Calls the interrupt handler of a module and measures it on the host clock
+ *
+ * @param uartModule the module
+ */
+static void UartSim_CallHandler(uint8_t uartModule)
+{
+    struct timespec start;
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    UartSim_handler[uartModule]();
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    UartSim_module[uartModule].stats.irqCalls++;
+    UartSim_module[uartModule].stats.irqHostNanos += (uint64_t)(end.tv_sec - start.tv_sec) * 1000000000ULL
+                                                   + (uint64_t)end.tv_nsec - (uint64_t)start.tv_nsec;
+}
+/**
+ * @brief Checks if a module has an interrupt waiting
+ *
+ * @param uartModule the module
+ * @return uint8_t 1 if it has and 0 if not
+ */
+static uint8_t UartSim_IrqPending(uint8_t uartModule)
+{
+    uartSim_t* sim = &UartSim_module[uartModule];
+    uint32_t cr1 = UartSim_Regs(uartModule)->CR1;
+    return (sim->rxFull && (cr1 & UARTSIM_CR1_RXNEIE))
+        || (!sim->holdingFull && (cr1 & UARTSIM_CR1_TXEIE))
+        || (sim->tc && (cr1 & UARTSIM_CR1_TCIE));
+}
+/**
+ * @brief Calls the interrupt handler of a module while it has an interrupt waiting
+ * *A received byte is shown alone so the handler does not write the data register
+ * while it holds the byte, the transmitter flags are shown on the next call
+ *
+ * @param uartModule the module
+ */
+static void UartSim_Service(uint8_t uartModule)
+{
+    volatile uartSimRegs_t* regs = UartSim_Regs(uartModule);
+    uartSim_t* sim = &UartSim_module[uartModule];
+    uint8_t calls = 0;
+    while(calls < UARTSIM_MAX_IRQ_CALLS && Sim_GetNanos() >= UartSim_blockedUntil
+          && Sim_IsIrqEnabled(UartSim_irq[uartModule]) && UartSim_IrqPending(uartModule))
+    {
+        if(sim->rxFull && (regs->CR1 & UARTSIM_CR1_RXNEIE))
+        {
+            regs->DR = UARTSIM_DR_RX | sim->rx;
+            regs->SR = UARTSIM_SR_RXNE | (sim->ore ? UARTSIM_SR_ORE : 0);
+            sim->rxFull = 0;
+            sim->ore = 0;
+            UartSim_CallHandler(uartModule);
+            if(!UARTSIM_DR_WRITTEN(regs->DR))
+            {
+                regs->DR = UARTSIM_DR_IDLE;
+            }
+        }
+        else
+        {
+            UartSim_ShowTx(uartModule);
+            UartSim_CallHandler(uartModule);
+            if(!(regs->SR & UARTSIM_SR_TC))
+            {
+                sim->tc = 0;
+            }
+        }
+        UartSim_TakeData(uartModule);
+        calls++;
+    }
+    UartSim_ShowTx(uartModule);
+}
+
+/**
+ * @brief Initializes the simulated modules, Sim_Init has to be called first
+ *
+ * @param busClk the clock of the buses in Hz, the baud rate is taken from BRR with it
+ */
+void UartSim_Init(uint32_t busClk)
+{
+    uint8_t i;
+    for(i=0; i<UARTSIM_MODULES; i++)
+    {
+        UartSim_module[i] = (uartSim_t){0};
+        UartSim_module[i].peer = UARTSIM_NO_PEER;
+        UartSim_Regs(i)->DR = UARTSIM_DR_IDLE;
+        UartSim_ShowTx(i);
+    }
+    UartSim_busClk = busClk;
+    UartSim_blockedUntil = 0;
+}
+/**
+ * @brief Joins the transmitter of each module to the receiver of the other
+ *
+ * @param moduleA the first module (UART1 to UART5)
+ * @param moduleB the second module (UART1 to UART5)
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the modules are joined
+ *                  E_NOT_OK: If a module number is wrong or both are the same
+ */
+Std_ReturnType UartSim_Connect(uint8_t moduleA, uint8_t moduleB)
+{
+    Std_ReturnType error = E_NOT_OK;
+    if(moduleA < UARTSIM_MODULES && moduleB < UARTSIM_MODULES && moduleA != moduleB)
+    {
+        UartSim_module[moduleA].peer = moduleB;
+        UartSim_module[moduleB].peer = moduleA;
+        error = E_OK;
+    }
+    return error;
+}
+/**
+ * @brief Tells the wire which output pin is the RTS of a module
+ *
+ * @param uartModule the module (UART1 to UART5)
+ * @param port the port of the RTS pin
+ * @param pin the RTS pin
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the pin is set
+ *                  E_NOT_OK: If the module number is wrong
+ */
+Std_ReturnType UartSim_SetRtsPin(uint8_t uartModule, uint32_t port, uint32_t pin)
+{
+    Std_ReturnType error = E_NOT_OK;
+    if(uartModule < UARTSIM_MODULES)
+    {
+        UartSim_module[uartModule].rtsPort = port;
+        UartSim_module[uartModule].rtsPin = pin;
+        error = E_OK;
+    }
+    return error;
+}
+/**
+ * @brief Holds all the UART interrupts back until a time
+ *
+ * @param untilNanos the virtual time the interrupts can be taken again
+ */
+void UartSim_BlockIrq(uint64_t untilNanos)
+{
+    UartSim_blockedUntil = untilNanos;
+}
+/**
+ * @brief Gets the time of the next thing the simulated hardware does by itself
+ *
+ * @return uint64_t the virtual time in nano seconds or UARTSIM_NO_EVENT
+ */
+uint64_t UartSim_NextEvent(void)
+{
+    uint64_t next = UARTSIM_NO_EVENT;
+    uint8_t i;
+    for(i=0; i<UARTSIM_MODULES; i++)
+    {
+        if(UARTSIM_NO_PEER == UartSim_module[i].peer)
+        {
+            continue;
+        }
+        if(UartSim_module[i].shiftFull && UartSim_module[i].shiftEnd < next)
+        {
+            next = UartSim_module[i].shiftEnd;
+        }
+        if(UartSim_IrqPending(i) && Sim_GetNanos() < UartSim_blockedUntil && UartSim_blockedUntil < next)
+        {
+            next = UartSim_blockedUntil;
+        }
+    }
+    return next;
+}
+/**
+ * @brief Brings the simulated hardware to the virtual time
+ *
+ */
+void UartSim_Step(void)
+{
+    uint8_t i;
+    for(i=0; i<UARTSIM_MODULES; i++)
+    {
+        if(UARTSIM_NO_PEER != UartSim_module[i].peer)
+        {
+            UartSim_TakeData(i);
+            UartSim_Shift(i);
+        }
+    }
+    for(i=0; i<UARTSIM_MODULES; i++)
+    {
+        if(UARTSIM_NO_PEER != UartSim_module[i].peer)
+        {
+            UartSim_Service(i);
+        }
+    }
+}
+/**
+ * @brief Gets the statistics of a simulated module
+ *
+ * @param uartModule the module (UART1 to UART5)
+ * @param stats where to copy the statistics
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the statistics are copied
+ *                  E_NOT_OK: If the module number is wrong
+ */
+Std_ReturnType UartSim_GetStats(uint8_t uartModule, uartSimStats_t* stats)
+{
+    Std_ReturnType error = E_NOT_OK;
+    if(uartModule < UARTSIM_MODULES && stats)
+    {
+        *stats = UartSim_module[uartModule].stats;
+        error = E_OK;
+    }
+    return error;
+}